@@ -38,6 +38,7 @@
 #include "Encoding/RpcDecoder.h"
 #include "Encoding/RpcEncoder.h"
 #include "Encoding/RpcMethod.h"
+#include "Encoding/RpcResponseCache.h"
 #include "Encoding/BinaryRpc.h"
 #include "Encoding/JsonDecoder.h"
 #include "Encoding/JsonEncoder.h"
@@ -71,6 +72,7 @@
 #include "Sockets/ServerInfo.h"
 #include "Sockets/RpcClientInfo.h"
 #include "Systems/DeviceFamily.h"
+#include "Systems/EventCoalescer.h"
 #include "Systems/GlobalServiceMessages.h"
 #include "Systems/Peer.h"
 #include "Systems/SystemFactory.h"
@@ -79,10 +81,13 @@
 #include "Sockets/Ssdp.h"
 #include "IQueue.h"
 #include "ITimedQueue.h"
+#include "ImmutableVariable.h"
 #include "Sockets/HttpClient.h"
+#include "Sockets/HttpClientPool.h"
 #include "Sockets/HttpServer.h"
 #include "Sockets/Modbus.h"
 #include "Sockets/TcpSocket.h"
+#include "Sockets/UdpServer.h"
 #include "Sockets/UdpSocket.h"
 
 namespace BaseLib
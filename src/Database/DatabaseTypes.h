@@ -82,7 +82,8 @@ class DataColumn
         std::string textValue;
 
         /**
-         * The binary value.
+         * The binary value. Only set for columns of type BLOB and default constructed columns. It is nullptr for columns created
+         * with one of the INTEGER, FLOAT or TEXT constructors, so these don't need an extra allocation.
          */
         std::shared_ptr<std::vector<char>> binaryValue;
 
@@ -96,73 +97,63 @@ class DataColumn
          *
          * @param value The column data.
          */
-        DataColumn(int64_t value) : DataColumn() { dataType = DataType::Enum::INTEGER; intValue = value; }
+        DataColumn(int64_t value) { dataType = DataType::Enum::INTEGER; intValue = value; }
 
         /**
          * Constructor to create a data column of type INTEGER.
          *
          * @param value The column data.
          */
-        DataColumn(uint64_t value) : DataColumn() { dataType = DataType::Enum::INTEGER; intValue = value; }
+        DataColumn(uint64_t value) { dataType = DataType::Enum::INTEGER; intValue = value; }
 
         /**
          * Constructor to create a data column of type INTEGER.
          *
          * @param value The column data.
          */
-        DataColumn(int32_t value) : DataColumn() { dataType = DataType::Enum::INTEGER; intValue = value; }
+        DataColumn(int32_t value) { dataType = DataType::Enum::INTEGER; intValue = value; }
 
         /**
          * Constructor to create a data column of type INTEGER.
          *
          * @param value The column data.
          */
-        DataColumn(uint32_t value) : DataColumn() { dataType = DataType::Enum::INTEGER; intValue = value; }
+        DataColumn(uint32_t value) { dataType = DataType::Enum::INTEGER; intValue = value; }
 
         /**
          * Constructor to create a data column of type TEXT.
          *
          * @param value The column data.
          */
-        DataColumn(std::string value) : DataColumn() { dataType = DataType::Enum::TEXT; textValue = value; }
+        DataColumn(std::string value) { dataType = DataType::Enum::TEXT; textValue = std::move(value); }
 
         /**
          * Constructor to create a data column of type FLOAT.
          *
          * @param value The column data.
          */
-        DataColumn(double value) : DataColumn() { dataType = DataType::Enum::FLOAT; floatValue = value; }
+        DataColumn(double value) { dataType = DataType::Enum::FLOAT; floatValue = value; }
 
         /**
          * Constructor to create a data column of type BLOB.
          *
          * @param value The column data. It is not copied! So make sure to not modify it as long as the DataColumn object exists.
          */
-        DataColumn(std::shared_ptr<std::vector<char>> value) : DataColumn() { dataType = DataType::Enum::BLOB; if(value) binaryValue = value; }
+        DataColumn(std::shared_ptr<std::vector<char>> value) : dataType(DataType::Enum::BLOB), binaryValue(value ? value : std::make_shared<std::vector<char>>()) {}
 
         /**
          * Constructor to create a data column of type BLOB.
          *
          * @param value The column data. The data is copied.
          */
-        DataColumn(const std::vector<char>& value) : DataColumn()
-        {
-        	dataType = DataType::Enum::BLOB;
-        	binaryValue.reset(new std::vector<char>());
-        	binaryValue->insert(binaryValue->begin(), value.begin(), value.end());
-        }
+        DataColumn(const std::vector<char>& value) : dataType(DataType::Enum::BLOB), binaryValue(std::make_shared<std::vector<char>>(value.begin(), value.end())) {}
 
         /**
          * Constructor to create a data column of type BLOB.
          *
          * @param value The column data. The data is copied.
          */
-        DataColumn(const std::vector<uint8_t>& value) : DataColumn()
-        {
-        	dataType = DataType::Enum::BLOB;
-        	binaryValue.reset(new std::vector<char>());
-        	binaryValue->insert(binaryValue->begin(), value.begin(), value.end());
-        }
+        DataColumn(const std::vector<uint8_t>& value) : dataType(DataType::Enum::BLOB), binaryValue(std::make_shared<std::vector<char>>(value.begin(), value.end())) {}
 
         /**
          * Destructor. It does nothing.
@@ -35,6 +35,7 @@
 #include "../Variable.h"
 #include "../Sockets/RpcClientInfo.h"
 #include "../Systems/Peer.h"
+#include <functional>
 #include <set>
 
 namespace BaseLib
@@ -240,6 +241,20 @@ public:
 	virtual void savePeerVariableAsynchronous(DataRow& data) = 0;
 	virtual std::shared_ptr<DataTable> getPeerParameters(uint64_t peerID) = 0;
 	virtual std::shared_ptr<DataTable> getPeerVariables(uint64_t peerID) = 0;
+
+	/**
+	 * Calls "callback" once for every peer of a central with the peer's parameters, i. e. the rows getPeerParameters() returns for
+	 * the peer. Peers without parameters might be skipped. Database controllers should override it and read the parameters of all
+	 * peers with one query ordered by peer ID, passing the rows of each peer on as soon as the next peer starts.
+	 *
+	 * The default implementation doesn't call "callback". Peers not passed to it read their parameters with getPeerParameters() when
+	 * they are loaded, so querying them here one by one would only add another query of the peers of the central.
+	 *
+	 * @param deviceId The ID of the central as passed to getPeers().
+	 * @param callback Called for each peer. It is called from the calling thread.
+	 */
+	virtual void getPeerParametersOfCentral(uint64_t deviceId, const std::function<void(uint64_t peerId, std::shared_ptr<DataTable>& rows)>& callback) {}
+
 	virtual void deletePeerParameter(uint64_t peerID, DataRow& data) = 0;
 
 	virtual bool peerExists(uint64_t peerId) = 0;
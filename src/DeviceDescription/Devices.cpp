@@ -49,6 +49,7 @@ void Devices::clear()
 {
 	std::lock_guard<std::mutex> devicesGuard(_devicesMutex);
 	_devices.clear();
+	_generation++;
 }
 
 void Devices::load()
@@ -74,6 +75,7 @@ void Devices::load(std::string& xmlPath)
 	{
 		std::lock_guard<std::mutex> devicesGuard(_devicesMutex);
 		_devices.clear();
+		_generation++;
 		std::string deviceDir(xmlPath);
 		if(deviceDir.back() != '/') deviceDir.push_back('/');
 		std::vector<std::string> files;
@@ -97,6 +99,7 @@ void Devices::load(std::string& xmlPath)
 			std::shared_ptr<HomegearDevice> device = loadFile(filename);
 			if(device) _devices.push_back(device);
 		}
+		_generation++; //Responses created while loading are incomplete
 
 		if(_devices.empty()) _bl->out.printError("Could not load any devices from xml files in \"" + deviceDir + "\".");
 	}
@@ -1352,17 +1355,23 @@ std::shared_ptr<Variable> Devices::getParamsetDescription(PRpcClientInfo clientI
 		if(!parameterGroup) return Variable::createError(-3, "Unknown parameter set");
 		if(!clientInfo) clientInfo.reset(new RpcClientInfo());
 
-		std::shared_ptr<Variable> descriptions(new Variable(VariableType::tStruct));
+		//The description only depends on the device description, the client's language and on initNewFormat. Return a copy of the
+		//struct so callers can add or remove parameters. The parameter descriptions themselves are shared.
+		std::string cacheKey = "paramset." + std::to_string(channel) + '.' + std::to_string((int32_t)type) + '.' + (clientInfo->initNewFormat ? "1." : "0.") + clientInfo->language;
+		std::shared_ptr<Variable> descriptions = device->getCachedDescription(cacheKey);
+		if(descriptions)
+		{
+			std::shared_ptr<Variable> descriptionsCopy = std::make_shared<Variable>(VariableType::tStruct);
+			*descriptionsCopy->structValue = *descriptions->structValue;
+			return descriptionsCopy;
+		}
+
+		descriptions = std::make_shared<Variable>(VariableType::tStruct);
 		std::shared_ptr<Variable> description;
 		uint32_t index = 0;
 		for(Parameters::iterator i = parameterGroup->parameters.begin(); i != parameterGroup->parameters.end(); ++i)
 		{
 			if(!i->second || i->second->id.empty() || !i->second->visible) continue;
-			if(!i->second->visible && !i->second->service && !i->second->internal  && !i->second->transform)
-			{
-				_bl->out.printDebug("Debug: Omitting parameter " + i->second->id + " because of it's ui flag.");
-				continue;
-			}
 			description.reset(new Variable(VariableType::tStruct));
 
 			int32_t operations = 0;
@@ -1520,7 +1529,11 @@ std::shared_ptr<Variable> Devices::getParamsetDescription(PRpcClientInfo clientI
 			index++;
 			descriptions->structValue->insert(StructElement(i->second->id, description));
 		}
-		return descriptions;
+		device->setCachedDescription(cacheKey, clientInfo->language, descriptions);
+
+		std::shared_ptr<Variable> descriptionsCopy = std::make_shared<Variable>(VariableType::tStruct);
+		*descriptionsCopy->structValue = *descriptions->structValue;
+		return descriptionsCopy;
 	}
 	catch(const std::exception& ex)
     {
@@ -41,6 +41,8 @@
 #include "../IEvents.h"
 #include "DeviceTranslations.h"
 
+#include <atomic>
+
 namespace BaseLib
 {
 
@@ -75,7 +77,20 @@ public:
 	std::unordered_map<std::string, uint32_t> getIdTypeNumberMap();
 	std::unordered_set<uint32_t> getKnownTypeNumbers();
 
+	/**
+	 * Returns a number that changes whenever device descriptions are loaded or cleared. RPC responses created from the
+	 * descriptions can be cached as long as it stays the same.
+	 */
+	uint64_t getGeneration() { return _generation; }
+
 	// {{{ RPC
+	/**
+	 * Returns the description of a parameter set as returned by the RPC method getParamsetDescription. Descriptions are cached in
+	 * the device description (see HomegearDevice::getCachedDescription()).
+	 *
+	 * The returned struct is a copy, so parameters can be added or removed. The parameter descriptions in it are shared with the
+	 * cache and other callers, though, and must not be modified. Replace an entry with a copy to change it.
+	 */
 	std::shared_ptr<Variable> getParamsetDescription(PRpcClientInfo clientInfo, int32_t deviceId, int32_t firmwareVersion, int32_t channel, ParameterGroup::Type::Enum type);
 	PVariable listKnownDeviceType(PRpcClientInfo clientInfo, std::shared_ptr<HomegearDevice>& device, PSupportedDevice deviceType, int32_t channel, std::set<std::string>& fields);
 	PVariable listKnownDeviceTypes(PRpcClientInfo clientInfo, bool channels, std::set<std::string>& fields);
@@ -84,6 +99,7 @@ protected:
 	BaseLib::SharedObjects* _bl = nullptr;
 	int32_t _family = -1;
 	std::mutex _devicesMutex;
+	std::atomic<uint64_t> _generation{0};
 	std::vector<std::shared_ptr<HomegearDevice>> _devices;
 	std::vector<std::shared_ptr<HomegearDevice>> _dynamicDevices;
     std::shared_ptr<DeviceDescription::DeviceTranslations> _translations;
@@ -293,6 +293,84 @@ void HomegearDevice::postLoad()
     }
 }
 
+uint32_t HomegearDevice::indexParameters(bool force)
+{
+	try
+	{
+		std::lock_guard<std::mutex> parameterIndexesGuard(*_parameterIndexesMutex);
+		if(_parametersIndexed && !force) return _parameterIndexes.size();
+		_parameterIndexes.clear();
+		if(force) clearCachedDescriptions();
+
+		auto indexGroup = [&](const PParameterGroup& group)
+		{
+			if(!group) return;
+			for(auto& parameter : group->parameters)
+			{
+				if(!parameter.second) continue;
+				auto result = _parameterIndexes.emplace(parameter.second->id, (int32_t)_parameterIndexes.size());
+				parameter.second->nameIndex = result.first->second;
+			}
+		};
+
+		for(auto& function : functions)
+		{
+			if(!function.second) continue;
+			indexGroup(function.second->configParameters);
+			indexGroup(function.second->variables);
+			indexGroup(function.second->linkParameters);
+			for(auto& alternativeFunction : function.second->alternativeFunctions)
+			{
+				indexGroup(alternativeFunction->configParameters);
+				indexGroup(alternativeFunction->variables);
+				indexGroup(alternativeFunction->linkParameters);
+			}
+		}
+		_parametersIndexed = true;
+		return _parameterIndexes.size();
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return 0;
+}
+
+int32_t HomegearDevice::getParameterIndex(const std::string& id)
+{
+	std::lock_guard<std::mutex> parameterIndexesGuard(*_parameterIndexesMutex);
+	auto parameterIterator = _parameterIndexes.find(id);
+	if(parameterIterator == _parameterIndexes.end()) return -1;
+	return parameterIterator->second;
+}
+
+PVariable HomegearDevice::getCachedDescription(const std::string& key)
+{
+	std::lock_guard<std::mutex> descriptionCacheGuard(_descriptionCache->mutex);
+	auto descriptionIterator = _descriptionCache->descriptions.find(key);
+	if(descriptionIterator == _descriptionCache->descriptions.end()) return PVariable();
+	return descriptionIterator->second;
+}
+
+void HomegearDevice::setCachedDescription(const std::string& key, const std::string& language, const PVariable& description)
+{
+	if(!description || description->errorStruct) return;
+	std::lock_guard<std::mutex> descriptionCacheGuard(_descriptionCache->mutex);
+	if(_descriptionCache->languages.find(language) == _descriptionCache->languages.end())
+	{
+		if(_descriptionCache->languages.size() >= maxCachedLanguages) return;
+		_descriptionCache->languages.emplace(language);
+	}
+	_descriptionCache->descriptions[key] = description;
+}
+
+void HomegearDevice::clearCachedDescriptions()
+{
+	std::lock_guard<std::mutex> descriptionCacheGuard(_descriptionCache->mutex);
+	_descriptionCache->languages.clear();
+	_descriptionCache->descriptions.clear();
+}
+
 void HomegearDevice::save(std::string& filename)
 {
 	xml_document<> doc;
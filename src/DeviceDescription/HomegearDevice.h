@@ -36,6 +36,10 @@
 #include "RunProgram.h"
 #include "Function.h"
 
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
 using namespace rapidxml;
 
 namespace BaseLib
@@ -115,6 +119,49 @@ public:
 	PSupportedDevice getType(uint32_t typeNumber);
 	PSupportedDevice getType(uint32_t typeNumber, int32_t firmwareVersion);
 	void save(std::string& filename);
+
+	/**
+	 * Assigns each distinct parameter ID of all functions (including alternative functions) a small index and stores it in
+	 * Parameter::nameIndex. Only the first call does the work, so peers can call it when they are initialized. Call it with
+	 * "force" set to true after adding parameters to the description. This method is thread safe.
+	 *
+	 * @param force Index the parameters again.
+	 * @return Returns the number of distinct parameter IDs.
+	 */
+	uint32_t indexParameters(bool force = false);
+
+	/**
+	 * Returns the index of a parameter ID assigned by indexParameters() or -1 if the ID is unknown.
+	 */
+	int32_t getParameterIndex(const std::string& id);
+
+	/**
+	 * Returns a description stored with setCachedDescription() or nullptr. The returned description is shared by all callers
+	 * and must not be modified. This method is thread safe.
+	 *
+	 * @param key The key the description was stored with, e. g. channel, parameter set type and language.
+	 * @return Returns the cached description or nullptr.
+	 */
+	PVariable getCachedDescription(const std::string& key);
+
+	/**
+	 * Stores a paramset or parameter description built from this device description, so it doesn't need to be built again on
+	 * every RPC call. The description must not be modified after calling this method. This method is thread safe.
+	 *
+	 * Clients can set any language, so descriptions are only stored for the first maxCachedLanguages languages. Descriptions of
+	 * other languages are built on every call.
+	 *
+	 * @param key The key to store the description with.
+	 * @param language The language the description was built for. It must be part of "key".
+	 * @param description The description to store.
+	 */
+	void setCachedDescription(const std::string& key, const std::string& language, const PVariable& description);
+
+	/**
+	 * Removes all cached descriptions. Call it after changing parameters of the description. indexParameters() with "force" set
+	 * to true calls it, too.
+	 */
+	void clearCachedDescriptions();
 	// }}}
 protected:
 	BaseLib::SharedObjects* _bl = nullptr;
@@ -124,6 +171,29 @@ protected:
 	std::string _path;
     std::string _filename;
 	int32_t _dynamicChannelCount = -1;
+	/**
+	 * Shared with copies of the device (see Devices::find()), as they share the Parameter objects the indexes are written to.
+	 */
+	std::shared_ptr<std::mutex> _parameterIndexesMutex = std::make_shared<std::mutex>();
+	bool _parametersIndexed = false;
+	std::unordered_map<std::string, int32_t> _parameterIndexes;
+
+	/**
+	 * The maximum number of languages descriptions are cached for.
+	 */
+	static const size_t maxCachedLanguages = 8;
+
+	struct DescriptionCache
+	{
+		std::mutex mutex;
+		std::unordered_set<std::string> languages;
+		std::unordered_map<std::string, PVariable> descriptions;
+	};
+	/**
+	 * Shared with copies of the device like _parameterIndexesMutex. Copies only add functions for new channels, so descriptions
+	 * of existing channels stay valid.
+	 */
+	std::shared_ptr<DescriptionCache> _descriptionCache = std::make_shared<DescriptionCache>();
 	// }}}
 
 	void load(std::string xmlFilename, bool& oldFormat);
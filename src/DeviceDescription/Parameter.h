@@ -128,6 +128,12 @@ public:
 	//Helpers
 	bool hasDelayedAutoResetParameters = false;
 
+	/**
+	 * Index of "id" within the device description, set by HomegearDevice::indexParameters(). Peers use it to look up their
+	 * parameters in dense tables. -1 when not indexed.
+	 */
+	int32_t nameIndex = -1;
+
 	explicit Parameter(BaseLib::SharedObjects* baseLib, const PParameterGroup& parent);
 	virtual ~Parameter();
 
@@ -162,6 +168,12 @@ public:
 	void adjustBitPosition(std::vector<uint8_t>& data);
 
 	const PParameterGroup parent();
+
+	/**
+	 * Returns true when "group" is the parent of this parameter. Cheaper than comparing parent() or searching the group by ID, as
+	 * neither a shared pointer is created nor the ID is hashed.
+	 */
+	bool hasParent(const PParameterGroup& group) const { return group && !_parent.owner_before(group) && !group.owner_before(_parent); }
 protected:
 	BaseLib::SharedObjects* _bl = nullptr;
 
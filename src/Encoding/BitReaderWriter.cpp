@@ -160,134 +160,22 @@ std::vector<uint8_t> BitReaderWriter::getPosition(const std::vector<char>& data,
 
 uint8_t BitReaderWriter::getPosition8(const std::vector<uint8_t>& data, uint32_t position, uint32_t size)
 {
-	if(size > 8) size = 8;
-	else if(size == 0) return 0;
-	uint8_t result = 0;
-
-	uint32_t bytePosition = position / 8;
-	int32_t bitPosition = position % 8;
-	int32_t sourceByteSize = (bitPosition + size) / 8 + ((bitPosition + size) % 8 != 0 ? 1 : 0);
-
-	if(bytePosition >= data.size()) return 0;
-
-	uint8_t firstByte = data.at(bytePosition) & _bitMaskGet[bitPosition];
-	if(sourceByteSize == 1)
-	{
-		result = firstByte >> ((8 - ((bitPosition + size) % 8)) % 8);
-		return result;
-	}
-
-	result |= (uint16_t)firstByte << (size - (8 - bitPosition));
-
-	if(bytePosition + 1 >= data.size()) return result;
-	result |= data.at(bytePosition + 1) >> ((8 - ((bitPosition + size) % 8)) % 8);
-	return result;
+	return (uint8_t)getPosition64(data.data(), data.size(), position, size > 8 ? 8 : size);
 }
 
 uint16_t BitReaderWriter::getPosition16(const std::vector<uint8_t>& data, uint32_t position, uint32_t size)
 {
-	if(size > 16) size = 16;
-	else if(size == 0) return 0;
-	uint16_t result = 0;
-
-	uint32_t bytePosition = position / 8;
-	int32_t bitPosition = position % 8;
-	int32_t sourceByteSize = (bitPosition + size) / 8 + ((bitPosition + size) % 8 != 0 ? 1 : 0);
-
-	if(bytePosition >= data.size()) return 0;
-
-	uint8_t firstByte = data.at(bytePosition) & _bitMaskGet[bitPosition];
-	if(sourceByteSize == 1)
-	{
-		result = firstByte >> ((8 - ((bitPosition + size) % 8)) % 8);
-		return result;
-	}
-
-	int32_t bitsLeft = size - (8 - bitPosition);
-	result |= (uint16_t)firstByte << bitsLeft;
-	bitsLeft -= 8;
-
-	for(uint32_t i = bytePosition + 1; i < bytePosition + sourceByteSize - 1; i++)
-	{
-		if(i >= data.size()) return result;
-		result |= (uint16_t)data.at(i) << bitsLeft;
-		bitsLeft -= 8;
-	}
-
-	if(bytePosition + sourceByteSize - 1 >= data.size()) return result;
-	result |= data.at(bytePosition + sourceByteSize - 1) >> ((8 - ((bitPosition + size) % 8)) % 8);
-
-	return result;
+	return (uint16_t)getPosition64(data.data(), data.size(), position, size > 16 ? 16 : size);
 }
 
 uint32_t BitReaderWriter::getPosition32(const std::vector<uint8_t>& data, uint32_t position, uint32_t size)
 {
-	if(size > 32) size = 32;
-	else if(size == 0) return 0;
-	uint32_t result = 0;
-
-	uint32_t bytePosition = position / 8;
-	int32_t bitPosition = position % 8;
-	int32_t sourceByteSize = (bitPosition + size) / 8 + ((bitPosition + size) % 8 != 0 ? 1 : 0);
-
-	if(bytePosition >= data.size()) return 0;
-
-	uint8_t firstByte = data.at(bytePosition) & _bitMaskGet[bitPosition];
-	if(sourceByteSize == 1)
-	{
-		result = firstByte >> ((8 - ((bitPosition + size) % 8)) % 8);
-		return result;
-	}
-
-	int32_t bitsLeft = size - (8 - bitPosition);
-	result |= (uint32_t)firstByte << bitsLeft;
-	bitsLeft -= 8;
-
-	for(uint32_t i = bytePosition + 1; i < bytePosition + sourceByteSize - 1; i++)
-	{
-		if(i >= data.size()) return result;
-		result |= (uint32_t)data.at(i) << bitsLeft;
-		bitsLeft -= 8;
-	}
-
-	if(bytePosition + sourceByteSize - 1 >= data.size()) return result;
-	result |= data.at(bytePosition + sourceByteSize - 1) >> ((8 - ((bitPosition + size) % 8)) % 8);
-	return result;
+	return (uint32_t)getPosition64(data.data(), data.size(), position, size > 32 ? 32 : size);
 }
 
 uint64_t BitReaderWriter::getPosition64(const std::vector<uint8_t>& data, uint32_t position, uint32_t size)
 {
-	if(size > 64) size = 64;
-	else if(size == 0) return 0;
-	uint64_t result = 0;
-
-	uint32_t bytePosition = position / 8;
-	int32_t bitPosition = position % 8;
-	int32_t sourceByteSize = (bitPosition + size) / 8 + ((bitPosition + size) % 8 != 0 ? 1 : 0);
-
-	if(bytePosition >= data.size()) return 0;
-
-	uint8_t firstByte = data.at(bytePosition) & _bitMaskGet[bitPosition];
-	if(sourceByteSize == 1)
-	{
-		result = firstByte >> ((8 - ((bitPosition + size) % 8)) % 8);
-		return result;
-	}
-
-	int32_t bitsLeft = size - (8 - bitPosition);
-	result |= (uint64_t)firstByte << bitsLeft;
-	bitsLeft -= 8;
-
-	for(uint32_t i = bytePosition + 1; i < bytePosition + sourceByteSize - 1; i++)
-	{
-		if(i >= data.size()) return result;
-		result |= (uint64_t)data.at(i) << bitsLeft;
-		bitsLeft -= 8;
-	}
-
-	if(bytePosition + sourceByteSize - 1 >= data.size()) return result;
-	result |= data.at(bytePosition + sourceByteSize - 1) >> ((8 - ((bitPosition + size) % 8)) % 8);
-	return result;
+	return getPosition64(data.data(), data.size(), position, size);
 }
 
 void BitReaderWriter::setPosition(uint32_t position, uint32_t size, std::vector<uint8_t>& target, const std::vector<uint8_t>& source)
@@ -406,4 +294,36 @@ void BitReaderWriter::setPosition(uint32_t position, uint32_t size, std::vector<
 	}
 }
 
+BitLayout::BitLayout(std::initializer_list<BitField> fields)
+{
+	_fields.reserve(fields.size());
+	for(auto& field : fields)
+	{
+		addField(field.position, field.size);
+	}
+}
+
+size_t BitLayout::addField(uint32_t position, uint32_t size)
+{
+	if(size > 64) size = 64;
+	_fields.push_back(BitField{position, size});
+	size_t endByte = ((size_t)position + size + 7) / 8;
+	if(endByte > _byteSize) _byteSize = endByte;
+	return _fields.size() - 1;
+}
+
+void BitLayout::decode(const uint8_t* data, size_t dataSize, uint64_t* values) const
+{
+	for(size_t i = 0; i < _fields.size(); i++)
+	{
+		values[i] = BitReaderWriter::getPosition64(data, dataSize, _fields[i].position, _fields[i].size);
+	}
+}
+
+void BitLayout::decode(const std::vector<uint8_t>& data, std::vector<uint64_t>& values) const
+{
+	if(values.size() < _fields.size()) values.resize(_fields.size());
+	decode(data.data(), data.size(), values.data());
+}
+
 }
@@ -33,15 +33,114 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
 
 namespace BaseLib
 {
 
+/**
+ * Position and size of a bit field as passed to BitReaderWriter::getPosition(). Can be used in constexpr arrays.
+ */
+struct BitField
+{
+	/**
+	 * The position in bits starting with bit 7 of index 0.
+	 */
+	uint32_t position;
+
+	/**
+	 * The size in bits. Fields larger than 64 bits are truncated to 64 bits.
+	 */
+	uint32_t size;
+};
+
 class BitReaderWriter
 {
 public:
 	virtual ~BitReaderWriter();
 
+	/**
+	 * Reads up to 64 bits at any position from a byte array without allocating memory. It is ok for position + size to exceed the
+	 * array boundaries, missing bytes are read as 0.
+	 *
+	 * @param data The byte array to read from. Index 0 must be the most significant byte.
+	 * @param dataSize The size of data in bytes.
+	 * @param position The position in bits starting with bit 7 of index 0 (position 1 is bit 6 of index 0 and so on). Example: If data is 00101000 00001000, position is 2 and size is 3 then the result is 00000101.
+	 * @param size The size in bits of the data to read. Values larger than 64 are treated as 64.
+	 * @return The data is returned right aligned.
+	 */
+	static inline uint64_t getPosition64(const uint8_t* data, size_t dataSize, uint32_t position, uint32_t size)
+	{
+		if(size == 0) return 0;
+		if(size > 64) size = 64;
+		size_t bytePosition = position / 8;
+		if(bytePosition >= dataSize) return 0;
+		uint32_t bitPosition = position & 7;
+		uint32_t endPosition = bitPosition + size;
+		uint32_t byteCount = (endPosition + 7) / 8;
+		const uint8_t* source = data + bytePosition;
+		size_t availableBytes = dataSize - bytePosition;
+
+		if(availableBytes >= 8 && endPosition <= 64)
+		{
+			//One unaligned 64 bit load for all fields not crossing the 8 byte boundary.
+			uint64_t value = 0;
+			std::memcpy(&value, source, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+			value = __builtin_bswap64(value);
+#endif
+			return (value << bitPosition) >> (64 - size);
+		}
+		else if(byteCount <= 8)
+		{
+			//Near the end of data only touch the bytes containing the field.
+			uint32_t bytesToRead = byteCount < availableBytes ? byteCount : (uint32_t)availableBytes;
+			uint64_t value = 0;
+			for(uint32_t i = 0; i < bytesToRead; i++)
+			{
+				value = (value << 8) | source[i];
+			}
+			value <<= (byteCount - bytesToRead) * 8;
+			value >>= (byteCount * 8) - endPosition;
+			return size == 64 ? value : value & ((1ull << size) - 1);
+		}
+
+		//The field spans 9 bytes.
+		uint64_t value = 0;
+		for(uint32_t i = 0; i < 8; i++)
+		{
+			value = (value << 8) | (i < availableBytes ? source[i] : 0);
+		}
+		value <<= bitPosition;
+		if(availableBytes > 8) value |= source[8] >> (8 - bitPosition);
+		return value >> (64 - size);
+	}
+
+	/**
+	 * Decodes all fields of a layout known at compile time in one pass without allocating memory.
+	 *
+	 * Example:
+	 *
+	 *     static constexpr BaseLib::BitField layout[] = { {0, 8}, {8, 4}, {12, 12} };
+	 *     uint64_t values[3];
+	 *     BaseLib::BitReaderWriter::decode(packet.data(), packet.size(), layout, values);
+	 *
+	 * @param data The byte array to read from. Index 0 must be the most significant byte.
+	 * @param dataSize The size of data in bytes.
+	 * @param layout The fields to read.
+	 * @param[out] values The right aligned value of each field in the order of layout.
+	 */
+	template<size_t N>
+	static inline void decode(const uint8_t* data, size_t dataSize, const BitField (&layout)[N], uint64_t (&values)[N])
+	{
+		for(size_t i = 0; i < N; i++)
+		{
+			values[i] = getPosition64(data, dataSize, layout[i].position, layout[i].size);
+		}
+	}
+
 	/**
 	 * Reads any number of bits at any position from a byte array. It is ok for position + size to exceed the array boundaries.
 	 *
@@ -130,5 +229,51 @@ private:
 	BitReaderWriter();
 };
 
+/**
+ * Packet layout built at runtime, e.g. once when the device description is loaded. Decodes all fields of a frame in one pass
+ * without allocating memory, as long as the value array passed to decode() is reused.
+ */
+class BitLayout
+{
+public:
+	BitLayout() = default;
+	BitLayout(std::initializer_list<BitField> fields);
+
+	/**
+	 * Adds a field to the layout.
+	 *
+	 * @param position The position in bits starting with bit 7 of index 0.
+	 * @param size The size in bits. Values larger than 64 are treated as 64.
+	 * @return Returns the index of the field's value as returned by decode().
+	 */
+	size_t addField(uint32_t position, uint32_t size);
+
+	const std::vector<BitField>& fields() const { return _fields; }
+	size_t size() const { return _fields.size(); }
+	bool empty() const { return _fields.empty(); }
+
+	/**
+	 * Returns the number of bytes needed to contain all fields. Shorter packets can be decoded, missing bits are read as 0.
+	 */
+	size_t byteSize() const { return _byteSize; }
+
+	/**
+	 * Decodes all fields.
+	 *
+	 * @param data The byte array to read from. Index 0 must be the most significant byte.
+	 * @param dataSize The size of data in bytes.
+	 * @param[out] values Must have room for size() values. Receives the right aligned value of each field in the order of addField().
+	 */
+	void decode(const uint8_t* data, size_t dataSize, uint64_t* values) const;
+
+	/**
+	 * Decodes all fields. values is only resized when it is smaller than size(), so reuse it to avoid allocations.
+	 */
+	void decode(const std::vector<uint8_t>& data, std::vector<uint64_t>& values) const;
+private:
+	std::vector<BitField> _fields;
+	size_t _byteSize = 0;
+};
+
 }
 #endif
@@ -30,13 +30,41 @@
 
 #include "GZip.h"
 
+#include <algorithm>
 #include <array>
 
+#ifdef LIBDEFLATE
+#include <libdeflate.h>
+#endif
+
 namespace BaseLib
 {
 
+#ifdef LIBDEFLATE
+namespace
+{
+    int32_t toLibdeflateLevel(int32_t compressionLevel)
+    {
+        if(compressionLevel == Z_DEFAULT_COMPRESSION) return 6;
+        if(compressionLevel < 0 || compressionLevel > 9) throw GZipException("Invalid compression level: " + std::to_string(compressionLevel));
+        return compressionLevel;
+    }
+}
+#endif
+
 template<typename DataOut, typename DataIn> DataOut GZip::compress(const DataIn& data, int32_t compressionLevel)
 {
+    DataOut compressedData;
+
+#ifdef LIBDEFLATE
+    struct libdeflate_compressor* compressor = libdeflate_alloc_compressor(toLibdeflateLevel(compressionLevel));
+    if(!compressor) throw GZipException("Error initializing GZip stream.");
+    compressedData.resize(libdeflate_gzip_compress_bound(compressor, data.size()));
+    size_t compressedSize = libdeflate_gzip_compress(compressor, data.data(), data.size(), &compressedData[0], compressedData.size());
+    libdeflate_free_compressor(compressor);
+    if(compressedSize == 0) throw GZipException("Error during compression.");
+    compressedData.resize(compressedSize);
+#else
     z_stream zStream{};
     zStream.zalloc = Z_NULL;
     zStream.zfree = Z_NULL;
@@ -46,32 +74,59 @@ template<typename DataOut, typename DataIn> DataOut GZip::compress(const DataIn&
         throw GZipException("Error initializing GZip stream.");
     }
 
+    //deflateBound() returns the maximum size of the output, so everything is compressed with one call directly into the output.
+    compressedData.resize(deflateBound(&zStream, data.size()));
     zStream.next_in = (unsigned char*)data.data();
     zStream.avail_in = (unsigned int)data.size();
-
-    DataOut compressedData;
-    compressedData.reserve(data.size());
-    std::array<uint8_t, 16384> compressedChunk{};
-
-    do
+    zStream.next_out = (unsigned char*)&compressedData[0];
+    zStream.avail_out = (unsigned int)compressedData.size();
+    if(deflate(&zStream, Z_FINISH) != Z_STREAM_END)
     {
-        zStream.avail_out = compressedChunk.size();
-        zStream.next_out = compressedChunk.data();
-        if(deflate(&zStream, Z_FINISH) == Z_STREAM_ERROR)
-        {
-            deflateEnd(&zStream);
-            throw GZipException("Error during compression.");
-        }
-        compressedData.insert(compressedData.end(), compressedChunk.begin(), compressedChunk.begin() + (compressedChunk.size() - zStream.avail_out));
-    } while(zStream.avail_out == 0);
+        deflateEnd(&zStream);
+        throw GZipException("Error during compression.");
+    }
+    compressedData.resize(zStream.total_out);
 
     if(deflateEnd(&zStream) != Z_OK) throw GZipException("Error during compression finalization.");
+#endif
 
     return compressedData;
 }
 
 template<typename DataOut, typename DataIn> DataOut GZip::uncompress(const DataIn& data)
 {
+    DataOut uncompressedData;
+    //The last four bytes of a gzip stream contain the uncompressed size modulo 2^32. It is only used as a size hint. As it is
+    //controlled by the sender, the memory allocated up front is limited. Larger outputs grow while they are uncompressed, so
+    //memory is only used for data that really is there.
+    const size_t maxSizeHint = std::max(data.size() * 8, (size_t)1048576);
+    size_t expectedSize = data.size() * 2;
+    bool sizeKnown = false;
+    if(data.size() >= 18)
+    {
+        const uint8_t* trailer = (const uint8_t*)data.data() + data.size() - 4;
+        size_t trailerSize = (size_t)trailer[0] | ((size_t)trailer[1] << 8) | ((size_t)trailer[2] << 16) | ((size_t)trailer[3] << 24);
+        sizeKnown = trailerSize <= maxSizeHint;
+        expectedSize = sizeKnown ? trailerSize : maxSizeHint;
+    }
+
+#ifdef LIBDEFLATE
+    //libdeflate needs to know the output size. This fails for concatenated streams, sizes of 4 GiB and more and sizes above
+    //the limit, which are uncompressed by zlib below.
+    if(sizeKnown && expectedSize > 0)
+    {
+        struct libdeflate_decompressor* decompressor = libdeflate_alloc_decompressor();
+        if(!decompressor) throw GZipException("Error initializing GZip stream.");
+        uncompressedData.resize(expectedSize);
+        size_t uncompressedSize = 0;
+        size_t compressedSize = 0;
+        libdeflate_result result = libdeflate_gzip_decompress_ex(decompressor, data.data(), data.size(), &uncompressedData[0], uncompressedData.size(), &compressedSize, &uncompressedSize);
+        libdeflate_free_decompressor(decompressor);
+        if(result == LIBDEFLATE_SUCCESS && compressedSize == data.size() && uncompressedSize == expectedSize) return uncompressedData;
+        uncompressedData.clear();
+    }
+#endif
+
     z_stream zStream{};
     zStream.zalloc = Z_NULL;
     zStream.zfree = Z_NULL;
@@ -86,15 +141,16 @@ template<typename DataOut, typename DataIn> DataOut GZip::uncompress(const DataI
     zStream.avail_in = data.size();
     zStream.next_in = (unsigned char*)data.data();
 
-    DataOut uncompressedData;
-    uncompressedData.reserve(data.size() * 2);
-    std::array<uint8_t, 16384> uncompressedChunk{};
+    //Uncompress directly into the output and grow it when it is full. One byte more than the size hint avoids growing the
+    //output just to find out that the stream has ended.
+    uncompressedData.resize(expectedSize < 16384 ? 16384 : (sizeKnown ? expectedSize + 1 : expectedSize));
     int result = 0;
 
     do
     {
-        zStream.avail_out = uncompressedChunk.size();
-        zStream.next_out = uncompressedChunk.data();
+        if(zStream.total_out == uncompressedData.size()) uncompressedData.resize(uncompressedData.size() * 2);
+        zStream.avail_out = uncompressedData.size() - zStream.total_out;
+        zStream.next_out = (unsigned char*)&uncompressedData[0] + zStream.total_out;
         result = inflate(&zStream, Z_NO_FLUSH);
         switch (result) {
             case Z_NEED_DICT:
@@ -103,14 +159,119 @@ template<typename DataOut, typename DataIn> DataOut GZip::uncompress(const DataI
                 inflateEnd(&zStream);
                 throw GZipException("Error during uncompression.");
         }
-        uncompressedData.insert(uncompressedData.end(), uncompressedChunk.begin(), uncompressedChunk.begin() + (uncompressedChunk.size() - zStream.avail_out));
     } while (zStream.avail_out == 0);
+    uncompressedData.resize(zStream.total_out);
 
     if (inflateEnd(&zStream) != Z_OK) throw GZipException("Error during uncompression finalization.");
 
     return uncompressedData;
 }
 
+GZipCompressor::GZipCompressor(int32_t compressionLevel, size_t chunkSize)
+{
+    if(deflateInit2(&_stream, compressionLevel, Z_DEFLATED, 0x1F, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw GZipException("Error initializing GZip stream.");
+    }
+    _chunk.resize(chunkSize == 0 ? 16384 : chunkSize);
+}
+
+GZipCompressor::~GZipCompressor()
+{
+    deflateEnd(&_stream);
+}
+
+void GZipCompressor::deflateAll(int32_t flush, const GZipSink& sink)
+{
+    do
+    {
+        _stream.next_out = (unsigned char*)_chunk.data();
+        _stream.avail_out = _chunk.size();
+        int32_t result = deflate(&_stream, flush);
+        if(result == Z_STREAM_ERROR) throw GZipException("Error during compression.");
+        size_t bytesCompressed = _chunk.size() - _stream.avail_out;
+        if(bytesCompressed > 0) sink(_chunk.data(), bytesCompressed);
+        if(result == Z_STREAM_END) break;
+    } while(_stream.avail_out == 0 || _stream.avail_in > 0);
+}
+
+void GZipCompressor::write(const char* data, size_t size, const GZipSink& sink)
+{
+    if(size == 0) return;
+    _stream.next_in = (unsigned char*)data;
+    _stream.avail_in = size;
+    deflateAll(Z_NO_FLUSH, sink);
+}
+
+void GZipCompressor::flush(const GZipSink& sink)
+{
+    _stream.next_in = Z_NULL;
+    _stream.avail_in = 0;
+    deflateAll(Z_SYNC_FLUSH, sink);
+}
+
+void GZipCompressor::finish(const GZipSink& sink)
+{
+    _stream.next_in = Z_NULL;
+    _stream.avail_in = 0;
+    deflateAll(Z_FINISH, sink);
+    deflateReset(&_stream);
+}
+
+void GZipCompressor::reset()
+{
+    deflateReset(&_stream);
+}
+
+GZipUncompressor::GZipUncompressor(size_t maxSize, size_t chunkSize) : _maxSize(maxSize)
+{
+    if(inflateInit2(&_stream, 16 + MAX_WBITS) != Z_OK)
+    {
+        throw GZipException("Error initializing GZip stream.");
+    }
+    _chunk.resize(chunkSize == 0 ? 16384 : chunkSize);
+}
+
+GZipUncompressor::~GZipUncompressor()
+{
+    inflateEnd(&_stream);
+}
+
+void GZipUncompressor::write(const char* data, size_t size, const GZipSink& sink)
+{
+    _stream.next_in = (unsigned char*)data;
+    _stream.avail_in = size;
+    while(true)
+    {
+        if(_finished)
+        {
+            if(_stream.avail_in == 0) break;
+            //Start of a concatenated stream
+            inflateReset(&_stream);
+            _finished = false;
+            _size = 0;
+        }
+
+        _stream.next_out = (unsigned char*)_chunk.data();
+        _stream.avail_out = _chunk.size();
+        int32_t result = inflate(&_stream, Z_NO_FLUSH);
+        if(result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) throw GZipException("Error during uncompression.");
+        size_t bytesUncompressed = _chunk.size() - _stream.avail_out;
+        _size += bytesUncompressed;
+        if(_maxSize > 0 && _size > _maxSize) throw GZipException("Uncompressed data is larger than " + std::to_string(_maxSize) + " bytes.");
+        if(bytesUncompressed > 0) sink(_chunk.data(), bytesUncompressed);
+        if(result == Z_STREAM_END) _finished = true;
+        else if((_stream.avail_in == 0 && _stream.avail_out > 0) || (result == Z_BUF_ERROR && bytesUncompressed == 0)) break;
+    }
+}
+
+void GZipUncompressor::reset()
+{
+    inflateReset(&_stream);
+    _size = 0;
+    _finished = false;
+}
+
 #ifndef DOXYGEN_SKIP
 template std::vector<char> GZip::compress(const std::vector<char>& data, int32_t compressionLevel);
 template std::string GZip::compress(const std::string& data, int32_t compressionLevel);
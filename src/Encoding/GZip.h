@@ -35,6 +35,8 @@
 
 #include <zlib.h>
 
+#include <functional>
+#include <string>
 #include <vector>
 
 namespace BaseLib
@@ -46,6 +48,13 @@ public:
     GZipException(std::string message) : Exception(message) {}
 };
 
+/**
+ * One-shot compression of data that is completely in memory. When libhomegear-base is configured with "--with-libdeflate",
+ * libdeflate is used, which is considerably faster than zlib for buffers that are compressed at once. zlib-ng in zlib compatible
+ * mode can be used as a drop-in replacement for zlib without any changes.
+ *
+ * To compress or uncompress data piece by piece, use GZipCompressor and GZipUncompressor.
+ */
 class GZip
 {
 public:
@@ -58,6 +67,103 @@ private:
     GZip() = default;
 };
 
+/**
+ * Receives the output of GZipCompressor and GZipUncompressor. The data is only valid during the call.
+ */
+typedef std::function<void(const char* data, size_t size)> GZipSink;
+
+/**
+ * Streaming gzip compression. The z_stream is created once and reused for all following streams, so one instance can compress any
+ * number of HTTP responses or files one after another. Not thread safe.
+ *
+ *     GZipCompressor compressor;
+ *     auto sink = [&](const char* data, size_t size) { socket->proofwrite(data, size); };
+ *     while(readChunk(chunk)) compressor.write(chunk.data(), chunk.size(), sink);
+ *     compressor.finish(sink);
+ */
+class GZipCompressor
+{
+public:
+    /**
+     * @param compressionLevel The zlib compression level (0 to 9 or Z_DEFAULT_COMPRESSION).
+     * @param chunkSize The maximum size of the data passed to the sink at once.
+     */
+    explicit GZipCompressor(int32_t compressionLevel = Z_DEFAULT_COMPRESSION, size_t chunkSize = 16384);
+    virtual ~GZipCompressor();
+
+    /**
+     * Compresses data. Output is only passed to the sink when zlib's internal buffers are full, so small writes usually produce
+     * no output.
+     */
+    void write(const char* data, size_t size, const GZipSink& sink);
+
+    /**
+     * Passes all pending output to the sink, so the receiver can uncompress everything written so far. Flushing often worsens the
+     * compression ratio.
+     */
+    void flush(const GZipSink& sink);
+
+    /**
+     * Ends the current gzip stream and passes the remaining output including the gzip trailer to the sink. The next call to write()
+     * starts a new stream.
+     */
+    void finish(const GZipSink& sink);
+
+    /**
+     * Discards the current stream without writing any more output.
+     */
+    void reset();
+private:
+    z_stream _stream{};
+    std::vector<char> _chunk;
+
+    GZipCompressor(const GZipCompressor&) = delete;
+    GZipCompressor& operator=(const GZipCompressor&) = delete;
+
+    void deflateAll(int32_t flush, const GZipSink& sink);
+};
+
+/**
+ * Streaming gzip decompression. Concatenated gzip streams are uncompressed as one. Not thread safe.
+ */
+class GZipUncompressor
+{
+public:
+    /**
+     * @param maxSize The maximum number of uncompressed bytes per stream. 0 means unlimited. When the limit is exceeded,
+     * write() throws a GZipException.
+     * @param chunkSize The maximum size of the data passed to the sink at once.
+     */
+    explicit GZipUncompressor(size_t maxSize = 0, size_t chunkSize = 16384);
+    virtual ~GZipUncompressor();
+
+    /**
+     * Uncompresses data and passes the result to the sink.
+     *
+     * @throws GZipException Thrown on invalid data or when maxSize is exceeded. Call reset() before reusing the object.
+     */
+    void write(const char* data, size_t size, const GZipSink& sink);
+
+    /**
+     * Returns true when the end of a gzip stream was reached and no data of a following stream was written yet.
+     */
+    bool finished() { return _finished; }
+
+    /**
+     * Discards the current stream, so the object can be used for new data.
+     */
+    void reset();
+private:
+    z_stream _stream{};
+    std::vector<char> _chunk;
+    size_t _maxSize = 0;
+    size_t _size = 0;
+    bool _finished = false;
+
+    GZipUncompressor(const GZipUncompressor&) = delete;
+    GZipUncompressor& operator=(const GZipUncompressor&) = delete;
+};
+
 }
 
 #endif
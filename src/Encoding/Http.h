@@ -172,6 +172,11 @@ public:
 	std::string getStatusText(int32_t code);
 	std::set<std::shared_ptr<FormData>> decodeMultipartFormdata();
 	std::set<std::shared_ptr<FormData>> decodeMultipartMixed(std::string& boundary, char* buffer, size_t bufferSize, char** pos);
+
+	/**
+	 * Creates the header of an HTTP response. To avoid copying the body, send header and body as separate buffers, e. g. with
+	 * TcpSocket::proofwrite(const std::vector<iovec>&).
+	 */
 	static void constructHeader(uint32_t contentLength, std::string contentType, int32_t code, std::string codeDescription, const std::vector<std::string>& additionalHeaders, std::string& header);
 	PVariable serialize();
 	void unserialize(PVariable data);
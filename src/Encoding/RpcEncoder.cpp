@@ -70,9 +70,15 @@ void RpcEncoder::encodeRequest(const std::string& methodName, const std::shared_
     uint32_t headerSize = 0;
     if(header)
     {
-        headerSize = encodeHeader(encodedData, *header) + 4;
-        if(headerSize > 0) encodedData.at(3) |= 0x40;
+        headerSize = encodeHeader(encodedData, *header);
+        if(headerSize > 0)
+        {
+            encodedData.at(3) |= 0x40;
+            headerSize += 4;
+        }
     }
+    //Placeholder for the length, so the payload doesn't need to be moved when it is filled in
+    encodedData.resize(encodedData.size() + 4);
     BinaryEncoder::encodeString(encodedData, methodName);
     if(!parameters) BinaryEncoder::encodeInteger(encodedData, 0);
     else BinaryEncoder::encodeInteger(encodedData, parameters->size());
@@ -84,10 +90,8 @@ void RpcEncoder::encodeRequest(const std::string& methodName, const std::shared_
         }
     }
 
-    uint32_t dataSize = encodedData.size() - 4 - headerSize;
-    char result[4];
-    HelperFunctions::memcpyBigEndian(result, (char*)&dataSize, 4);
-    encodedData.insert(encodedData.begin() + 4 + headerSize, result, result + 4);
+    uint32_t dataSize = encodedData.size() - 8 - headerSize;
+    HelperFunctions::memcpyBigEndian((char*)encodedData.data() + 4 + headerSize, (char*)&dataSize, 4);
 }
 
 void RpcEncoder::encodeRequest(const std::string& methodName, const std::shared_ptr<std::list<std::shared_ptr<Variable>>>& parameters, std::vector<uint8_t>& encodedData, const std::shared_ptr<RpcHeader>& header)
@@ -99,9 +103,15 @@ void RpcEncoder::encodeRequest(const std::string& methodName, const std::shared_
     uint32_t headerSize = 0;
     if(header)
     {
-        headerSize = encodeHeader(encodedData, *header) + 4;
-        if(headerSize > 0) encodedData.at(3) |= 0x40;
+        headerSize = encodeHeader(encodedData, *header);
+        if(headerSize > 0)
+        {
+            encodedData.at(3) |= 0x40;
+            headerSize += 4;
+        }
     }
+    //Placeholder for the length, so the payload doesn't need to be moved when it is filled in
+    encodedData.resize(encodedData.size() + 4);
     BinaryEncoder::encodeString(encodedData, methodName);
     if(!parameters) BinaryEncoder::encodeInteger(encodedData, 0);
     else BinaryEncoder::encodeInteger(encodedData, parameters->size());
@@ -113,10 +123,8 @@ void RpcEncoder::encodeRequest(const std::string& methodName, const std::shared_
         }
     }
 
-    uint32_t dataSize = encodedData.size() - 4 - headerSize;
-    char result[4];
-    HelperFunctions::memcpyBigEndian(result, (char*)&dataSize, 4);
-    encodedData.insert(encodedData.begin() + 4 + headerSize, result, result + 4);
+    uint32_t dataSize = encodedData.size() - 8 - headerSize;
+    HelperFunctions::memcpyBigEndian((char*)encodedData.data() + 4 + headerSize, (char*)&dataSize, 4);
 }
 
 void RpcEncoder::encodeRequest(const std::string& methodName, const PArray& parameters, std::vector<char>& encodedData, const std::shared_ptr<RpcHeader>& header)
@@ -128,9 +136,15 @@ void RpcEncoder::encodeRequest(const std::string& methodName, const PArray& para
     uint32_t headerSize = 0;
     if(header)
     {
-        headerSize = encodeHeader(encodedData, *header) + 4;
-        if(headerSize > 0) encodedData.at(3) |= 0x40;
+        headerSize = encodeHeader(encodedData, *header);
+        if(headerSize > 0)
+        {
+            encodedData.at(3) |= 0x40;
+            headerSize += 4;
+        }
     }
+    //Placeholder for the length, so the payload doesn't need to be moved when it is filled in
+    encodedData.resize(encodedData.size() + 4);
     BinaryEncoder::encodeString(encodedData, methodName);
     if(!parameters) BinaryEncoder::encodeInteger(encodedData, 0);
     else BinaryEncoder::encodeInteger(encodedData, parameters->size());
@@ -142,10 +156,8 @@ void RpcEncoder::encodeRequest(const std::string& methodName, const PArray& para
         }
     }
 
-    uint32_t dataSize = encodedData.size() - 4 - headerSize;
-    char result[4];
-    HelperFunctions::memcpyBigEndian(result, (char*)&dataSize, 4);
-    encodedData.insert(encodedData.begin() + 4 + headerSize, result, result + 4);
+    uint32_t dataSize = encodedData.size() - 8 - headerSize;
+    HelperFunctions::memcpyBigEndian((char*)encodedData.data() + 4 + headerSize, (char*)&dataSize, 4);
 }
 
 void RpcEncoder::encodeRequest(const std::string& methodName, const PArray& parameters, std::vector<uint8_t>& encodedData, const std::shared_ptr<RpcHeader>& header)
@@ -157,9 +169,15 @@ void RpcEncoder::encodeRequest(const std::string& methodName, const PArray& para
     uint32_t headerSize = 0;
     if(header)
     {
-        headerSize = encodeHeader(encodedData, *header) + 4;
-        if(headerSize > 0) encodedData.at(3) |= 0x40;
+        headerSize = encodeHeader(encodedData, *header);
+        if(headerSize > 0)
+        {
+            encodedData.at(3) |= 0x40;
+            headerSize += 4;
+        }
     }
+    //Placeholder for the length, so the payload doesn't need to be moved when it is filled in
+    encodedData.resize(encodedData.size() + 4);
     BinaryEncoder::encodeString(encodedData, methodName);
     if(!parameters) BinaryEncoder::encodeInteger(encodedData, 0);
     else BinaryEncoder::encodeInteger(encodedData, parameters->size());
@@ -171,10 +189,8 @@ void RpcEncoder::encodeRequest(const std::string& methodName, const PArray& para
         }
     }
 
-    uint32_t dataSize = encodedData.size() - 4 - headerSize;
-    char result[4];
-    HelperFunctions::memcpyBigEndian(result, (char*)&dataSize, 4);
-    encodedData.insert(encodedData.begin() + 4 + headerSize, result, result + 4);
+    uint32_t dataSize = encodedData.size() - 8 - headerSize;
+    HelperFunctions::memcpyBigEndian((char*)encodedData.data() + 4 + headerSize, (char*)&dataSize, 4);
 }
 
 void RpcEncoder::encodeResponse(const std::shared_ptr<Variable>& variable, std::vector<char>& encodedData)
@@ -184,13 +200,12 @@ void RpcEncoder::encodeResponse(const std::shared_ptr<Variable>& variable, std::
     encodedData.reserve(1024);
     if(variable && variable->errorStruct) encodedData.insert(encodedData.begin(), _packetStartError, _packetStartError + 4);
     else encodedData.insert(encodedData.begin(), _packetStartResponse, _packetStartResponse + 4);
+    encodedData.resize(8); //Placeholder for the length
 
     encodeVariable(encodedData, variable ? variable : std::make_shared<Variable>());
 
-    uint32_t dataSize = encodedData.size() - 4;
-    char result[4];
-    HelperFunctions::memcpyBigEndian(result, (char*)&dataSize, 4);
-    encodedData.insert(encodedData.begin() + 4, result, result + 4);
+    uint32_t dataSize = encodedData.size() - 8;
+    HelperFunctions::memcpyBigEndian((char*)encodedData.data() + 4, (char*)&dataSize, 4);
 }
 
 void RpcEncoder::encodeResponse(const std::shared_ptr<Variable>& variable, std::vector<uint8_t>& encodedData)
@@ -200,13 +215,12 @@ void RpcEncoder::encodeResponse(const std::shared_ptr<Variable>& variable, std::
     encodedData.reserve(1024);
     if(variable && variable->errorStruct) encodedData.insert(encodedData.begin(), _packetStartError, _packetStartError + 4);
     else encodedData.insert(encodedData.begin(), _packetStartResponse, _packetStartResponse + 4);
+    encodedData.resize(8); //Placeholder for the length
 
     encodeVariable(encodedData, variable ? variable : std::make_shared<Variable>());
 
-    uint32_t dataSize = encodedData.size() - 4;
-    char result[4];
-    HelperFunctions::memcpyBigEndian(result, (char*)&dataSize, 4);
-    encodedData.insert(encodedData.begin() + 4, result, result + 4);
+    uint32_t dataSize = encodedData.size() - 8;
+    HelperFunctions::memcpyBigEndian((char*)encodedData.data() + 4, (char*)&dataSize, 4);
 }
 
 void RpcEncoder::insertHeader(std::vector<char>& packet, const RpcHeader& header)
@@ -233,6 +247,22 @@ void RpcEncoder::insertHeader(std::vector<uint8_t>& packet, const RpcHeader& hea
 	}
 }
 
+uint32_t RpcEncoder::prepareHeader(std::vector<char>& packet, const RpcHeader& header, std::vector<char>& headerData)
+{
+	headerData.clear();
+	uint32_t headerSize = encodeHeader(headerData, header);
+	if(headerSize > 0) packet.at(3) |= 0x40;
+	return headerData.size();
+}
+
+uint32_t RpcEncoder::prepareHeader(std::vector<uint8_t>& packet, const RpcHeader& header, std::vector<uint8_t>& headerData)
+{
+	headerData.clear();
+	uint32_t headerSize = encodeHeader(headerData, header);
+	if(headerSize > 0) packet.at(3) |= 0x40;
+	return headerData.size();
+}
+
 uint32_t RpcEncoder::encodeHeader(std::vector<char>& packet, const RpcHeader& header)
 {
 	uint32_t oldPacketSize = packet.size();
@@ -67,6 +67,23 @@ public:
 
 	static void insertHeader(std::vector<char>& packet, const RpcHeader& header);
 	static void insertHeader(std::vector<uint8_t>& packet, const RpcHeader& header);
+
+	/**
+	 * Like insertHeader(), but encodes the header into a separate buffer instead of moving the whole payload. Only the header
+	 * flag is set in "packet". Send the first four bytes of "packet", then "headerData" and then the rest of "packet", e. g.
+	 * with TcpSocket::proofwrite(const std::vector<iovec>&).
+	 *
+	 * @param packet The encoded packet without header.
+	 * @param header The header to encode.
+	 * @param[out] headerData The encoded header. It is empty if the header has no fields.
+	 * @return Returns the size of headerData.
+	 */
+	static uint32_t prepareHeader(std::vector<char>& packet, const RpcHeader& header, std::vector<char>& headerData);
+
+	/**
+	 * @see prepareHeader(std::vector<char>&, const RpcHeader&, std::vector<char>&)
+	 */
+	static uint32_t prepareHeader(std::vector<uint8_t>& packet, const RpcHeader& header, std::vector<uint8_t>& headerData);
 	void encodeRequest(const std::string& methodName, const std::shared_ptr<std::list<std::shared_ptr<Variable>>>& parameters, std::vector<char>& encodedData, const std::shared_ptr<RpcHeader>& header = nullptr);
 	void encodeRequest(const std::string& methodName, const std::shared_ptr<std::list<std::shared_ptr<Variable>>>& parameters, std::vector<uint8_t>& encodedData, const std::shared_ptr<RpcHeader>& header = nullptr);
 	void encodeRequest(const std::string& methodName, const PArray& parameters, std::vector<char>& encodedData, const std::shared_ptr<RpcHeader>& header = nullptr);
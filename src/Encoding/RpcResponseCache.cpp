@@ -0,0 +1,144 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "RpcResponseCache.h"
+#include "RpcEncoder.h"
+#include "../Security/Acls.h"
+
+namespace BaseLib
+{
+namespace Rpc
+{
+
+const std::unordered_set<std::string> RpcResponseCache::_cacheableMethods{ "listDevices", "getParamsetDescription", "getDeviceDescription", "listKnownDeviceTypes" };
+
+RpcResponseCache::RpcResponseCache(size_t maxSize) : _maxSize(maxSize)
+{
+}
+
+bool RpcResponseCache::isCacheable(const std::string& methodName)
+{
+	return _cacheableMethods.find(methodName) != _cacheableMethods.end();
+}
+
+std::string RpcResponseCache::getKey(const PRpcClientInfo& clientInfo, const std::string& methodName, const PArray& parameters)
+{
+	//The binary RPC encoding of the call is unambiguous, so it can be used as key directly.
+	RpcEncoder rpcEncoder(false, true);
+	std::vector<char> request;
+	rpcEncoder.encodeRequest(methodName, parameters, request);
+
+	std::string key;
+	if(clientInfo)
+	{
+		key.append(std::to_string((int32_t)clientInfo->rpcType)).push_back(',');
+		key.append(std::to_string((int32_t)clientInfo->clientType)).push_back(',');
+		key.push_back(clientInfo->initNewFormat ? '1' : '0');
+		key.push_back(',');
+		//Length prefixed, as clients can set any language.
+		key.append(std::to_string(clientInfo->language.size())).push_back(':');
+		key.append(clientInfo->language).push_back(',');
+		if(clientInfo->acls) key.append(clientInfo->acls->getFingerprint());
+	}
+	key.push_back(',');
+	key.append(request.begin(), request.end());
+	return key;
+}
+
+std::shared_ptr<const std::vector<char>> RpcResponseCache::get(const std::string& key, uint64_t generation)
+{
+	std::lock_guard<std::mutex> entriesGuard(_entriesMutex);
+	auto entryIterator = _entries.find(key);
+	if(entryIterator == _entries.end())
+	{
+		_misses++;
+		return std::shared_ptr<const std::vector<char>>();
+	}
+	if(entryIterator->second->generation != generation)
+	{
+		remove(entryIterator);
+		_misses++;
+		return std::shared_ptr<const std::vector<char>>();
+	}
+	_entryList.splice(_entryList.begin(), _entryList, entryIterator->second);
+	_hits++;
+	return entryIterator->second->response;
+}
+
+void RpcResponseCache::set(const std::string& key, uint64_t generation, std::shared_ptr<const std::vector<char>> response)
+{
+	if(!response || response->size() > _maxSize) return;
+
+	std::lock_guard<std::mutex> entriesGuard(_entriesMutex);
+	auto entryIterator = _entries.find(key);
+	if(entryIterator != _entries.end()) remove(entryIterator);
+
+	_bytes += response->size();
+	Entry entry;
+	entry.key = key;
+	entry.generation = generation;
+	entry.response = std::move(response);
+	_entryList.push_front(std::move(entry));
+	_entries.emplace(key, _entryList.begin());
+
+	while(_bytes > _maxSize)
+	{
+		remove(_entries.find(_entryList.back().key));
+	}
+}
+
+void RpcResponseCache::clear()
+{
+	std::lock_guard<std::mutex> entriesGuard(_entriesMutex);
+	_entries.clear();
+	_entryList.clear();
+	_bytes = 0;
+}
+
+RpcResponseCache::Metrics RpcResponseCache::getMetrics()
+{
+	Metrics metrics;
+	metrics.hits = _hits;
+	metrics.misses = _misses;
+	std::lock_guard<std::mutex> entriesGuard(_entriesMutex);
+	metrics.entries = _entries.size();
+	metrics.bytes = _bytes;
+	return metrics;
+}
+
+void RpcResponseCache::remove(std::unordered_map<std::string, std::list<Entry>::iterator>::iterator entryIterator)
+{
+	_bytes -= entryIterator->second->response->size();
+	_entryList.erase(entryIterator->second);
+	_entries.erase(entryIterator);
+}
+
+}
+}
@@ -0,0 +1,139 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef RPCRESPONSECACHE_H_
+#define RPCRESPONSECACHE_H_
+
+#include "../Variable.h"
+#include "../Sockets/RpcClientInfo.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace BaseLib
+{
+namespace Rpc
+{
+
+/**
+ * Caches the encoded responses (binary RPC, XML-RPC or JSON-RPC) of read only RPC methods, so repeated calls don't need to create
+ * and encode the result again. Every entry is stored together with a generation. A lookup only hits when the generation passed
+ * matches, so callers pass a value that changes whenever the result might change, e. g. the sum of
+ * DeviceDescription::Devices::getGeneration() and Systems::ICentral::getDescriptionChangeSequence() of all families. Read the
+ * generation before creating the response, so responses created during a change are never returned.
+ *
+ * The class is thread safe.
+ *
+ * Example:
+ *
+ *     std::string key = RpcResponseCache::getKey(clientInfo, methodName, parameters);
+ *     uint64_t generation = getGeneration();
+ *     auto response = cache.get(key, generation);
+ *     if(!response)
+ *     {
+ *         auto data = std::make_shared<std::vector<char>>();
+ *         encoder.encodeResponse(method->invoke(clientInfo, parameters), *data);
+ *         cache.set(key, generation, data);
+ *         response = data;
+ *     }
+ */
+class RpcResponseCache
+{
+public:
+	struct Metrics
+	{
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		size_t entries = 0;
+		size_t bytes = 0;
+	};
+
+	/**
+	 * @param maxSize The maximum total size of all cached responses in bytes. The least recently used responses are removed first.
+	 */
+	explicit RpcResponseCache(size_t maxSize = 8388608);
+	virtual ~RpcResponseCache() = default;
+
+	/**
+	 * Returns true for the read only methods whose results only depend on the device descriptions, the peers and the ACLs of the
+	 * client: listDevices, getParamsetDescription, getDeviceDescription and listKnownDeviceTypes.
+	 */
+	static bool isCacheable(const std::string& methodName);
+
+	/**
+	 * Creates the cache key for a call. It contains the method name, the parameters, the RPC and client type, the language and
+	 * initNewFormat (as they change the encoding or content of the response) and the fingerprint of the client's ACLs.
+	 */
+	static std::string getKey(const PRpcClientInfo& clientInfo, const std::string& methodName, const PArray& parameters);
+
+	/**
+	 * Returns the cached response for "key" or nullptr if there is none for this generation.
+	 */
+	std::shared_ptr<const std::vector<char>> get(const std::string& key, uint64_t generation);
+
+	/**
+	 * Stores a response. Responses larger than the maximum cache size are not stored.
+	 */
+	void set(const std::string& key, uint64_t generation, std::shared_ptr<const std::vector<char>> response);
+
+	void clear();
+
+	Metrics getMetrics();
+private:
+	struct Entry
+	{
+		std::string key;
+		uint64_t generation = 0;
+		std::shared_ptr<const std::vector<char>> response;
+	};
+
+	static const std::unordered_set<std::string> _cacheableMethods;
+
+	size_t _maxSize = 0;
+	std::atomic<uint64_t> _hits{0};
+	std::atomic<uint64_t> _misses{0};
+	std::mutex _entriesMutex;
+	size_t _bytes = 0;
+	std::list<Entry> _entryList; //The most recently used entry first
+	std::unordered_map<std::string, std::list<Entry>::iterator> _entries;
+
+	void remove(std::unordered_map<std::string, std::list<Entry>::iterator>::iterator entryIterator);
+};
+
+}
+}
+
+#endif
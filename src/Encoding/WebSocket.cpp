@@ -31,9 +31,204 @@
 #include "WebSocket.h"
 #include "../HelperFunctions/HelperFunctions.h"
 #include <iostream>
+#include <array>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace BaseLib
 {
+constexpr size_t WebSocket::maxHeaderSize;
+
+PerMessageDeflate::PerMessageDeflate(bool server, const Parameters& parameters, int32_t compressionLevel)
+{
+    int32_t windowBits = server ? parameters.serverMaxWindowBits : parameters.clientMaxWindowBits;
+    //zlib doesn't support raw deflate with a window of 8 bits. negotiate() and parseResponse() don't accept it.
+    if(windowBits < 9 || windowBits > 15) throw WebSocketException("Unsupported window size: " + std::to_string(windowBits));
+    _resetDeflate = server ? parameters.serverNoContextTakeover : parameters.clientNoContextTakeover;
+    _resetInflate = server ? parameters.clientNoContextTakeover : parameters.serverNoContextTakeover;
+
+    if(deflateInit2(&_deflateStream, compressionLevel, Z_DEFLATED, -windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) throw WebSocketException("Could not initialize deflate stream.");
+    //A window of 15 bits can decompress data compressed with any smaller window.
+    if(inflateInit2(&_inflateStream, -15) != Z_OK)
+    {
+        deflateEnd(&_deflateStream);
+        throw WebSocketException("Could not initialize inflate stream.");
+    }
+    _buffer.resize(16384);
+}
+
+PerMessageDeflate::~PerMessageDeflate()
+{
+    deflateEnd(&_deflateStream);
+    inflateEnd(&_inflateStream);
+}
+
+namespace
+{
+    /**
+     * Parses one extension offer of a Sec-WebSocket-Extensions header. Returns false when the offer isn't permessage-deflate or
+     * contains parameters that are unknown, duplicate or invalid.
+     */
+    bool parseDeflateOffer(const std::string& offer, PerMessageDeflate::Parameters& parameters, bool& serverMaxWindowBitsSet, bool& clientMaxWindowBitsSet)
+    {
+        parameters = PerMessageDeflate::Parameters();
+        serverMaxWindowBitsSet = false;
+        clientMaxWindowBitsSet = false;
+        std::vector<std::string> elements = HelperFunctions::splitAll(offer, ';');
+        if(elements.empty()) return false;
+        HelperFunctions::toLower(HelperFunctions::trim(elements.front()));
+        if(elements.front() != "permessage-deflate") return false;
+
+        bool serverNoContextTakeoverSet = false;
+        bool clientNoContextTakeoverSet = false;
+        for(size_t i = 1; i < elements.size(); i++)
+        {
+            std::pair<std::string, std::string> parameter = HelperFunctions::splitFirst(elements[i], '=');
+            HelperFunctions::toLower(HelperFunctions::trim(parameter.first));
+            HelperFunctions::trim(parameter.second);
+            if(parameter.second.size() >= 2 && parameter.second.front() == '"' && parameter.second.back() == '"') parameter.second = parameter.second.substr(1, parameter.second.size() - 2);
+
+            int32_t windowBits = -1;
+            if(!parameter.second.empty())
+            {
+                if(parameter.second.size() > 2 || parameter.second.find_first_not_of("0123456789") != std::string::npos) return false;
+                windowBits = std::stoi(parameter.second);
+                if(windowBits < 8 || windowBits > 15) return false;
+            }
+
+            if(parameter.first == "server_no_context_takeover" && !serverNoContextTakeoverSet && windowBits == -1)
+            {
+                parameters.serverNoContextTakeover = true;
+                serverNoContextTakeoverSet = true;
+            }
+            else if(parameter.first == "client_no_context_takeover" && !clientNoContextTakeoverSet && windowBits == -1)
+            {
+                parameters.clientNoContextTakeover = true;
+                clientNoContextTakeoverSet = true;
+            }
+            else if(parameter.first == "server_max_window_bits" && !serverMaxWindowBitsSet && windowBits != -1)
+            {
+                parameters.serverMaxWindowBits = windowBits;
+                serverMaxWindowBitsSet = true;
+            }
+            else if(parameter.first == "client_max_window_bits" && !clientMaxWindowBitsSet)
+            {
+                if(windowBits != -1) parameters.clientMaxWindowBits = windowBits;
+                clientMaxWindowBitsSet = true;
+            }
+            else return false;
+        }
+        return true;
+    }
+}
+
+bool PerMessageDeflate::negotiate(const std::string& requestHeader, Parameters& parameters, std::string& responseHeader)
+{
+    responseHeader.clear();
+    std::vector<std::string> offers = HelperFunctions::splitAll(requestHeader, ',');
+    for(auto& offer : offers)
+    {
+        Parameters offerParameters;
+        bool serverMaxWindowBitsSet = false;
+        bool clientMaxWindowBitsSet = false;
+        if(!parseDeflateOffer(offer, offerParameters, serverMaxWindowBitsSet, clientMaxWindowBitsSet)) continue;
+        if(offerParameters.serverMaxWindowBits < 9) continue;
+
+        //The client limits its own window only when we send client_max_window_bits. Decompression works with any window size,
+        //so it is never sent.
+        offerParameters.clientMaxWindowBits = 15;
+        parameters = offerParameters;
+        responseHeader = "permessage-deflate";
+        if(parameters.serverNoContextTakeover) responseHeader += "; server_no_context_takeover";
+        if(parameters.clientNoContextTakeover) responseHeader += "; client_no_context_takeover";
+        if(serverMaxWindowBitsSet) responseHeader += "; server_max_window_bits=" + std::to_string(parameters.serverMaxWindowBits);
+        return true;
+    }
+    return false;
+}
+
+std::string PerMessageDeflate::offer()
+{
+    return "permessage-deflate; client_max_window_bits";
+}
+
+bool PerMessageDeflate::parseResponse(const std::string& responseHeader, Parameters& parameters)
+{
+    std::vector<std::string> extensions = HelperFunctions::splitAll(responseHeader, ',');
+    for(auto& extension : extensions)
+    {
+        Parameters responseParameters;
+        bool serverMaxWindowBitsSet = false;
+        bool clientMaxWindowBitsSet = false;
+        if(!parseDeflateOffer(extension, responseParameters, serverMaxWindowBitsSet, clientMaxWindowBitsSet)) continue;
+        if(responseParameters.clientMaxWindowBits < 9) return false;
+        parameters = responseParameters;
+        return true;
+    }
+    return false;
+}
+
+void PerMessageDeflate::compress(const char* data, size_t size, std::vector<char>& output)
+{
+    size_t start = output.size();
+    _deflateStream.next_in = (Bytef*)data;
+    _deflateStream.avail_in = size;
+    do
+    {
+        _deflateStream.next_out = (Bytef*)_buffer.data();
+        _deflateStream.avail_out = _buffer.size();
+        int32_t result = deflate(&_deflateStream, Z_SYNC_FLUSH);
+        if(result != Z_OK && result != Z_BUF_ERROR) throw WebSocketException("Could not compress message: " + std::to_string(result));
+        output.insert(output.end(), _buffer.data(), _buffer.data() + (_buffer.size() - _deflateStream.avail_out));
+    } while(_deflateStream.avail_out == 0);
+    if(_resetDeflate) deflateReset(&_deflateStream);
+
+    //Remove the trailing empty block added by Z_SYNC_FLUSH (RFC 7692 section 7.2.1). An empty message is sent as one 0 byte.
+    if(output.size() - start >= 4 && output[output.size() - 4] == 0 && output[output.size() - 3] == 0 && output[output.size() - 2] == (char)0xFF && output[output.size() - 1] == (char)0xFF) output.resize(output.size() - 4);
+    if(output.size() == start) output.push_back(0);
+}
+
+void PerMessageDeflate::decompress(const char* data, size_t size, std::vector<char>& output, size_t maxSize)
+{
+    static const char emptyBlock[4] = { 0, 0, (char)0xFF, (char)0xFF };
+    size_t start = output.size();
+    bool streamEnd = false;
+    for(int32_t part = 0; part < 2 && !streamEnd; part++)
+    {
+        _inflateStream.next_in = part == 0 ? (Bytef*)data : (Bytef*)emptyBlock;
+        _inflateStream.avail_in = part == 0 ? size : 4;
+        do
+        {
+            _inflateStream.next_out = (Bytef*)_buffer.data();
+            _inflateStream.avail_out = _buffer.size();
+            int32_t result = inflate(&_inflateStream, Z_SYNC_FLUSH);
+            if(result != Z_OK && result != Z_BUF_ERROR && result != Z_STREAM_END)
+            {
+                inflateReset(&_inflateStream);
+                throw WebSocketException("Could not decompress message: " + std::to_string(result));
+            }
+            size_t bytesInflated = _buffer.size() - _inflateStream.avail_out;
+            if(output.size() - start + bytesInflated > maxSize)
+            {
+                inflateReset(&_inflateStream);
+                throw WebSocketException("Decompressed data is larger than " + std::to_string(maxSize) + " bytes.");
+            }
+            output.insert(output.end(), _buffer.data(), _buffer.data() + bytesInflated);
+            if(result == Z_STREAM_END)
+            {
+                streamEnd = true;
+                break;
+            }
+            if(result == Z_BUF_ERROR && bytesInflated == 0) break;
+        } while(_inflateStream.avail_in > 0 || _inflateStream.avail_out == 0);
+    }
+    //A final block ends the stream, so the next message starts a new one.
+    if(_resetInflate || streamEnd) inflateReset(&_inflateStream);
+}
+
 WebSocket::WebSocket()
 {
 }
@@ -53,6 +248,7 @@ void WebSocket::reset()
     _finished = false;
     _dataProcessingStarted = false;
     _oldContentSize = 0;
+    _compressedMessage = false;
 }
 
 uint32_t WebSocket::process(char* buffer, int32_t bufferLength)
@@ -65,13 +261,16 @@ uint32_t WebSocket::process(char* buffer, int32_t bufferLength)
         processedBytes += processHeader(&buffer, bufferLength);
         if(!_header.parsed) return processedBytes;
     }
-    if(_header.length == 0 || _header.rsv1 || _header.rsv2 || _header.rsv3 || (_header.opcode != Header::Opcode::continuation && _header.opcode != Header::Opcode::text  && _header.opcode != Header::Opcode::binary && _header.opcode != Header::Opcode::ping && _header.opcode != Header::Opcode::pong))
+    //RSV1 marks the first frame of a compressed message when permessage-deflate was negotiated.
+    bool compressed = _header.rsv1 && _perMessageDeflate && (_header.opcode == Header::Opcode::text || _header.opcode == Header::Opcode::binary);
+    if(_header.length == 0 || (_header.rsv1 && !compressed) || _header.rsv2 || _header.rsv3 || (_header.opcode != Header::Opcode::continuation && _header.opcode != Header::Opcode::text  && _header.opcode != Header::Opcode::binary && _header.opcode != Header::Opcode::ping && _header.opcode != Header::Opcode::pong))
     {
         _header.close = true;
         _dataProcessingStarted = true;
         setFinished();
         return processedBytes;
     }
+    if(compressed) _compressedMessage = true;
     _dataProcessingStarted = true;
     processedBytes += processContent(buffer, bufferLength);
     return processedBytes;
@@ -163,7 +362,17 @@ uint32_t WebSocket::processContent(char* buffer, int32_t bufferLength)
     if(_content.size() - _oldContentSize == _header.length)
     {
         applyMask();
-        if(_header.fin) _finished = true;
+        if(_header.fin)
+        {
+            if(_compressedMessage)
+            {
+                std::vector<char> decompressedContent;
+                decompressedContent.reserve(_content.size() * 4);
+                _perMessageDeflate->decompress(_content.data(), _content.size(), decompressedContent, 10485760);
+                _content.swap(decompressedContent);
+            }
+            _finished = true;
+        }
         else
         {
             _header.parsed = false;
@@ -175,52 +384,133 @@ uint32_t WebSocket::processContent(char* buffer, int32_t bufferLength)
 
 void WebSocket::applyMask()
 {
-    if(!_header.hasMask) return;
-    for(uint32_t i = _oldContentSize; i < _content.size(); i++)
+    if(!_header.hasMask || _header.maskingKey.size() != 4 || _content.size() <= _oldContentSize) return;
+    //The masking key starts at the first byte of each frame, so continuation frames start at offset 0 again.
+    applyMask(_content.data() + _oldContentSize, _content.size() - _oldContentSize, _header.maskingKey.data());
+}
+
+void WebSocket::applyMask(char* data, size_t size, const char* maskingKey, size_t offset)
+{
+    if(!data || size == 0) return;
+
+    //Rotate the key, so index 0 of the rotated key belongs to data[0].
+    std::array<uint8_t, 4> key{};
+    for(size_t i = 0; i < 4; i++)
+    {
+        key[i] = (uint8_t)maskingKey[(offset + i) & 3];
+    }
+
+    size_t i = 0;
+#ifdef __SSE2__
+    if(size >= 16)
+    {
+        std::array<uint8_t, 16> repeatedKey{};
+        for(size_t j = 0; j < 16; j++)
+        {
+            repeatedKey[j] = key[j & 3];
+        }
+        __m128i mask = _mm_loadu_si128((const __m128i*)repeatedKey.data());
+        for(; i + 16 <= size; i += 16)
+        {
+            __m128i block = _mm_loadu_si128((const __m128i*)(data + i));
+            _mm_storeu_si128((__m128i*)(data + i), _mm_xor_si128(block, mask));
+        }
+    }
+#endif
+    if(size - i >= 8)
+    {
+        std::array<uint8_t, 8> repeatedKey{};
+        for(size_t j = 0; j < 8; j++)
+        {
+            repeatedKey[j] = key[j & 3];
+        }
+        uint64_t mask = 0;
+        std::memcpy(&mask, repeatedKey.data(), 8);
+        for(; i + 8 <= size; i += 8)
+        {
+            uint64_t block = 0;
+            std::memcpy(&block, data + i, 8);
+            block ^= mask;
+            std::memcpy(data + i, &block, 8);
+        }
+    }
+    //i is a multiple of 8 here, so the key index is i & 3.
+    for(; i < size; i++)
+    {
+        data[i] ^= key[i & 3];
+    }
+}
+
+namespace
+{
+    /**
+     * Writes the frame header for a payload of "size" bytes into "header" and returns the header size.
+     */
+    size_t writeHeader(WebSocket::Header::Opcode::Enum messageType, uint64_t size, std::array<char, WebSocket::maxHeaderSize>& header)
     {
-        _content.operator [](i) ^= _header.maskingKey[i % 4];
+        if(messageType == WebSocket::Header::Opcode::continuation) header[0] = 0;
+        else if(messageType == WebSocket::Header::Opcode::text) header[0] = 1;
+        else if(messageType == WebSocket::Header::Opcode::binary) header[0] = 2;
+        else if(messageType == WebSocket::Header::Opcode::close) header[0] = 8;
+        else if(messageType == WebSocket::Header::Opcode::ping) header[0] = 9;
+        else if(messageType == WebSocket::Header::Opcode::pong) header[0] = 10;
+        else throw WebSocketException("Unknown message type.");
+
+        if(messageType != WebSocket::Header::Opcode::continuation) header[0] |= 0x80;
+
+        if(size < 126)
+        {
+            header[1] = (char)size;
+            return 2;
+        }
+        else if(size <= 0xFFFF)
+        {
+            header[1] = 126;
+            header[2] = (char)(size >> 8);
+            header[3] = (char)(size & 0xFF);
+            return 4;
+        }
+        header[1] = 127;
+        for(int32_t i = 0; i < 8; i++)
+        {
+            header[2 + i] = (char)((size >> (56 - (i * 8))) & 0xFF);
+        }
+        return 10;
     }
 }
 
 void WebSocket::encode(const std::vector<char>& data, Header::Opcode::Enum messageType, std::vector<char>& output)
 {
-    output.clear();
-    int32_t lengthBytes = 0;
-    if(data.size() < 126) lengthBytes = 0;
-    else if(data.size() <= 0xFFFF) lengthBytes = 3;
-    else lengthBytes = 9;
-    output.reserve(2 + lengthBytes + data.size());
-    if(messageType == Header::Opcode::continuation) output.push_back(0);
-    else if(messageType == Header::Opcode::text) output.push_back(1);
-    else if(messageType == Header::Opcode::binary) output.push_back(2);
-    else if(messageType == Header::Opcode::close) output.push_back(8);
-    else if(messageType == Header::Opcode::ping) output.push_back(9);
-    else if(messageType == Header::Opcode::pong) output.push_back(10);
-    else throw WebSocketException("Unknown message type.");
-
-    if(messageType != Header::Opcode::continuation) output[0] |= 0x80;
-
-    if(lengthBytes == 0) output.push_back(data.size());
-    else if(lengthBytes == 3)
-    {
-        output.push_back(126);
-        output.push_back(data.size() >> 8);
-        output.push_back(data.size() & 0xFF);
-    }
-    else
+    std::array<char, maxHeaderSize> header{};
+    size_t headerSize = writeHeader(messageType, data.size(), header);
+    output.resize(headerSize + data.size());
+    std::memcpy(output.data(), header.data(), headerSize);
+    if(!data.empty()) std::memcpy(output.data() + headerSize, data.data(), data.size());
+}
+
+void WebSocket::encode(const std::vector<char>& data, Header::Opcode::Enum messageType, std::vector<char>& output, PerMessageDeflate& perMessageDeflate)
+{
+    if(messageType != Header::Opcode::text && messageType != Header::Opcode::binary)
     {
-        output.push_back(127);
-        output.push_back(((uint64_t)data.size()) >> 56);
-        output.push_back((((uint64_t)data.size()) >> 48) & 0xFF);
-        output.push_back((((uint64_t)data.size()) >> 40) & 0xFF);
-        output.push_back((((uint64_t)data.size()) >> 32) & 0xFF);
-        output.push_back((data.size() >> 24) & 0xFF);
-        output.push_back((data.size() >> 16) & 0xFF);
-        output.push_back((data.size() >> 8) & 0xFF);
-        output.push_back(data.size() & 0xFF);
+        encode(data, messageType, output);
+        return;
     }
+    //Compress behind room for the largest header, then move the header in front of the payload.
+    output.resize(maxHeaderSize);
+    perMessageDeflate.compress(data.data(), data.size(), output);
+    size_t start = encodeInPlace(output, messageType);
+    output[start] |= 0x40; //RSV1
+    if(start > 0) output.erase(output.begin(), output.begin() + start);
+}
 
-    if(!data.empty()) output.insert(output.end(), data.begin(), data.end());
+size_t WebSocket::encodeInPlace(std::vector<char>& buffer, Header::Opcode::Enum messageType)
+{
+    if(buffer.size() < maxHeaderSize) throw WebSocketException("Buffer has no room for the header.");
+    std::array<char, maxHeaderSize> header{};
+    size_t headerSize = writeHeader(messageType, buffer.size() - maxHeaderSize, header);
+    size_t start = maxHeaderSize - headerSize;
+    std::memcpy(buffer.data() + start, header.data(), headerSize);
+    return start;
 }
 
 void WebSocket::encodeClose(std::vector<char>& output)
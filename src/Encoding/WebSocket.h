@@ -33,8 +33,11 @@
 
 #include "../Exception.h"
 
+#include <zlib.h>
+
 #include <memory>
 #include <vector>
+#include <string>
 
 namespace BaseLib
 {
@@ -44,6 +47,86 @@ public:
 	WebSocketException(std::string message) : BaseLib::Exception(message) {}
 };
 
+/**
+ * State of the permessage-deflate extension (RFC 7692) for one WebSocket connection. The compression and decompression contexts
+ * are kept between messages unless "no context takeover" was negotiated, so repetitive messages (e. g. JSON events) compress well.
+ *
+ * Server side usage:
+ *
+ *     BaseLib::PerMessageDeflate::Parameters parameters;
+ *     std::string extensionsResponse;
+ *     if(BaseLib::PerMessageDeflate::negotiate(http.getHeader().fields["sec-websocket-extensions"], parameters, extensionsResponse))
+ *     {
+ *         //Add "Sec-WebSocket-Extensions: " + extensionsResponse to the upgrade response.
+ *         auto deflate = std::make_shared<BaseLib::PerMessageDeflate>(true, parameters);
+ *         webSocket.setPerMessageDeflate(deflate);
+ *         //Encode outgoing messages with WebSocket::encode(data, messageType, output, *deflate).
+ *     }
+ */
+class PerMessageDeflate
+{
+public:
+	struct Parameters
+	{
+		bool serverNoContextTakeover = false;
+		bool clientNoContextTakeover = false;
+		int32_t serverMaxWindowBits = 15;
+		int32_t clientMaxWindowBits = 15;
+	};
+
+	/**
+	 * @param server Set to true on the server side of the connection and to false on the client side.
+	 * @param parameters The negotiated parameters.
+	 * @param compressionLevel The zlib compression level.
+	 */
+	PerMessageDeflate(bool server, const Parameters& parameters, int32_t compressionLevel = Z_DEFAULT_COMPRESSION);
+	virtual ~PerMessageDeflate();
+
+	/**
+	 * Server side negotiation. Parses the "Sec-WebSocket-Extensions" header of an upgrade request and accepts the first
+	 * permessage-deflate offer this implementation supports.
+	 *
+	 * @param requestHeader The value of the "Sec-WebSocket-Extensions" request header. Can be empty.
+	 * @param[out] parameters The accepted parameters.
+	 * @param[out] responseHeader The value of the "Sec-WebSocket-Extensions" header to send in the upgrade response.
+	 * @return Returns true when an offer was accepted.
+	 */
+	static bool negotiate(const std::string& requestHeader, Parameters& parameters, std::string& responseHeader);
+
+	/**
+	 * Client side negotiation. Returns the value of the "Sec-WebSocket-Extensions" header to send in the upgrade request.
+	 */
+	static std::string offer();
+
+	/**
+	 * Client side negotiation. Parses the "Sec-WebSocket-Extensions" header of the upgrade response.
+	 *
+	 * @return Returns true when the server accepted permessage-deflate.
+	 */
+	static bool parseResponse(const std::string& responseHeader, Parameters& parameters);
+
+	/**
+	 * Compresses one message and appends the result to "output".
+	 */
+	void compress(const char* data, size_t size, std::vector<char>& output);
+
+	/**
+	 * Decompresses one message and appends the result to "output".
+	 *
+	 * @throws WebSocketException Thrown on invalid data or when the decompressed message is larger than maxSize.
+	 */
+	void decompress(const char* data, size_t size, std::vector<char>& output, size_t maxSize);
+private:
+	z_stream _deflateStream{};
+	z_stream _inflateStream{};
+	bool _resetDeflate = false;
+	bool _resetInflate = false;
+	std::vector<char> _buffer;
+
+	PerMessageDeflate(const PerMessageDeflate&) = delete;
+	PerMessageDeflate& operator=(const PerMessageDeflate&) = delete;
+};
+
 class WebSocket
 {
 public:
@@ -78,6 +161,12 @@ public:
 	 */
 	void setFinished();
 
+	/**
+	 * Enables decompression of messages with the RSV1 bit set. Only call this when permessage-deflate was negotiated for the
+	 * connection. The state is kept by reset(), as it belongs to the connection and not to a message.
+	 */
+	void setPerMessageDeflate(std::shared_ptr<PerMessageDeflate> value) { _perMessageDeflate = value; }
+
 	std::vector<char>& getContent() { return _content; }
 	uint32_t getContentSize() { return _content.size(); }
 	Header& getHeader() { return _header; }
@@ -104,6 +193,43 @@ public:
 	 */
 	static void encode(const std::vector<char>& data, Header::Opcode::Enum messageType, std::vector<char>& output);
 
+	/**
+	 * Encodes and compresses a WebSocket packet. Only text and binary messages are compressed, all other message types are
+	 * encoded like encode() does.
+	 *
+	 * @param[in] data The data to encode
+	 * @param[in] messageType The message type of the packet.
+	 * @param[out] output The WebSocket packet
+	 * @param[in] perMessageDeflate The compression state of the connection.
+	 */
+	static void encode(const std::vector<char>& data, Header::Opcode::Enum messageType, std::vector<char>& output, PerMessageDeflate& perMessageDeflate);
+
+	/**
+	 * The maximum size of the header of an unmasked frame as written by encode() and encodeInPlace().
+	 */
+	static constexpr size_t maxHeaderSize = 10;
+
+	/**
+	 * Encodes a WebSocket packet without copying the payload. The payload must start at index maxHeaderSize of "buffer", so
+	 * reserve room for the header when filling the buffer (e. g. `buffer.resize(WebSocket::maxHeaderSize)` and then append the
+	 * payload). The header is written directly in front of the payload.
+	 *
+	 * @param[in,out] buffer maxHeaderSize bytes of space followed by the payload.
+	 * @param[in] messageType The message type of the packet.
+	 * @return Returns the index in "buffer" the packet starts at. Send buffer.data() + index to buffer.data() + buffer.size().
+	 */
+	static size_t encodeInPlace(std::vector<char>& buffer, Header::Opcode::Enum messageType);
+
+	/**
+	 * XORs data with a WebSocket masking key. Works on 16 bytes (SSE2) or 8 bytes at a time.
+	 *
+	 * @param data The data to mask or unmask.
+	 * @param size The size of data.
+	 * @param maskingKey The 4 byte masking key.
+	 * @param offset The position of data[0] within the frame payload, to continue masking where a previous call stopped.
+	 */
+	static void applyMask(char* data, size_t size, const char* maskingKey, size_t offset = 0);
+
 	/**
 	 * Encodes a WebSocket "close" packet.
 	 *
@@ -117,6 +243,8 @@ private:
 	bool _finished = false;
 	bool _dataProcessingStarted = false;
 	std::vector<char> _rawHeader;
+	std::shared_ptr<PerMessageDeflate> _perMessageDeflate;
+	bool _compressedMessage = false;
 
 	uint32_t processHeader(char** buffer, int32_t& bufferLength);
 	uint32_t processContent(char* buffer, int32_t bufferLength);
@@ -0,0 +1,115 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "ImmutableVariable.h"
+
+#include <stdexcept>
+
+namespace BaseLib
+{
+
+namespace
+{
+	const std::shared_ptr<const Variable>& emptyVariable()
+	{
+		static const std::shared_ptr<const Variable> empty = std::make_shared<const Variable>();
+		return empty;
+	}
+}
+
+ImmutableVariable::ImmutableVariable() : _variable(emptyVariable())
+{
+}
+
+ImmutableVariable::ImmutableVariable(const Variable& variable) : _variable(std::make_shared<const Variable>(variable))
+{
+}
+
+ImmutableVariable::ImmutableVariable(const PVariable& variable) : _variable(variable ? std::make_shared<const Variable>(*variable) : emptyVariable())
+{
+}
+
+ImmutableVariable::ImmutableVariable(const std::shared_ptr<const Variable>& root, const PVariable& node)
+{
+	if(node) _variable = std::shared_ptr<const Variable>(root, node.get());
+	else _variable = emptyVariable();
+}
+
+size_t ImmutableVariable::size() const
+{
+	if(_variable->type == VariableType::tArray) return _variable->arrayValue->size();
+	else if(_variable->type == VariableType::tStruct) return _variable->structValue->size();
+	return 0;
+}
+
+bool ImmutableVariable::contains(const std::string& name) const
+{
+	if(_variable->type != VariableType::tStruct) return false;
+	return _variable->structValue->find(name) != _variable->structValue->end();
+}
+
+ImmutableVariable ImmutableVariable::at(size_t index) const
+{
+	if(_variable->type != VariableType::tArray || index >= _variable->arrayValue->size()) throw std::out_of_range("Array index out of range.");
+	return ImmutableVariable(_variable, _variable->arrayValue->at(index));
+}
+
+ImmutableVariable ImmutableVariable::at(const std::string& name) const
+{
+	if(_variable->type != VariableType::tStruct) throw std::out_of_range("Variable is no struct.");
+	auto memberIterator = _variable->structValue->find(name);
+	if(memberIterator == _variable->structValue->end()) throw std::out_of_range("Struct member not found: " + name);
+	return ImmutableVariable(_variable, memberIterator->second);
+}
+
+void ImmutableVariable::forEachElement(const std::function<void(const ImmutableVariable& element)>& callback) const
+{
+	if(_variable->type != VariableType::tArray) return;
+	for(auto& element : *_variable->arrayValue)
+	{
+		callback(ImmutableVariable(_variable, element));
+	}
+}
+
+void ImmutableVariable::forEachMember(const std::function<void(const std::string& name, const ImmutableVariable& member)>& callback) const
+{
+	if(_variable->type != VariableType::tStruct) return;
+	for(auto& member : *_variable->structValue)
+	{
+		callback(member.first, ImmutableVariable(_variable, member.second));
+	}
+}
+
+PVariable ImmutableVariable::copy() const
+{
+	return std::make_shared<Variable>(*_variable);
+}
+
+}
@@ -0,0 +1,124 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef IMMUTABLEVARIABLE_H_
+#define IMMUTABLEVARIABLE_H_
+
+#include "Variable.h"
+
+#include <functional>
+
+namespace BaseLib
+{
+
+/**
+ * Read-only handle to a Variable tree. The tree is copied once on construction and can't be modified afterwards, so copying the
+ * handle only increments a reference count. Use it to hand the same value to many consumers (e.g. event handlers) without copying
+ * the whole tree for each of them. Call copy() to get a modifiable PVariable.
+ *
+ * Nested values returned by at(), forEachElement() and forEachMember() keep the whole tree alive.
+ */
+class ImmutableVariable
+{
+public:
+	/**
+	 * Creates a handle to an empty variable of type tVoid.
+	 */
+	ImmutableVariable();
+
+	/**
+	 * Copies variable and all nested variables into a new read-only tree.
+	 */
+	explicit ImmutableVariable(const Variable& variable);
+
+	/**
+	 * Copies variable and all nested variables into a new read-only tree. A null pointer results in an empty variable.
+	 */
+	explicit ImmutableVariable(const PVariable& variable);
+
+	VariableType type() const { return _variable->type; }
+	bool errorStruct() const { return _variable->errorStruct; }
+	const std::string& stringValue() const { return _variable->stringValue; }
+	int32_t integerValue() const { return _variable->integerValue; }
+	int64_t integerValue64() const { return _variable->integerValue64; }
+	double floatValue() const { return _variable->floatValue; }
+	bool booleanValue() const { return _variable->booleanValue; }
+	const std::vector<uint8_t>& binaryValue() const { return _variable->binaryValue; }
+
+	/**
+	 * Returns the number of elements for arrays, the number of members for structs and 0 for all other types.
+	 */
+	size_t size() const;
+
+	/**
+	 * Returns true when the variable is a struct with a member called name.
+	 */
+	bool contains(const std::string& name) const;
+
+	/**
+	 * Returns the array element at index. Null elements are returned as an empty variable.
+	 *
+	 * @throws std::out_of_range when index is not smaller than the number of array elements.
+	 */
+	ImmutableVariable at(size_t index) const;
+
+	/**
+	 * Returns the struct member called name. Null members are returned as an empty variable.
+	 *
+	 * @throws std::out_of_range when there is no member called name.
+	 */
+	ImmutableVariable at(const std::string& name) const;
+
+	/**
+	 * Calls callback for every array element in order.
+	 */
+	void forEachElement(const std::function<void(const ImmutableVariable& element)>& callback) const;
+
+	/**
+	 * Calls callback for every struct member in order of the member names.
+	 */
+	void forEachMember(const std::function<void(const std::string& name, const ImmutableVariable& member)>& callback) const;
+
+	/**
+	 * Returns a modifiable deep copy of the variable.
+	 */
+	PVariable copy() const;
+private:
+	/**
+	 * Points to a node of the read-only tree. Nested nodes share ownership of the root.
+	 */
+	std::shared_ptr<const Variable> _variable;
+
+	ImmutableVariable(const std::shared_ptr<const Variable>& root, const PVariable& node);
+};
+
+}
+
+#endif
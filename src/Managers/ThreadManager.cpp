@@ -31,11 +31,43 @@
 #include "../BaseLib.h"
 #include "ThreadManager.h"
 
+#include <deque>
+#include <condition_variable>
+
 namespace BaseLib
 {
 
 bool _stopThreadCountTest = false;
 
+struct ThreadManager::ThreadPoolWorker
+{
+	ThreadPoolLaneData* lane = nullptr;
+	std::mutex queueMutex;
+	std::deque<std::function<void()>> queue;
+	std::thread thread;
+};
+
+struct ThreadManager::ThreadPoolLaneData
+{
+	std::vector<std::unique_ptr<ThreadPoolWorker>> workers;
+	std::atomic<uint32_t> nextWorker{0};
+	std::atomic<uint64_t> queueSize{0};
+	std::atomic<uint64_t> maxQueueSize{0};
+	std::atomic<uint64_t> processedTasks{0};
+	std::atomic<uint64_t> stolenTasks{0};
+	std::mutex waitMutex;
+	std::condition_variable conditionVariable;
+	bool stop = false;
+};
+
+namespace
+{
+/**
+ * The thread pool worker executing the current thread or nullptr.
+ */
+thread_local void* _currentThreadPoolWorker = nullptr;
+}
+
 void* threadCountTest(void*)
 {
     while(!_stopThreadCountTest)
@@ -51,6 +83,7 @@ ThreadManager::ThreadManager()
 
 ThreadManager::~ThreadManager()
 {
+	stopThreadPool();
 }
 
 void ThreadManager::init(BaseLib::SharedObjects* baseLib, bool testMaxThreadCount)
@@ -181,6 +214,229 @@ void ThreadManager::setThreadPriority(pthread_t thread, int32_t priority, int32_
     }
 }
 
+bool ThreadManager::startThreadPool(uint32_t highPriorityThreads, uint32_t normalThreads, uint32_t lowPriorityThreads)
+{
+	try
+	{
+		std::lock_guard<std::mutex> threadPoolGuard(_threadPoolMutex);
+		if(_threadPoolRunning) return true;
+		uint32_t threadCount = highPriorityThreads + normalThreads + lowPriorityThreads;
+		if(_maxThreadCount != 0 && getCurrentThreadCount() + (signed)threadCount >= (signed)_maxThreadCount * 90 / 100)
+		{
+			_bl->out.printCritical("Critical: Can't start thread pool. 90% of thread limit would be reached.");
+			return false;
+		}
+
+		std::array<uint32_t, 3> laneThreadCounts{ { highPriorityThreads, normalThreads, lowPriorityThreads } };
+		for(int32_t lane = 0; lane < (signed)_threadPoolLanes.size(); lane++)
+		{
+			_threadPoolLanes[lane].reset(new ThreadPoolLaneData());
+			for(uint32_t i = 0; i < laneThreadCounts[lane]; i++)
+			{
+				std::unique_ptr<ThreadPoolWorker> worker(new ThreadPoolWorker());
+				worker->lane = _threadPoolLanes[lane].get();
+				_threadPoolLanes[lane]->workers.push_back(std::move(worker));
+			}
+		}
+
+		//Start the threads after all queues exist, because workers access the queues of the other workers.
+		for(int32_t lane = 0; lane < (signed)_threadPoolLanes.size(); lane++)
+		{
+			auto& laneData = _threadPoolLanes[lane];
+			for(uint32_t i = 0; i < laneData->workers.size(); i++)
+			{
+				auto& worker = laneData->workers[i];
+				worker->thread = std::thread(&ThreadManager::threadPoolWorker, this, laneData.get(), i);
+				registerThread();
+				if(lane == ThreadPoolLane::high) setThreadPriority(worker->thread.native_handle(), 45, SCHED_FIFO);
+#ifdef SCHED_IDLE
+				else if(lane == ThreadPoolLane::low) setThreadPriority(worker->thread.native_handle(), 0, SCHED_IDLE);
+#endif
+			}
+		}
+		_threadPoolRunning = true;
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return false;
+}
+
+void ThreadManager::stopThreadPool()
+{
+	try
+	{
+		std::array<std::unique_ptr<ThreadPoolLaneData>, 3> lanes;
+		{
+			std::lock_guard<std::mutex> threadPoolGuard(_threadPoolMutex);
+			if(!_threadPoolRunning) return;
+			_threadPoolRunning = false;
+			//Wait for running calls of enqueue
+			while(_threadPoolSubmitters > 0) std::this_thread::yield();
+
+			for(uint32_t i = 0; i < _threadPoolLanes.size(); i++)
+			{
+				{
+					std::lock_guard<std::mutex> waitGuard(_threadPoolLanes[i]->waitMutex);
+					_threadPoolLanes[i]->stop = true;
+				}
+				_threadPoolLanes[i]->conditionVariable.notify_all();
+				lanes[i] = std::move(_threadPoolLanes[i]);
+			}
+		}
+
+		//Join without holding _threadPoolMutex, as the remaining tasks might call methods locking it (e. g. getThreadPoolMetrics()).
+		for(auto& lane : lanes)
+		{
+			for(auto& worker : lane->workers)
+			{
+				if(worker->thread.joinable())
+				{
+					worker->thread.join();
+					unregisterThread();
+				}
+			}
+			lane.reset();
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void ThreadManager::enqueue(ThreadPoolLane::Enum lane, std::function<void()> task)
+{
+	_threadPoolSubmitters++;
+	if(!_threadPoolRunning)
+	{
+		_threadPoolSubmitters--;
+		throw Exception("Thread pool is not running.");
+	}
+
+	ThreadPoolLaneData* laneData = _threadPoolLanes.at(lane).get();
+	if(laneData->workers.empty())
+	{
+		_threadPoolSubmitters--;
+		throw Exception("Thread pool lane " + std::to_string(lane) + " has no worker threads.");
+	}
+
+	//Tasks submitted by a worker are queued in the worker's own queue.
+	ThreadPoolWorker* worker = (ThreadPoolWorker*)_currentThreadPoolWorker;
+	if(!worker || worker->lane != laneData) worker = laneData->workers[laneData->nextWorker++ % laneData->workers.size()].get();
+
+	uint64_t queueSize = 0;
+	{
+		//Increment while holding the queue lock. Workers can only take the task after that, so the counter never underflows and
+		//never counts tasks that aren't queued yet.
+		std::lock_guard<std::mutex> queueGuard(worker->queueMutex);
+		worker->queue.push_back(std::move(task));
+		queueSize = ++laneData->queueSize;
+	}
+	uint64_t maxQueueSize = laneData->maxQueueSize;
+	while(queueSize > maxQueueSize && !laneData->maxQueueSize.compare_exchange_weak(maxQueueSize, queueSize))
+	{
+	}
+
+	{
+		std::lock_guard<std::mutex> waitGuard(laneData->waitMutex);
+	}
+	laneData->conditionVariable.notify_one();
+	_threadPoolSubmitters--;
+}
+
+void ThreadManager::threadPoolWorker(ThreadPoolLaneData* lane, uint32_t index)
+{
+	ThreadPoolWorker* worker = lane->workers.at(index).get();
+	_currentThreadPoolWorker = worker;
+	while(true)
+	{
+		std::function<void()> task;
+		bool stolen = false;
+
+		{
+			std::lock_guard<std::mutex> queueGuard(worker->queueMutex);
+			if(!worker->queue.empty())
+			{
+				task = std::move(worker->queue.front());
+				worker->queue.pop_front();
+			}
+		}
+
+		if(!task)
+		{
+			//Steal from the back of the other queues of the lane.
+			for(uint32_t i = 1; i < lane->workers.size() && !task; i++)
+			{
+				ThreadPoolWorker* victim = lane->workers[(index + i) % lane->workers.size()].get();
+				std::lock_guard<std::mutex> queueGuard(victim->queueMutex);
+				if(!victim->queue.empty())
+				{
+					task = std::move(victim->queue.back());
+					victim->queue.pop_back();
+					stolen = true;
+				}
+			}
+		}
+
+		if(task)
+		{
+			lane->queueSize--;
+			try
+			{
+				task();
+			}
+			catch(const std::exception& ex)
+			{
+				_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+			}
+			catch(...)
+			{
+				_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+			}
+			lane->processedTasks++;
+			if(stolen) lane->stolenTasks++;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> waitLock(lane->waitMutex);
+		lane->conditionVariable.wait(waitLock, [&] { return lane->stop || lane->queueSize > 0; });
+		if(lane->stop && lane->queueSize == 0) break;
+	}
+	_currentThreadPoolWorker = nullptr;
+}
+
+bool ThreadManager::isThreadPoolWorker()
+{
+	return _currentThreadPoolWorker != nullptr;
+}
+
+uint64_t ThreadManager::getThreadPoolQueueSize(ThreadPoolLane::Enum lane)
+{
+	std::lock_guard<std::mutex> threadPoolGuard(_threadPoolMutex);
+	if(!_threadPoolRunning) return 0;
+	return _threadPoolLanes.at(lane)->queueSize;
+}
+
+std::array<ThreadManager::ThreadPoolLaneMetrics, 3> ThreadManager::getThreadPoolMetrics()
+{
+	std::array<ThreadPoolLaneMetrics, 3> metrics;
+	std::lock_guard<std::mutex> threadPoolGuard(_threadPoolMutex);
+	if(!_threadPoolRunning) return metrics;
+	for(uint32_t i = 0; i < _threadPoolLanes.size(); i++)
+	{
+		auto& lane = _threadPoolLanes[i];
+		metrics[i].threadCount = lane->workers.size();
+		metrics[i].queueSize = lane->queueSize;
+		metrics[i].maxQueueSize = lane->maxQueueSize;
+		metrics[i].processedTasks = lane->processedTasks;
+		metrics[i].stolenTasks = lane->stolenTasks;
+	}
+	return metrics;
+}
+
 void ThreadManager::join(std::thread& thread)
 {
 	if(thread.joinable())
@@ -35,6 +35,12 @@
 #include "../Output/Output.h"
 #include <mutex>
 #include <thread>
+#include <future>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <array>
+#include <atomic>
 
 namespace BaseLib
 {
@@ -44,6 +50,32 @@ class SharedObjects;
 class ThreadManager
 {
 public:
+	/**
+	 * The priority lanes of the thread pool. Each lane has its own worker threads which are started with the
+	 * scheduling policy noted below.
+	 */
+	struct ThreadPoolLane
+	{
+		enum Enum
+		{
+			high = 0, //!< SCHED_FIFO with priority 45
+			normal = 1, //!< SCHED_OTHER
+			low = 2 //!< SCHED_IDLE if available, SCHED_OTHER otherwise
+		};
+	};
+
+	/**
+	 * Statistics of one thread pool lane.
+	 */
+	struct ThreadPoolLaneMetrics
+	{
+		uint32_t threadCount = 0;
+		uint64_t queueSize = 0;
+		uint64_t maxQueueSize = 0;
+		uint64_t processedTasks = 0;
+		uint64_t stolenTasks = 0;
+	};
+
 	ThreadManager();
 	virtual ~ThreadManager();
 	void init(BaseLib::SharedObjects* baseLib, bool testMaxThreadCount);
@@ -73,6 +105,74 @@ public:
 		return true;
 	}
 
+	/**
+	 * Starts the worker threads of the thread pool. The worker threads are counted against the maximum thread
+	 * count. Calling this method while the pool is running does nothing.
+	 *
+	 * @param highPriorityThreads The number of worker threads of the high priority lane.
+	 * @param normalThreads The number of worker threads of the normal lane.
+	 * @param lowPriorityThreads The number of worker threads of the low priority lane.
+	 * @return Returns false when the threads could not be started because of the thread limit.
+	 */
+	bool startThreadPool(uint32_t highPriorityThreads, uint32_t normalThreads, uint32_t lowPriorityThreads);
+
+	/**
+	 * Executes all queued tasks and stops the worker threads of the thread pool.
+	 */
+	void stopThreadPool();
+
+	/**
+	 * Returns true when the thread pool is running.
+	 */
+	bool threadPoolRunning() { return _threadPoolRunning; }
+
+	/**
+	 * Returns true when the calling thread is a worker thread of the thread pool. Tasks running in the pool must not
+	 * block on other tasks of the pool.
+	 */
+	bool isThreadPoolWorker();
+
+	/**
+	 * Queues a task in the thread pool. Each worker thread has its own queue. Idle workers steal tasks from the other
+	 * workers of the same lane. Use the thread pool for short-lived tasks instead of starting a new thread.
+	 *
+	 * @param lane The lane to execute the task in.
+	 * @param function The function to execute.
+	 * @param args The arguments to call the function with.
+	 * @return Returns a future to wait for the task and to get its result. Exceptions thrown by the task are stored in the future.
+	 * @throws Exception Thrown when the thread pool is not running or the lane has no worker threads.
+	 */
+	template<typename Function, typename... Args>
+	std::future<typename std::result_of<Function(Args...)>::type> submit(ThreadPoolLane::Enum lane, Function&& function, Args&&... args)
+	{
+		typedef typename std::result_of<Function(Args...)>::type ResultType;
+		auto task = std::make_shared<std::packaged_task<ResultType()>>(std::bind(std::forward<Function>(function), std::forward<Args>(args)...));
+		std::future<ResultType> result = task->get_future();
+		enqueue(lane, [task]() { (*task)(); });
+		return result;
+	}
+
+	/**
+	 * Queues a task in the normal lane of the thread pool.
+	 *
+	 * @see submit(ThreadPoolLane::Enum, Function&&, Args&&...)
+	 */
+	template<typename Function, typename... Args>
+	std::future<typename std::result_of<Function(Args...)>::type> submit(Function&& function, Args&&... args)
+	{
+		return submit(ThreadPoolLane::normal, std::forward<Function>(function), std::forward<Args>(args)...);
+	}
+
+	/**
+	 * Returns the number of queued tasks in a lane.
+	 */
+	uint64_t getThreadPoolQueueSize(ThreadPoolLane::Enum lane);
+
+	/**
+	 * Returns the statistics of all lanes. The index is the value of ThreadPoolLane::Enum.
+	 */
+	std::array<ThreadPoolLaneMetrics, 3> getThreadPoolMetrics();
+
 	void join(std::thread& thread);
 
 	void registerThread();
@@ -91,6 +191,17 @@ protected:
 
     bool checkThreadCount(bool highPriority);
 private:
+	struct ThreadPoolWorker;
+	struct ThreadPoolLaneData;
+
+	std::mutex _threadPoolMutex;
+	std::atomic_bool _threadPoolRunning{false};
+	std::atomic<uint32_t> _threadPoolSubmitters{0};
+	std::array<std::unique_ptr<ThreadPoolLaneData>, 3> _threadPoolLanes;
+
+	void enqueue(ThreadPoolLane::Enum lane, std::function<void()> task);
+	void threadPoolWorker(ThreadPoolLaneData* lane, uint32_t index);
+
 	ThreadManager(const ThreadManager&) = delete;
     ThreadManager& operator=(const ThreadManager&) = delete;
 };
@@ -34,10 +34,162 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <list>
+#include <algorithm>
 
 namespace BaseLib
 {
+
+namespace
+{
+/**
+ * Single producer, single consumer ring buffer holding the queued messages of one thread.
+ */
+class OutputBuffer
+{
+public:
+	struct Entry
+	{
+		int64_t time = 0;
+		bool errorStream = false;
+		std::string message;
+	};
+
+	explicit OutputBuffer(uint32_t size) : _entries(size) {}
+
+	/**
+	 * Called by the owning thread only.
+	 *
+	 * @return Returns false when the buffer is full. The message is dropped in this case.
+	 */
+	bool push(std::string& message, int64_t time, bool errorStream)
+	{
+		uint64_t head = _head.load(std::memory_order_relaxed);
+		if(head - _tail.load(std::memory_order_acquire) >= _entries.size())
+		{
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		Entry& entry = _entries[head % _entries.size()];
+		entry.time = time;
+		entry.errorStream = errorStream;
+		entry.message = std::move(message);
+		_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/**
+	 * Called by the writer thread only.
+	 */
+	void pop(std::vector<Entry>& entries)
+	{
+		uint64_t tail = _tail.load(std::memory_order_relaxed);
+		uint64_t head = _head.load(std::memory_order_acquire);
+		for(; tail < head; tail++)
+		{
+			entries.push_back(std::move(_entries[tail % _entries.size()]));
+		}
+		_tail.store(tail, std::memory_order_release);
+	}
+
+	uint64_t takeDropped() { return _dropped.exchange(0, std::memory_order_relaxed); }
+	bool empty() { return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_relaxed); }
+
+	std::atomic_bool threadFinished{false};
+private:
+	std::vector<Entry> _entries;
+	std::atomic<uint64_t> _head{0};
+	std::atomic<uint64_t> _tail{0};
+	std::atomic<uint64_t> _dropped{0};
+};
+
+/**
+ * Marks the buffer of a thread as finished when the thread exits, so the writer thread can remove it.
+ */
+struct ThreadOutputBuffer
+{
+	std::shared_ptr<OutputBuffer> buffer;
+	uint32_t generation = 0;
+
+	~ThreadOutputBuffer()
+	{
+		if(buffer) buffer->threadFinished = true;
+	}
+};
+
+std::mutex _outputBuffersMutex;
+std::list<std::shared_ptr<OutputBuffer>> _outputBuffers;
+uint32_t _outputBufferSize = 1024;
+std::atomic<uint32_t> _outputBufferGeneration{0};
+/**
+ * Number of threads currently queueing a message. stopAsynchronousOutput waits for them before the final drain.
+ */
+std::atomic<uint32_t> _outputSubmitters{0};
+std::mutex _writerThreadMutex;
+std::thread _writerThread;
+std::atomic_bool _stopWriterThread{false};
+std::mutex _writerWaitMutex;
+std::condition_variable _writerConditionVariable;
+
+thread_local ThreadOutputBuffer _threadOutputBuffer;
+
+/**
+ * Caches the formatted date and time of the current second, so localtime_r and strftime are only called once per
+ * second and thread.
+ */
+struct TimeStringCache
+{
+	int64_t second = -1;
+	char string[50];
+	size_t size = 0;
+};
+
+thread_local TimeStringCache _timeStringCache;
+
+void appendTimeString(std::string& output, int64_t time)
+{
+	int64_t second = time / 1000;
+	int32_t milliseconds = time % 1000;
+	TimeStringCache& cache = _timeStringCache;
+	if(second != cache.second)
+	{
+		std::time_t t = std::time_t(second);
+		std::tm localTime;
+		localtime_r(&t, &localTime);
+		cache.size = strftime(&cache.string[0], sizeof(cache.string), "%x %X", &localTime);
+		cache.second = second;
+	}
+	output.append(cache.string, cache.size);
+	output.push_back('.');
+	output.push_back('0' + (milliseconds / 100));
+	output.push_back('0' + ((milliseconds / 10) % 10));
+	output.push_back('0' + (milliseconds % 10));
+}
+
+int64_t getTimeMilliseconds()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+}
+
 std::mutex Output::_outputMutex;
+std::atomic_bool Output::_asynchronous{false};
+std::atomic<uint64_t> Output::_droppedMessages{0};
+
+namespace
+{
+/**
+ * Stops the writer thread on process exit, so queued messages are written and the thread object is not destroyed while
+ * still joinable.
+ */
+struct AsynchronousOutputGuard
+{
+	~AsynchronousOutputGuard()
+	{
+		Output::stopAsynchronousOutput();
+	}
+} _asynchronousOutputGuard;
+}
 
 std::function<void(int32_t, std::string)>* Output::getErrorCallback()
 {
@@ -65,27 +217,150 @@ void Output::init(SharedObjects* baseLib)
 
 std::string Output::getTimeString(int64_t time)
 {
-	const char timeFormat[] = "%x %X";
-	std::time_t t;
-	int32_t milliseconds;
-	if(time > 0)
+	std::string timeString;
+	timeString.reserve(32);
+	appendTimeString(timeString, time > 0 ? time : getTimeMilliseconds());
+	return timeString;
+}
+
+void Output::startAsynchronousOutput(uint32_t bufferSize, uint32_t flushInterval)
+{
+	std::lock_guard<std::mutex> writerThreadGuard(_writerThreadMutex);
+	if(_asynchronous) return;
+	if(bufferSize == 0) bufferSize = 1;
+	if(flushInterval == 0) flushInterval = 1;
 	{
-		t = std::time_t(time / 1000);
-		milliseconds = time % 1000;
+		std::lock_guard<std::mutex> outputBuffersGuard(_outputBuffersMutex);
+		_outputBufferSize = bufferSize;
+		_outputBuffers.clear();
 	}
-	else
+	//Forces all threads to create new buffers with the new size
+	_outputBufferGeneration++;
+	_stopWriterThread = false;
+	_writerThread = std::thread([flushInterval]()
+	{
+		std::vector<OutputBuffer::Entry> entries;
+		std::vector<std::shared_ptr<OutputBuffer>> buffers;
+		std::string outputBatch;
+		std::string errorBatch;
+		bool stop = false;
+		while(!stop)
+		{
+			{
+				std::unique_lock<std::mutex> waitLock(_writerWaitMutex);
+				_writerConditionVariable.wait_for(waitLock, std::chrono::milliseconds(flushInterval), [&]{ return (bool)_stopWriterThread; });
+			}
+			stop = _stopWriterThread;
+
+			buffers.clear();
+			{
+				std::lock_guard<std::mutex> outputBuffersGuard(_outputBuffersMutex);
+				buffers.insert(buffers.end(), _outputBuffers.begin(), _outputBuffers.end());
+			}
+
+			entries.clear();
+			uint64_t dropped = 0;
+			for(auto& buffer : buffers)
+			{
+				buffer->pop(entries);
+				dropped += buffer->takeDropped();
+			}
+			if(entries.empty() && dropped == 0) continue;
+
+			//Restore global order, as each thread has its own buffer
+			std::stable_sort(entries.begin(), entries.end(), [](const OutputBuffer::Entry& a, const OutputBuffer::Entry& b) { return a.time < b.time; });
+
+			outputBatch.clear();
+			errorBatch.clear();
+			for(auto& entry : entries)
+			{
+				size_t lineStart = outputBatch.size();
+				if(entry.time > 0)
+				{
+					appendTimeString(outputBatch, entry.time);
+					outputBatch.push_back(' ');
+				}
+				outputBatch.append(entry.message);
+				outputBatch.push_back('\n');
+				if(entry.errorStream) errorBatch.append(outputBatch, lineStart, std::string::npos);
+			}
+			if(dropped > 0)
+			{
+				_droppedMessages += dropped;
+				appendTimeString(outputBatch, getTimeMilliseconds());
+				outputBatch.append(" Warning: " + std::to_string(dropped) + " log messages were dropped, because the output could not keep up.\n");
+			}
+
+			{
+				std::lock_guard<std::mutex> outputGuard(_outputMutex);
+				std::cout.write(outputBatch.data(), outputBatch.size());
+				std::cout.flush();
+				if(!errorBatch.empty())
+				{
+					std::cerr.write(errorBatch.data(), errorBatch.size());
+					std::cerr.flush();
+				}
+			}
+
+			std::lock_guard<std::mutex> outputBuffersGuard(_outputBuffersMutex);
+			_outputBuffers.remove_if([](const std::shared_ptr<OutputBuffer>& buffer) { return buffer->threadFinished && buffer->empty(); });
+		}
+	});
+	_asynchronous = true;
+}
+
+void Output::stopAsynchronousOutput()
+{
+	std::lock_guard<std::mutex> writerThreadGuard(_writerThreadMutex);
+	if(!_asynchronous) return;
+	_asynchronous = false;
+	//Threads that saw _asynchronous before it was cleared are still queueing. Their messages need to be in the buffers before the writer's final drain.
+	while(_outputSubmitters > 0) std::this_thread::yield();
 	{
-		const auto timePoint = std::chrono::system_clock::now();
-		t = std::chrono::system_clock::to_time_t(timePoint);
-		milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(timePoint.time_since_epoch()).count() % 1000;
+		std::lock_guard<std::mutex> waitGuard(_writerWaitMutex);
+		_stopWriterThread = true;
 	}
-	char timeString[50];
-	std::tm localTime;
-	localtime_r(&t, &localTime);
-	strftime(&timeString[0], 50, &timeFormat[0], &localTime);
-	std::ostringstream timeStream;
-	timeStream << timeString << "." << std::setw(3) << std::setfill('0') << milliseconds;
-	return timeStream.str();
+	_writerConditionVariable.notify_one();
+	if(_writerThread.joinable()) _writerThread.join();
+	std::lock_guard<std::mutex> outputBuffersGuard(_outputBuffersMutex);
+	_outputBuffers.clear();
+}
+
+void Output::writeLine(std::string message, int64_t time, bool errorStream)
+{
+	if(_asynchronous)
+	{
+		//Register first and check again, so stopAsynchronousOutput either waits for this message or it is written synchronously.
+		_outputSubmitters++;
+		if(_asynchronous)
+		{
+			ThreadOutputBuffer& threadBuffer = _threadOutputBuffer;
+			uint32_t generation = _outputBufferGeneration;
+			if(!threadBuffer.buffer || threadBuffer.generation != generation)
+			{
+				std::lock_guard<std::mutex> outputBuffersGuard(_outputBuffersMutex);
+				threadBuffer.buffer = std::make_shared<OutputBuffer>(_outputBufferSize);
+				threadBuffer.generation = generation;
+				_outputBuffers.push_back(threadBuffer.buffer);
+			}
+			threadBuffer.buffer->push(message, time, errorStream);
+			_outputSubmitters--;
+			return;
+		}
+		_outputSubmitters--;
+	}
+
+	std::string line;
+	line.reserve(message.size() + 32);
+	if(time > 0)
+	{
+		appendTimeString(line, time);
+		line.push_back(' ');
+	}
+	line.append(message);
+	std::lock_guard<std::mutex> outputGuard(_outputMutex);
+	std::cout << line << std::endl;
+	if(errorStream) std::cerr << line << std::endl;
 }
 
 void Output::printThreadPriority()
@@ -116,8 +391,7 @@ void Output::printBinary(std::vector<unsigned char>& data)
 			stringstream << std::setw(2) << (int32_t)((uint8_t)(*i));
 		}
 		stringstream << std::dec;
-		std::lock_guard<std::mutex> outputGuard(_outputMutex);
-		std::cout << stringstream.str() << std::endl;
+		writeLine(stringstream.str(), 0, false);
 	}
 	catch(const std::exception& ex)
     {
@@ -137,8 +411,7 @@ void Output::printBinary(std::shared_ptr<std::vector<char>> data)
 			stringstream << std::setw(2) << (int32_t)((uint8_t)(*i));
 		}
 		stringstream << std::dec;
-		std::lock_guard<std::mutex> outputGuard(_outputMutex);
-		std::cout << stringstream.str() << std::endl;
+		writeLine(stringstream.str(), 0, false);
 	}
 	catch(const std::exception& ex)
     {
@@ -158,8 +431,7 @@ void Output::printBinary(std::vector<char>& data)
 			stringstream << std::setw(2) << (int32_t)((uint8_t)(*i));
 		}
 		stringstream << std::dec;
-		std::lock_guard<std::mutex> outputGuard(_outputMutex);
-		std::cout << stringstream.str() << std::endl;
+		writeLine(stringstream.str(), 0, false);
 	}
 	catch(const std::exception& ex)
     {
@@ -171,20 +443,9 @@ void Output::printEx(std::string file, uint32_t line, std::string function, std:
 {
 	if(_bl && _bl->debugLevel < 2) return;
 	std::string error;
-	if(!what.empty())
-	{
-		error = _prefix + "Error in file " + file + " line " + std::to_string(line) + " in function " + function + ": " + what;
-		std::lock_guard<std::mutex> outputGuard(_outputMutex);
-		std::cout << getTimeString() << " " << error << std::endl;
-		std::cerr << getTimeString() << " " << error << std::endl;
-	}
-	else
-	{
-		error = _prefix + "Unknown error in file " + file + " line " + std::to_string(line) + " in function " + function + ".";
-		std::lock_guard<std::mutex> outputGuard(_outputMutex);
-		std::cout << getTimeString() << " " << error << std::endl;
-		std::cerr << getTimeString() << " " << error << std::endl;
-	}
+	if(!what.empty()) error = _prefix + "Error in file " + file + " line " + std::to_string(line) + " in function " + function + ": " + what;
+	else error = _prefix + "Unknown error in file " + file + " line " + std::to_string(line) + " in function " + function + ".";
+	writeLine(error, getTimeMilliseconds(), true);
 	if(_errorCallback && *_errorCallback) (*_errorCallback)(2, error);
 }
 
@@ -192,11 +453,7 @@ void Output::printCritical(std::string errorString, bool errorCallback)
 {
 	if(_bl && _bl->debugLevel < 1) return;
 	std::string error = _prefix + errorString;
-	{
-    	std::lock_guard<std::mutex> outputGuard(_outputMutex);
-    	std::cout << getTimeString() << " " << error << std::endl;
-    	std::cerr << getTimeString() << " " << error << std::endl;
-	}
+	writeLine(error, getTimeMilliseconds(), true);
 	if(_errorCallback && *_errorCallback && errorCallback) (*_errorCallback)(1, error);
 }
 
@@ -204,11 +461,7 @@ void Output::printError(std::string errorString)
 {
 	if(_bl && _bl->debugLevel < 2) return;
 	std::string error = _prefix + errorString;
-	{
-    	std::lock_guard<std::mutex> outputGuard(_outputMutex);
-    	std::cout << getTimeString() << " " << error << std::endl;
-    	std::cerr << getTimeString() << " " << error << std::endl;
-	}
+	writeLine(error, getTimeMilliseconds(), true);
 	if(_errorCallback && *_errorCallback) (*_errorCallback)(2, error);
 }
 
@@ -216,40 +469,38 @@ void Output::printWarning(std::string errorString)
 {
 	if(_bl && _bl->debugLevel < 3) return;
 	std::string error = _prefix + errorString;
-	{
-	    std::lock_guard<std::mutex> outputGuard(_outputMutex);
-    	std::cout << getTimeString() << " " << error << std::endl;
-    	std::cerr << getTimeString() << " " << error << std::endl;
-	}
+	writeLine(error, getTimeMilliseconds(), true);
 	if(_errorCallback && *_errorCallback) (*_errorCallback)(3, error);
 }
 
+bool Output::enabled(int32_t minDebugLevel)
+{
+	return !_bl || _bl->debugLevel >= minDebugLevel;
+}
+
 void Output::printInfo(std::string message)
 {
 	if(_bl && _bl->debugLevel < 4) return;
-	std::lock_guard<std::mutex> outputGuard(_outputMutex);
-	std::cout << getTimeString() << " " << _prefix << message << std::endl;
+	writeLine(_prefix + message, getTimeMilliseconds(), false);
 }
 
 void Output::printDebug(std::string message, int32_t minDebugLevel)
 {
 	if(_bl && _bl->debugLevel < minDebugLevel) return;
-	std::lock_guard<std::mutex> outputGuard(_outputMutex);
-	std::cout << getTimeString() << " " << _prefix << message << std::endl;
+	writeLine(_prefix + message, getTimeMilliseconds(), false);
 }
 
 void Output::printMessage(std::string message, int32_t minDebugLevel, bool errorLog)
 {
 	if(_bl && _bl->debugLevel < minDebugLevel) return;
 	message = _prefix + message;
-	std::unique_lock<std::mutex> outputGuard(_outputMutex);
-	std::cout << getTimeString() << " " << message << std::endl;
-	if(minDebugLevel <= 3 && errorLog)
+	bool errorStream = minDebugLevel <= 3 && errorLog;
+	if(errorStream)
 	{
-		std::cerr << getTimeString() << " " << message << std::endl;
-		outputGuard.unlock();
+		writeLine(message, getTimeMilliseconds(), true);
 		if(_errorCallback && *_errorCallback) (*_errorCallback)(3, message);
 	}
+	else writeLine(std::move(message), getTimeMilliseconds(), false);
 }
 
 }
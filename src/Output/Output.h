@@ -41,6 +41,9 @@
 #include <ctime>
 #include <mutex>
 #include <functional>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 
 namespace BaseLib
 {
@@ -112,6 +115,32 @@ public:
 	 */
 	static std::string getTimeString(int64_t time = 0);
 
+	/**
+	 * Switches all Output objects of the process to asynchronous mode. In asynchronous mode every thread writes its
+	 * messages into its own lock-free ring buffer. A single writer thread drains the buffers and writes the messages
+	 * in batches. When a thread's buffer is full, new messages of that thread are dropped and the number of dropped
+	 * messages is printed once the writer catches up.
+	 *
+	 * @param bufferSize The maximum number of queued messages per thread.
+	 * @param flushInterval The maximum time in milliseconds the writer thread waits before writing queued messages.
+	 */
+	static void startAsynchronousOutput(uint32_t bufferSize = 1024, uint32_t flushInterval = 10);
+
+	/**
+	 * Writes all queued messages, stops the writer thread and switches back to synchronous mode.
+	 */
+	static void stopAsynchronousOutput();
+
+	/**
+	 * Returns "true" when asynchronous output is enabled.
+	 */
+	static bool asynchronousOutput() { return _asynchronous; }
+
+	/**
+	 * Returns the number of messages dropped in asynchronous mode since the start of the process.
+	 */
+	static uint64_t droppedMessages() { return _droppedMessages; }
+
 	/**
 	 * Prints the provided binary data as a hexadecimal string.
 	 *
@@ -205,6 +234,47 @@ public:
 	 */
 	void printDebug(std::string message, int32_t minDebugLevel = 5);
 
+	/**
+	 * Checks if messages with the provided minimal debug level are printed.
+	 *
+	 * @param minDebugLevel The minimal debug level.
+	 * @return Returns true when messages with the debug level are printed.
+	 */
+	bool enabled(int32_t minDebugLevel);
+
+	/**
+	 * Prints a debug message, which is only constructed when it is printed. Use this in hot code paths instead of
+	 * concatenating the message before calling printDebug().
+	 *
+	 * Example:
+	 *
+	 *     _bl->out.printDebugLazy([&]() { return "Debug: Peer " + std::to_string(peerId) + " ..."; });
+	 *
+	 * @see printDebug()
+	 * @param messageBuilder A callable without parameters returning the message.
+	 * @param minDebugLevel The minimal debug level (default 5).
+	 */
+	template<typename MessageBuilder>
+	void printDebugLazy(const MessageBuilder& messageBuilder, int32_t minDebugLevel = 5)
+	{
+		if(!enabled(minDebugLevel)) return;
+		printDebug(messageBuilder(), minDebugLevel);
+	}
+
+	/**
+	 * Prints an info message, which is only constructed when it is printed.
+	 *
+	 * @see printInfo()
+	 * @see printDebugLazy()
+	 * @param messageBuilder A callable without parameters returning the message.
+	 */
+	template<typename MessageBuilder>
+	void printInfoLazy(const MessageBuilder& messageBuilder)
+	{
+		if(!enabled(4)) return;
+		printInfo(messageBuilder());
+	}
+
 	/**
 	 * Prints a message regardless of the current debug level.
 	 *
@@ -239,6 +309,26 @@ private:
 	 */
 	static std::mutex _outputMutex;
 
+	/**
+	 * Set to "true" while the asynchronous writer thread is running.
+	 */
+	static std::atomic_bool _asynchronous;
+
+	/**
+	 * The total number of messages dropped in asynchronous mode.
+	 */
+	static std::atomic<uint64_t> _droppedMessages;
+
+	/**
+	 * Writes one line to the standard output and, if "errorStream" is true, to the error output. In asynchronous mode
+	 * the line is queued in the calling thread's buffer.
+	 *
+	 * @param message The message to write.
+	 * @param time The time in milliseconds to prefix the message with. If 0, no time is printed.
+	 * @param errorStream Also write the message to the error output.
+	 */
+	static void writeLine(std::string message, int64_t time, bool errorStream);
+
 	/**
 	 * Pointer to an optional callback function, which will be called whenever printEx, printWarning, printCritical or printError are called.
 	 */
@@ -42,6 +42,8 @@ Acls::Acls(BaseLib::SharedObjects* bl, int32_t clientId)
     _out.init(bl);
     _clientId = clientId;
     _out.setPrefix("Client " + std::to_string(clientId) + " ACLs: ");
+    _acls = std::make_shared<std::vector<PAcl>>();
+    _fingerprint = std::make_shared<std::string>(calculateFingerprint(*_acls));
 }
 
 Acls::~Acls()
@@ -51,33 +53,56 @@ Acls::~Acls()
 
 PVariable Acls::toVariable()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+    auto acls = std::atomic_load(&_acls);
     auto serializedData = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tArray);
-    serializedData->arrayValue->reserve(_acls.size());
-    for(auto& acl : _acls)
+    serializedData->arrayValue->reserve(acls->size());
+    for(auto& acl : *acls)
     {
         serializedData->arrayValue->emplace_back(std::move(acl->toVariable()));
     }
     return serializedData;
 }
 
+std::string Acls::getFingerprint()
+{
+    return *std::atomic_load(&_fingerprint);
+}
+
+std::string Acls::calculateFingerprint(const std::vector<PAcl>& acls)
+{
+    auto serializedData = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tArray);
+    serializedData->arrayValue->reserve(acls.size());
+    for(auto& acl : acls)
+    {
+        serializedData->arrayValue->emplace_back(acl->toVariable());
+    }
+
+    //Structs are encoded sorted by key, so equal ACLs always result in the same data.
+    Rpc::RpcEncoder rpcEncoder(false, true);
+    std::vector<char> encodedData;
+    rpcEncoder.encodeResponse(serializedData, encodedData);
+    std::vector<char> hash;
+    Hash::sha256(encodedData, hash);
+    return HelperFunctions::getHexString(hash);
+}
+
 void Acls::fromVariable(PVariable serializedData)
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    _acls.clear();
-    _acls.reserve(serializedData->arrayValue->size());
+    auto acls = std::make_shared<std::vector<PAcl>>();
+    acls->reserve(serializedData->arrayValue->size());
     for(auto& element : *serializedData->arrayValue)
     {
         auto acl = std::make_shared<Acl>();
         acl->fromVariable(element);
-        _acls.emplace_back(std::move(acl));
+        acls->emplace_back(std::move(acl));
     }
+    setAcls(acls);
 }
 
 bool Acls::categoriesReadSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->categoriesReadSet()) return true;
     }
@@ -87,8 +112,8 @@ bool Acls::categoriesReadSet()
 
 bool Acls::categoriesWriteSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->categoriesWriteSet()) return true;
     }
@@ -98,8 +123,8 @@ bool Acls::categoriesWriteSet()
 
 bool Acls::rolesReadSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->rolesReadSet()) return true;
     }
@@ -109,8 +134,8 @@ bool Acls::rolesReadSet()
 
 bool Acls::rolesWriteSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->rolesWriteSet()) return true;
     }
@@ -120,8 +145,8 @@ bool Acls::rolesWriteSet()
 
 bool Acls::devicesReadSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->devicesReadSet()) return true;
     }
@@ -131,8 +156,8 @@ bool Acls::devicesReadSet()
 
 bool Acls::devicesWriteSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->devicesWriteSet()) return true;
     }
@@ -142,8 +167,8 @@ bool Acls::devicesWriteSet()
 
 bool Acls::roomsReadSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->roomsReadSet()) return true;
     }
@@ -153,8 +178,8 @@ bool Acls::roomsReadSet()
 
 bool Acls::roomsWriteSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->roomsWriteSet()) return true;
     }
@@ -164,8 +189,8 @@ bool Acls::roomsWriteSet()
 
 bool Acls::roomsCategoriesRolesDevicesReadSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->roomsReadSet() || acl->categoriesReadSet() || acl->rolesReadSet() || acl->devicesReadSet()) return true;
     }
@@ -175,8 +200,8 @@ bool Acls::roomsCategoriesRolesDevicesReadSet()
 
 bool Acls::roomsCategoriesRolesDevicesWriteSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->roomsWriteSet() || acl->categoriesWriteSet() || acl->rolesWriteSet() || acl->devicesWriteSet()) return true;
     }
@@ -186,8 +211,8 @@ bool Acls::roomsCategoriesRolesDevicesWriteSet()
 
 bool Acls::variablesReadSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->variablesReadSet()) return true;
     }
@@ -197,8 +222,8 @@ bool Acls::variablesReadSet()
 
 bool Acls::variablesWriteSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->variablesWriteSet()) return true;
     }
@@ -208,8 +233,8 @@ bool Acls::variablesWriteSet()
 
 bool Acls::variablesRoomsCategoriesRolesReadSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->variablesReadSet() || acl->roomsReadSet() || acl->categoriesReadSet() || acl->rolesReadSet()) return true;
     }
@@ -219,8 +244,8 @@ bool Acls::variablesRoomsCategoriesRolesReadSet()
 
 bool Acls::variablesRoomsCategoriesRolesWriteSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->variablesWriteSet() || acl->roomsWriteSet() || acl->categoriesWriteSet() || acl->rolesWriteSet()) return true;
     }
@@ -230,8 +255,8 @@ bool Acls::variablesRoomsCategoriesRolesWriteSet()
 
 bool Acls::variablesRoomsCategoriesRolesDevicesReadSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->variablesReadSet() || acl->roomsReadSet() || acl->categoriesReadSet() || acl->rolesReadSet() || acl->devicesReadSet()) return true;
     }
@@ -241,8 +266,8 @@ bool Acls::variablesRoomsCategoriesRolesDevicesReadSet()
 
 bool Acls::variablesRoomsCategoriesRolesDevicesWriteSet()
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    for(auto& acl : _acls)
+    auto acls = std::atomic_load(&_acls);
+    for(auto& acl : *acls)
     {
         if(acl->variablesWriteSet() || acl->roomsWriteSet() || acl->categoriesWriteSet() || acl->rolesWriteSet() || acl->devicesWriteSet()) return true;
     }
@@ -252,8 +277,15 @@ bool Acls::variablesRoomsCategoriesRolesDevicesWriteSet()
 
 void Acls::clear()
 {
+    setAcls(std::make_shared<std::vector<PAcl>>());
+}
+
+void Acls::setAcls(std::shared_ptr<const std::vector<PAcl>> acls)
+{
+    std::shared_ptr<const std::string> fingerprint = std::make_shared<std::string>(calculateFingerprint(*acls));
     std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
-    _acls.clear();
+    std::atomic_store(&_acls, std::move(acls));
+    std::atomic_store(&_fingerprint, std::move(fingerprint));
 }
 
 bool Acls::fromUser(std::string& userName)
@@ -274,31 +306,31 @@ bool Acls::fromUser(std::string& userName)
 
 bool Acls::fromGroups(std::vector<uint64_t>& groupIds)
 {
-    std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
     try
     {
         if(groupIds.empty()) return false;
         std::string outputPrefix = "Client " + std::to_string(_clientId) + " ACLs (groups ";
-        _acls.clear();
-        _acls.reserve(groupIds.size());
+        auto acls = std::make_shared<std::vector<PAcl>>();
+        acls->reserve(groupIds.size());
         for(auto& group : groupIds)
         {
             auto aclData = _bl->db->getAcl(group);
             if(aclData->errorStruct)
             {
                 _out.printError("Error: Could not get ACLs of group " + std::to_string(group) + ": " + aclData->structValue->at("faultString")->stringValue);
-                _acls.clear();
+                clear();
                 return false;
             }
 
             PAcl acl = std::make_shared<Acl>();
             acl->fromVariable(aclData); //Throws AclException on error => return false
-            _acls.push_back(acl);
+            acls->push_back(acl);
             outputPrefix += std::to_string(group) + ", ";
         }
 
         outputPrefix = outputPrefix.substr(0, outputPrefix.size() - 2) + "): ";
         _out.setPrefix(outputPrefix);
+        setAcls(acls);
 
         return true;
     }
@@ -307,7 +339,7 @@ bool Acls::fromGroups(std::vector<uint64_t>& groupIds)
         _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
     }
 
-    _acls.clear();
+    clear();
     return false;
 }
 
@@ -315,9 +347,9 @@ bool Acls::checkServiceAccess(std::string serviceName)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkServiceAccess(serviceName);
             if(result == AclResult::error || result == AclResult::deny)
@@ -343,9 +375,9 @@ bool Acls::checkCategoriesReadAccess(std::set<uint64_t>& categories)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkCategoriesReadAccess(categories);
             if(result == AclResult::error || result == AclResult::deny)
@@ -371,9 +403,9 @@ bool Acls::checkCategoriesWriteAccess(std::set<uint64_t>& categories)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkCategoriesWriteAccess(categories);
             if(result == AclResult::error || result == AclResult::deny)
@@ -399,9 +431,9 @@ bool Acls::checkCategoryReadAccess(uint64_t categoryId)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkCategoryReadAccess(categoryId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -427,9 +459,9 @@ bool Acls::checkCategoryWriteAccess(uint64_t categoryId)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkCategoryWriteAccess(categoryId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -455,9 +487,9 @@ bool Acls::checkRolesReadAccess(std::set<uint64_t>& roles)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkRolesReadAccess(roles);
             if(result == AclResult::error || result == AclResult::deny)
@@ -483,9 +515,9 @@ bool Acls::checkRolesWriteAccess(std::set<uint64_t>& roles)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkRolesWriteAccess(roles);
             if(result == AclResult::error || result == AclResult::deny)
@@ -511,9 +543,9 @@ bool Acls::checkRoleReadAccess(uint64_t roleId)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkRoleReadAccess(roleId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -539,9 +571,9 @@ bool Acls::checkRoleWriteAccess(uint64_t roleId)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkRoleWriteAccess(roleId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -568,9 +600,9 @@ bool Acls::checkDeviceReadAccess(std::shared_ptr<Systems::Peer> peer)
     try
     {
         if(!peer) return false;
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkDeviceReadAccess(peer);
             if(result == AclResult::error || result == AclResult::deny)
@@ -597,9 +629,9 @@ bool Acls::checkDeviceWriteAccess(std::shared_ptr<Systems::Peer> peer)
     try
     {
         if(!peer) return false;
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkDeviceWriteAccess(peer);
             if(result == AclResult::error || result == AclResult::deny)
@@ -625,9 +657,9 @@ bool Acls::checkEventServerMethodAccess(std::string methodName)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkEventServerMethodAccess(methodName);
             if(result == AclResult::error || result == AclResult::deny)
@@ -653,9 +685,9 @@ bool Acls::checkMethodAccess(std::string methodName)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkMethodAccess(methodName);
             if(result == AclResult::error || result == AclResult::deny)
@@ -681,9 +713,9 @@ bool Acls::checkMethodAndCategoryReadAccess(std::string methodName, uint64_t cat
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkMethodAndCategoryReadAccess(methodName, categoryId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -709,9 +741,9 @@ bool Acls::checkMethodAndCategoryWriteAccess(std::string methodName, uint64_t ca
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkMethodAndCategoryWriteAccess(methodName, categoryId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -737,9 +769,9 @@ bool Acls::checkMethodAndRoleReadAccess(std::string methodName, uint64_t roleId)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkMethodAndRoleReadAccess(methodName, roleId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -765,9 +797,9 @@ bool Acls::checkMethodAndRoleWriteAccess(std::string methodName, uint64_t roleId
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkMethodAndRoleWriteAccess(methodName, roleId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -793,9 +825,9 @@ bool Acls::checkMethodAndRoomReadAccess(std::string methodName, uint64_t roomId)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkMethodAndRoomReadAccess(methodName, roomId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -821,9 +853,9 @@ bool Acls::checkMethodAndRoomWriteAccess(std::string methodName, uint64_t roomId
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkMethodAndRoomWriteAccess(methodName, roomId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -849,9 +881,9 @@ bool Acls::checkMethodAndDeviceWriteAccess(std::string methodName, uint64_t peer
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkMethodAndDeviceWriteAccess(methodName, peerId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -877,9 +909,9 @@ bool Acls::checkRoomReadAccess(uint64_t roomId)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkRoomReadAccess(roomId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -905,9 +937,9 @@ bool Acls::checkRoomWriteAccess(uint64_t roomId)
 {
     try
     {
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkRoomWriteAccess(roomId);
             if(result == AclResult::error || result == AclResult::deny)
@@ -934,9 +966,9 @@ bool Acls::checkSystemVariableReadAccess(Database::PSystemVariable systemVariabl
     try
     {
         if(!systemVariable) return false;
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkSystemVariableReadAccess(systemVariable);
             if(result == AclResult::error || result == AclResult::deny)
@@ -963,9 +995,9 @@ bool Acls::checkSystemVariableWriteAccess(Database::PSystemVariable systemVariab
     try
     {
         if(!systemVariable) return false;
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkSystemVariableWriteAccess(systemVariable);
             if(result == AclResult::error || result == AclResult::deny)
@@ -992,9 +1024,9 @@ bool Acls::checkVariableReadAccess(std::shared_ptr<Systems::Peer> peer, int32_t
     try
     {
         if(!peer) return false;
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkVariableReadAccess(peer, channel, variableName);
             if(result == AclResult::error || result == AclResult::deny)
@@ -1021,9 +1053,9 @@ bool Acls::checkVariableWriteAccess(std::shared_ptr<Systems::Peer> peer, int32_t
     try
     {
         if(!peer) return false;
-        std::lock_guard<std::mutex> aclsGuard(_aclsMutex);
+        auto acls = std::atomic_load(&_acls);
         bool acceptSet = false;
-        for(auto& acl : _acls)
+        for(auto& acl : *acls)
         {
             auto result = acl->checkVariableWriteAccess(peer, channel, variableName);
             if(result == AclResult::error || result == AclResult::deny)
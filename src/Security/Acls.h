@@ -55,8 +55,25 @@ private:
     BaseLib::SharedObjects* _bl = nullptr;
     int32_t _clientId = -1;
     BaseLib::Output _out;
+    /**
+     * Serializes writers. Readers don't lock it.
+     */
     std::mutex _aclsMutex;
-    std::vector<PAcl> _acls;
+
+    /**
+     * Immutable snapshot of the ACLs. It is only accessed through std::atomic_load() and std::atomic_store(), so checks
+     * from many threads (e. g. the parallel bulk RPC methods) don't block each other. Changing the ACLs replaces the
+     * whole snapshot.
+     */
+    std::shared_ptr<const std::vector<PAcl>> _acls;
+
+    /**
+     * Fingerprint of "_acls". Replaced together with it.
+     */
+    std::shared_ptr<const std::string> _fingerprint;
+
+    void setAcls(std::shared_ptr<const std::vector<PAcl>> acls);
+    static std::string calculateFingerprint(const std::vector<PAcl>& acls);
 public:
     Acls(BaseLib::SharedObjects* bl, int32_t clientId);
     ~Acls();
@@ -85,6 +102,12 @@ public:
     PVariable toVariable();
     void fromVariable(PVariable serializedData);
 
+    /**
+     * Returns a hash of the ACLs. Clients with the same fingerprint have the same access rights, so e. g. cached RPC responses
+     * can be shared between them.
+     */
+    std::string getFingerprint();
+
     /**
      * Checks if the ACLs grant access to a service.
      *
@@ -57,6 +57,12 @@ void Gcrypt::reset()
     if(!_handle) throw GcryptException("Could not get handle.");
 }
 
+void Gcrypt::resetState()
+{
+	gcry_error_t result = gcry_cipher_reset(_handle);
+	if(result != GPG_ERR_NO_ERROR) throw GcryptException(getError(result));
+}
+
 std::string Gcrypt::getError(int32_t errorCode)
 {
 	std::array<char, 512> result{};
@@ -181,6 +187,58 @@ template void Gcrypt::decrypt<SecureVector<char>, std::vector<char>>(SecureVecto
 template void Gcrypt::decrypt<SecureVector<uint8_t>, std::vector<uint8_t>>(SecureVector<uint8_t>& out, const std::vector<uint8_t>& in);
 #endif
 
+bool Gcrypt::usesIv()
+{
+	return _mode != GCRY_CIPHER_MODE_ECB && _mode != GCRY_CIPHER_MODE_STREAM;
+}
+
+template<typename Data> void Gcrypt::encryptBatch(std::vector<Data>& out, const std::vector<Data>& in, const std::vector<Data>& ivs)
+{
+	if(!_keySet) throw GcryptException("No key set.");
+	//resetState() zeroes the IV, so without IVs all messages would be encrypted with the same IV (the same key stream in CTR mode).
+	if(usesIv() ? ivs.size() != in.size() : !ivs.empty()) throw GcryptException("Number of IVs doesn't match number of messages.");
+	out.resize(in.size());
+	for(size_t i = 0; i < in.size(); i++)
+	{
+		resetState();
+		if(usesIv())
+		{
+			if(_mode == GCRY_CIPHER_MODE_CTR) setCounter(ivs[i].data(), ivs[i].size());
+			else setIv(ivs[i].data(), ivs[i].size());
+		}
+		out[i].resize(in[i].size());
+		if(!in[i].empty()) encrypt((void*)out[i].data(), out[i].size(), (void*)in[i].data(), in[i].size());
+	}
+}
+
+#ifndef DOXYGEN_SKIP
+template void Gcrypt::encryptBatch<std::vector<char>>(std::vector<std::vector<char>>& out, const std::vector<std::vector<char>>& in, const std::vector<std::vector<char>>& ivs);
+template void Gcrypt::encryptBatch<std::vector<uint8_t>>(std::vector<std::vector<uint8_t>>& out, const std::vector<std::vector<uint8_t>>& in, const std::vector<std::vector<uint8_t>>& ivs);
+#endif
+
+template<typename Data> void Gcrypt::decryptBatch(std::vector<Data>& out, const std::vector<Data>& in, const std::vector<Data>& ivs)
+{
+	if(!_keySet) throw GcryptException("No key set.");
+	if(usesIv() ? ivs.size() != in.size() : !ivs.empty()) throw GcryptException("Number of IVs doesn't match number of messages.");
+	out.resize(in.size());
+	for(size_t i = 0; i < in.size(); i++)
+	{
+		resetState();
+		if(usesIv())
+		{
+			if(_mode == GCRY_CIPHER_MODE_CTR) setCounter(ivs[i].data(), ivs[i].size());
+			else setIv(ivs[i].data(), ivs[i].size());
+		}
+		out[i].resize(in[i].size());
+		if(!in[i].empty()) decrypt((void*)out[i].data(), out[i].size(), (void*)in[i].data(), in[i].size());
+	}
+}
+
+#ifndef DOXYGEN_SKIP
+template void Gcrypt::decryptBatch<std::vector<char>>(std::vector<std::vector<char>>& out, const std::vector<std::vector<char>>& in, const std::vector<std::vector<char>>& ivs);
+template void Gcrypt::decryptBatch<std::vector<uint8_t>>(std::vector<std::vector<uint8_t>>& out, const std::vector<std::vector<uint8_t>>& in, const std::vector<std::vector<uint8_t>>& ivs);
+#endif
+
 bool Gcrypt::authenticate(const void* in, const size_t inLength)
 {
     if(!_keySet) throw GcryptException("No key set.");
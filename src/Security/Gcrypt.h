@@ -103,6 +103,21 @@ public:
 	 */
 	void reset();
 
+	/**
+	 * Resets the state (IV, counter, authentication data) of the handle but keeps the key. This is much cheaper than reset() and
+	 * should be used between messages encrypted with the same key.
+	 *
+	 * @throws GcryptException On error.
+	 */
+	void resetState();
+
+	/**
+	 * Checks if the mode used needs an IV or counter, i. e. it is not ECB or a stream cipher.
+	 *
+	 * @return Returns true when the mode uses an IV.
+	 */
+	bool usesIv();
+
 	/**
 	 * Returns the underlying gcry_cipher_hd_t.
 	 *
@@ -193,6 +208,24 @@ public:
 	 */
 	template<typename DataOut, typename DataIn> void decrypt(DataOut& out, const DataIn& in);
 
+	/**
+	 * Encrypts several messages with the key set. Before each message the state is reset (see resetState()) and the IV of the
+	 * message is set. In CTR mode the IVs are used as counters.
+	 *
+	 * @param[out] out The encrypted messages in the order of "in".
+	 * @param in The messages to encrypt.
+	 * @param ivs One IV per message for modes using an IV (see usesIv()), empty otherwise.
+	 * @throws GcryptException On error or when the number of IVs is wrong.
+	 */
+	template<typename Data> void encryptBatch(std::vector<Data>& out, const std::vector<Data>& in, const std::vector<Data>& ivs);
+
+	/**
+	 * Decrypts several messages with the key set. See encryptBatch().
+	 *
+	 * @throws GcryptException On error.
+	 */
+	template<typename Data> void decryptBatch(std::vector<Data>& out, const std::vector<Data>& in, const std::vector<Data>& ivs);
+
 	/**
 	 * Authenticates encrypted data if supported by the algorithm. Takes same parameters as gcry_cipher_authenticate() except for the handle.
 	 */
@@ -41,7 +41,6 @@ namespace Security
 
 template<typename Data> bool Hash::sha1(const Data& in, Data& out)
 {
-	out.clear();
 	out.resize(gcry_md_get_algo_dlen(GCRY_MD_SHA1));
 	gcry_md_hash_buffer(GCRY_MD_SHA1, out.data(), in.data(), in.size());
 	return true;
@@ -51,7 +50,6 @@ template bool Hash::sha1<std::vector<uint8_t>>(const std::vector<uint8_t>& in, s
 
 template<typename Data> bool Hash::sha256(const Data& in, Data& out)
 {
-	out.clear();
 	out.resize(gcry_md_get_algo_dlen(GCRY_MD_SHA256));
 	gcry_md_hash_buffer(GCRY_MD_SHA256, out.data(), in.data(), in.size());
 	return true;
@@ -61,7 +59,6 @@ template bool Hash::sha256<std::vector<uint8_t>>(const std::vector<uint8_t>& in,
 
 template<typename Data> bool Hash::md5(const Data& in, Data& out)
 {
-	out.clear();
 	out.resize(gcry_md_get_algo_dlen(GCRY_MD_MD5));
 	gcry_md_hash_buffer(GCRY_MD_MD5, out.data(), in.data(), in.size());
 	return true;
@@ -71,7 +68,6 @@ template bool Hash::md5<std::vector<uint8_t>>(const std::vector<uint8_t>& in, st
 
 template<typename Data> bool Hash::whirlpool(const Data& in, Data& out)
 {
-	out.clear();
 	out.resize(gcry_md_get_algo_dlen(GCRY_MD_WHIRLPOOL));
 	gcry_md_hash_buffer(GCRY_MD_WHIRLPOOL, out.data(), in.data(), in.size());
 	return true;
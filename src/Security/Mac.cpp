@@ -86,5 +86,87 @@ template<typename Data> bool Mac::cmac(const Data& key, const Data& iv, const Da
 template bool Mac::cmac<std::vector<char>>(const std::vector<char>& key, const std::vector<char>& iv, const std::vector<char>& in, std::vector<char>& out);
 template bool Mac::cmac<std::vector<uint8_t>>(const std::vector<uint8_t>& key, const std::vector<uint8_t>& iv, const std::vector<uint8_t>& in, std::vector<uint8_t>& out);
 
+Cmac::Cmac(const void* key, size_t length)
+{
+    gcry_error_t result = gcry_mac_open(&_handle, GCRY_MAC_CMAC_AES, GCRY_MAC_FLAG_SECURE, nullptr);
+    if(result != GPG_ERR_NO_ERROR || !_handle) throw GcryptException(Gcrypt::getError(result));
+
+    result = gcry_mac_setkey(_handle, key, length);
+    if(result != GPG_ERR_NO_ERROR)
+    {
+        gcry_mac_close(_handle);
+        _handle = nullptr;
+        throw GcryptException(Gcrypt::getError(result));
+    }
+
+    _macLength = gcry_mac_get_algo_maclen(GCRY_MAC_CMAC_AES);
+    _buffer.resize(_macLength);
+}
+
+Cmac::~Cmac()
+{
+    if(_handle) gcry_mac_close(_handle);
+}
+
+void Cmac::reset()
+{
+    gcry_error_t result = gcry_mac_ctl(_handle, GCRYCTL_RESET, nullptr, 0);
+    if(result != GPG_ERR_NO_ERROR) throw GcryptException(Gcrypt::getError(result));
+}
+
+void Cmac::calculate(const void* in, size_t inLength, void* out)
+{
+    reset();
+
+    gcry_error_t result = GPG_ERR_NO_ERROR;
+    if(inLength > 0)
+    {
+        result = gcry_mac_write(_handle, in, inLength);
+        if(result != GPG_ERR_NO_ERROR) throw GcryptException(Gcrypt::getError(result));
+    }
+
+    size_t outputSize = _macLength;
+    result = gcry_mac_read(_handle, out, &outputSize);
+    if(result != GPG_ERR_NO_ERROR) throw GcryptException(Gcrypt::getError(result));
+    if(outputSize != _macLength) throw GcryptException("Unexpected MAC length.");
+}
+
+template<typename Data> void Cmac::calculate(const Data& in, Data& out)
+{
+    out.resize(_macLength);
+    calculate(in.data(), in.size(), out.data());
+}
+
+template void Cmac::calculate<std::vector<char>>(const std::vector<char>& in, std::vector<char>& out);
+template void Cmac::calculate<std::vector<uint8_t>>(const std::vector<uint8_t>& in, std::vector<uint8_t>& out);
+
+template<typename Data> void Cmac::calculateBatch(const std::vector<Data>& in, std::vector<Data>& out)
+{
+    out.resize(in.size());
+    for(size_t i = 0; i < in.size(); i++)
+    {
+        calculate(in[i], out[i]);
+    }
+}
+
+template void Cmac::calculateBatch<std::vector<char>>(const std::vector<std::vector<char>>& in, std::vector<std::vector<char>>& out);
+template void Cmac::calculateBatch<std::vector<uint8_t>>(const std::vector<std::vector<uint8_t>>& in, std::vector<std::vector<uint8_t>>& out);
+
+template<typename Data> bool Cmac::verify(const Data& in, const Data& mac, size_t minimumMacLength)
+{
+    if(mac.empty() || mac.size() < minimumMacLength || mac.size() > _macLength) return false;
+    calculate(in.data(), in.size(), _buffer.data());
+    //Constant time comparison
+    uint8_t difference = 0;
+    for(size_t i = 0; i < mac.size(); i++)
+    {
+        difference |= (uint8_t)mac[i] ^ _buffer[i];
+    }
+    return difference == 0;
+}
+
+template bool Cmac::verify<std::vector<char>>(const std::vector<char>& in, const std::vector<char>& mac, size_t minimumMacLength);
+template bool Cmac::verify<std::vector<uint8_t>>(const std::vector<uint8_t>& in, const std::vector<uint8_t>& mac, size_t minimumMacLength);
+
 }
 }
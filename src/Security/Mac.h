@@ -31,6 +31,12 @@
 #ifndef MAC_H_
 #define MAC_H_
 
+#include <gcrypt.h>
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
 namespace BaseLib
 {
 namespace Security
@@ -64,6 +70,101 @@ protected:
     Mac();
 };
 
+/**
+ * AES-CMAC with a fixed key. The MAC handle is opened and keyed once in the constructor and only reset between messages, so
+ * authenticating many small messages (e. g. radio telegrams) doesn't pay for the context setup every time like Mac::cmac() does.
+ * Objects of this class are not thread safe.
+ *
+ * Example:
+ *
+ *     BaseLib::Security::Cmac cmac(key);
+ *     std::vector<uint8_t> mac;
+ *     for(auto& packet : packets)
+ *     {
+ *     	cmac.calculate(packet, mac);
+ *     	...
+ *     }
+ */
+class Cmac
+{
+public:
+    /**
+     * Constructor.
+     *
+     * @param key The AES key to use. Must be 16, 24 or 32 bytes long.
+     * @throws GcryptException On errors.
+     */
+    template<typename Data> explicit Cmac(const Data& key) : Cmac(key.data(), key.size()) {}
+
+    /**
+     * Constructor.
+     *
+     * @param key The AES key to use.
+     * @param length The length of "key". Must be 16, 24 or 32.
+     * @throws GcryptException On errors.
+     */
+    Cmac(const void* key, size_t length);
+
+    /**
+     * Destructor.
+     */
+    virtual ~Cmac();
+
+    /**
+     * Returns the length of the calculated MACs in bytes.
+     */
+    size_t getMacLength() { return _macLength; }
+
+    /**
+     * Calculates the CMAC of one message.
+     *
+     * @param[in] in The data to calculate the CMAC for.
+     * @param[in] inLength The length of "in".
+     * @param[out] out Buffer of at least getMacLength() bytes to store the calculated MAC in.
+     * @throws GcryptException On errors.
+     */
+    void calculate(const void* in, size_t inLength, void* out);
+
+    /**
+     * Calculates the CMAC of one message. "out" is only resized, so passing the same vector for every message doesn't reallocate it.
+     *
+     * @param[in] in The data to calculate the CMAC for.
+     * @param[out] out A vector to store the calculated MAC in.
+     * @throws GcryptException On errors.
+     */
+    template<typename Data> void calculate(const Data& in, Data& out);
+
+    /**
+     * Calculates the CMACs of several messages.
+     *
+     * @param[in] in The messages.
+     * @param[out] out The MACs in the order of "in".
+     * @throws GcryptException On errors.
+     */
+    template<typename Data> void calculateBatch(const std::vector<Data>& in, std::vector<Data>& out);
+
+    /**
+     * Checks the CMAC of one message. "mac" may be shorter than getMacLength() for truncated MACs, but not shorter than
+     * "minimumMacLength". Otherwise a MAC could be forged by guessing only a few bytes.
+     *
+     * @param[in] in The data to check.
+     * @param[in] mac The MAC to compare with.
+     * @param[in] minimumMacLength The minimum length of "mac" in bytes. The default is the 64 bits recommended by NIST SP 800-38B.
+     * @return Returns "true" when the MAC matches.
+     * @throws GcryptException On errors.
+     */
+    template<typename Data> bool verify(const Data& in, const Data& mac, size_t minimumMacLength = 8);
+private:
+    gcry_mac_hd_t _handle = nullptr;
+    size_t _macLength = 0;
+    std::vector<uint8_t> _buffer;
+
+    Cmac(const Cmac&) = delete;
+    Cmac& operator=(const Cmac&) = delete;
+
+    void reset();
+};
+
 }
 }
 #endif
@@ -116,6 +116,12 @@ void Settings::reset()
 	_eventThreadCount = 5;
 	_eventThreadPriority = 0;
 	_eventThreadPolicy = SCHED_OTHER;
+	_rpcBulkThreadCount = 1;
+	_peerLoadThreadCount = 1;
+	_eventCoalescingInterval = 0;
+	_eventCoalescingMinDelta = 0;
+	_coalesceRpcEvents = true;
+	_coalesceScriptEvents = true;
 	_familyConfigPath = "/etc/homegear/families/";
 	_deviceDescriptionPath = "/etc/homegear/devices/";
 	_clientSettingsPath = "/etc/homegear/rpcclients.conf";
@@ -657,6 +663,39 @@ void Settings::load(std::string filename, std::string executablePath)
 					_eventThreadPriority = ThreadManager::parseThreadPriority(_eventThreadPriority, _eventThreadPolicy);
 					_bl->out.printDebug("Debug: eventThreadPolicy set to " + std::to_string(_eventThreadPolicy));
 				}
+				else if(name == "rpcbulkthreadcount")
+				{
+					_rpcBulkThreadCount = Math::getNumber(value);
+					if(_rpcBulkThreadCount < 1) _rpcBulkThreadCount = 1;
+					_bl->out.printDebug("Debug: rpcBulkThreadCount set to " + std::to_string(_rpcBulkThreadCount));
+				}
+				else if(name == "peerloadthreadcount")
+				{
+					_peerLoadThreadCount = Math::getNumber(value);
+					if(_peerLoadThreadCount < 1) _peerLoadThreadCount = 1;
+					_bl->out.printDebug("Debug: peerLoadThreadCount set to " + std::to_string(_peerLoadThreadCount));
+				}
+				else if(name == "eventcoalescinginterval")
+				{
+					_eventCoalescingInterval = Math::getNumber(value);
+					_bl->out.printDebug("Debug: eventCoalescingInterval set to " + std::to_string(_eventCoalescingInterval));
+				}
+				else if(name == "eventcoalescingmindelta")
+				{
+					_eventCoalescingMinDelta = Math::getDouble(value);
+					if(_eventCoalescingMinDelta < 0) _eventCoalescingMinDelta = 0;
+					_bl->out.printDebug("Debug: eventCoalescingMinDelta set to " + std::to_string(_eventCoalescingMinDelta));
+				}
+				else if(name == "coalescerpcevents")
+				{
+					_coalesceRpcEvents = HelperFunctions::toLower(value) == "true";
+					_bl->out.printDebug("Debug: coalesceRpcEvents set to " + std::to_string(_coalesceRpcEvents));
+				}
+				else if(name == "coalescescriptevents")
+				{
+					_coalesceScriptEvents = HelperFunctions::toLower(value) == "true";
+					_bl->out.printDebug("Debug: coalesceScriptEvents set to " + std::to_string(_coalesceScriptEvents));
+				}
 				else if(name == "familyconfigpath")
 				{
 					_familyConfigPath = value;
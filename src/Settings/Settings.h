@@ -122,6 +122,12 @@ public:
 	uint32_t eventThreadCount() { return _eventThreadCount; }
 	int32_t eventThreadPriority() { return _eventThreadPriority; }
 	int32_t eventThreadPolicy() { return _eventThreadPolicy; }
+	uint32_t rpcBulkThreadCount() { return _rpcBulkThreadCount; }
+	uint32_t peerLoadThreadCount() { return _peerLoadThreadCount; }
+	uint32_t eventCoalescingInterval() { return _eventCoalescingInterval; }
+	double eventCoalescingMinDelta() { return _eventCoalescingMinDelta; }
+	bool coalesceRpcEvents() { return _coalesceRpcEvents; }
+	bool coalesceScriptEvents() { return _coalesceScriptEvents; }
 	std::string familyConfigPath() { return _familyConfigPath; }
 	std::string deviceDescriptionPath() { return _deviceDescriptionPath; }
 	std::string clientSettingsPath() { return _clientSettingsPath; }
@@ -251,6 +257,12 @@ private:
 	uint32_t _eventThreadCount = 5;
 	int32_t _eventThreadPriority = 0;
 	int32_t _eventThreadPolicy = SCHED_OTHER;
+	uint32_t _rpcBulkThreadCount = 1;
+	uint32_t _peerLoadThreadCount = 1;
+	uint32_t _eventCoalescingInterval = 0;
+	double _eventCoalescingMinDelta = 0;
+	bool _coalesceRpcEvents = true;
+	bool _coalesceScriptEvents = true;
 	std::string _familyConfigPath;
 	std::string _deviceDescriptionPath;
 	std::string _clientSettingsPath;
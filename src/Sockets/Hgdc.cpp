@@ -178,6 +178,25 @@ int32_t Hgdc::registerModuleUpdateEventHandler(std::function<void(const BaseLib:
     return -1;
 }
 
+int32_t Hgdc::registerSharedModuleUpdateEventHandler(std::function<void(const BaseLib::ImmutableVariable&)> value)
+{
+    try
+    {
+        int32_t eventHandlerId = -1;
+        std::lock_guard<std::mutex> eventHandlersGuard(_moduleUpdateEventHandlersMutex);
+        while(eventHandlerId == -1) eventHandlerId = _currentEventHandlerId++;
+
+        _sharedModuleUpdateEventHandlers.emplace(eventHandlerId, std::move(value));
+
+        return eventHandlerId;
+    }
+    catch(const std::exception& ex)
+    {
+        _out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return -1;
+}
+
 void Hgdc::unregisterModuleUpdateEventHandler(int32_t eventHandlerId)
 {
     try
@@ -186,6 +205,7 @@ void Hgdc::unregisterModuleUpdateEventHandler(int32_t eventHandlerId)
 
         std::lock_guard<std::mutex> eventHandlersGuard(_moduleUpdateEventHandlersMutex);
         _moduleUpdateEventHandlers.erase(eventHandlerId);
+        _sharedModuleUpdateEventHandlers.erase(eventHandlerId);
     }
     catch(const std::exception& ex)
     {
@@ -463,6 +483,15 @@ void Hgdc::processQueueEntry(int32_t index, std::shared_ptr<BaseLib::IQueueEntry
             else if(queueEntry->method == "moduleUpdate")
             {
                 std::lock_guard<std::mutex> eventHandlersGuard(_moduleUpdateEventHandlersMutex);
+                if(!_sharedModuleUpdateEventHandlers.empty())
+                {
+                    //Copied once for all handlers and before the legacy handlers get a chance to modify the original
+                    BaseLib::ImmutableVariable moduleUpdate(queueEntry->parameters->at(0));
+                    for(auto& eventHandler : _sharedModuleUpdateEventHandlers)
+                    {
+                        if(eventHandler.second) eventHandler.second(moduleUpdate);
+                    }
+                }
                 for(auto& eventHandler : _moduleUpdateEventHandlers)
                 {
                     if(eventHandler.second) eventHandler.second(queueEntry->parameters->at(0));
@@ -38,6 +38,7 @@
 #include "../Encoding/RpcDecoder.h"
 #include "../Output/Output.h"
 #include "../IQueue.h"
+#include "../ImmutableVariable.h"
 
 #include <condition_variable>
 
@@ -72,6 +73,7 @@ private:
     std::unordered_map<int64_t, std::list<std::pair<int32_t, std::function<void(int64_t, const std::string&, const std::vector<uint8_t>&)>>>> _packetReceivedEventHandlers;
     std::mutex _moduleUpdateEventHandlersMutex;
     std::unordered_map<int32_t, std::function<void(const BaseLib::PVariable&)>> _moduleUpdateEventHandlers;
+    std::unordered_map<int32_t, std::function<void(const BaseLib::ImmutableVariable&)>> _sharedModuleUpdateEventHandlers;
     std::mutex _reconnectedEventHandlersMutex;
     std::unordered_map<int32_t, std::function<void()>> _reconnectedEventHandlers;
 
@@ -94,6 +96,12 @@ public:
     int32_t registerPacketReceivedEventHandler(int64_t familyId, std::function<void(int64_t, const std::string&, const std::vector<uint8_t>&)> value);
     void unregisterPacketReceivedEventHandler(int32_t eventHandlerId);
     int32_t registerModuleUpdateEventHandler(std::function<void(const BaseLib::PVariable&)> value);
+
+    /**
+     * Like registerModuleUpdateEventHandler(), but all handlers registered this way receive the same read-only copy of the module
+     * update instead of the mutable original. Unregister with unregisterModuleUpdateEventHandler().
+     */
+    int32_t registerSharedModuleUpdateEventHandler(std::function<void(const BaseLib::ImmutableVariable&)> value);
     void unregisterModuleUpdateEventHandler(int32_t eventHandlerId);
     int32_t registerReconnectedEventHandler(std::function<void()> value);
     void unregisterReconnectedEventHandler(int32_t eventHandlerId);
@@ -76,38 +76,40 @@ void HttpClient::setTimeout(uint32_t value)
 	_socket->setWriteTimeout((int64_t)value * 1000);
 }
 
+std::string HttpClient::constructRequest(const std::string& method, const std::string& path, const std::string* content)
+{
+	std::string request;
+	request.reserve(path.size() + _hostname.size() + (content ? content->size() : 0) + 128);
+	request.append(method).append(" ").append(path.empty() ? "/" : path).append(" HTTP/1.1\r\nUser-Agent: Homegear\r\nHost: ").append(_hostname).append(":").append(std::to_string(_port)).append("\r\nConnection: ").append(_keepAlive ? "Keep-Alive" : "Close");
+	if(content) request.append("\r\nContent-Length: ").append(std::to_string(content->size() + 2)).append("\r\n\r\n").append(*content).append("\r\n");
+	else request.append("\r\n\r\n");
+	return request;
+}
+
 void HttpClient::get(const std::string& path, std::string& data)
 {
-	std::string fixedPath = path;
-	if(fixedPath.empty()) fixedPath = "/";
-	std::string getRequest = "GET " + fixedPath + " HTTP/1.1\r\nUser-Agent: Homegear\r\nHost: " + _hostname + ":" + std::to_string(_port) + "\r\nConnection: " + (_keepAlive ? "Keep-Alive" : "Close") + "\r\n\r\n";
+	std::string getRequest = constructRequest("GET", path, nullptr);
 	if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: HTTP request: " + getRequest);
 	sendRequest(getRequest, data);
 }
 
 void HttpClient::get(const std::string& path, Http& http)
 {
-	std::string fixedPath = path;
-	if(fixedPath.empty()) fixedPath = "/";
-	std::string getRequest = "GET " + fixedPath + " HTTP/1.1\r\nUser-Agent: Homegear\r\nHost: " + _hostname + ":" + std::to_string(_port) + "\r\nConnection: " + (_keepAlive ? "Keep-Alive" : "Close") + "\r\n\r\n";
+	std::string getRequest = constructRequest("GET", path, nullptr);
 	if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: HTTP request: " + getRequest);
 	sendRequest(getRequest, http);
 }
 
 void HttpClient::post(const std::string& path, std::string& dataIn, std::string& dataOut)
 {
-	std::string fixedPath = path;
-	if(fixedPath.empty()) fixedPath = "/";
-	std::string postRequest = "POST " + fixedPath + " HTTP/1.1\r\nUser-Agent: Homegear\r\nHost: " + _hostname + ":" + std::to_string(_port) + "\r\nConnection: " + (_keepAlive ? "Keep-Alive" : "Close") + "\r\nContent-Length: " + std::to_string(dataIn.size() + 2) + "\r\n\r\n" + dataIn + "\r\n";
+	std::string postRequest = constructRequest("POST", path, &dataIn);
 	if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: HTTP request: " + postRequest);
 	sendRequest(postRequest, dataOut);
 }
 
 void HttpClient::post(const std::string& path, std::string& dataIn, Http& dataOut)
 {
-	std::string fixedPath = path;
-	if(fixedPath.empty()) fixedPath = "/";
-	std::string postRequest = "POST " + fixedPath + " HTTP/1.1\r\nUser-Agent: Homegear\r\nHost: " + _hostname + ":" + std::to_string(_port) + "\r\nConnection: " + (_keepAlive ? "Keep-Alive" : "Close") + "\r\nContent-Length: " + std::to_string(dataIn.size() + 2) + "\r\n\r\n" + dataIn + "\r\n";
+	std::string postRequest = constructRequest("POST", path, &dataIn);
 	if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: HTTP request: " + postRequest);
 	sendRequest(postRequest, dataOut);
 }
@@ -130,6 +132,106 @@ void HttpClient::sendRequest(const std::string& request, Http& http, bool respon
 	if(request.empty()) throw HttpClientException("Request is empty.");
 
 	std::lock_guard<std::mutex> socketGuard(_socketMutex);
+	_reusable = false;
+	try
+	{
+		bool reusedConnection = _socket->connected();
+		connectAndWrite(request);
+
+		std::vector<char> pendingData;
+		try
+		{
+			readResponse(http, responseIsHeaderOnly, pendingData);
+		}
+		catch(const HttpClientSocketClosedException& ex)
+		{
+			//The server closed the idle connection before it received the request. Try once more on a new connection.
+			if(!reusedConnection) throw;
+			_socket->close();
+			http.reset();
+			_rawContent.clear();
+			pendingData.clear();
+			connectAndWrite(request);
+			readResponse(http, responseIsHeaderOnly, pendingData);
+		}
+		finishConnection(http, responseIsHeaderOnly, pendingData);
+	}
+	catch(...)
+	{
+		//The state of the connection is unknown. Never reuse it.
+		_socket->close();
+		throw;
+	}
+}
+
+void HttpClient::sendRequests(const std::vector<std::string>& requests, std::vector<Http>& responses)
+{
+	_rawContent.clear();
+	responses.clear();
+	if(requests.empty()) return;
+
+	std::string pipelinedRequests;
+	size_t size = 0;
+	for(auto& request : requests)
+	{
+		if(request.empty()) throw HttpClientException("Request is empty.");
+		size += request.size();
+	}
+	pipelinedRequests.reserve(size);
+	for(auto& request : requests)
+	{
+		pipelinedRequests.append(request);
+	}
+
+	std::lock_guard<std::mutex> socketGuard(_socketMutex);
+	_reusable = false;
+	try
+	{
+		bool reusedConnection = _socket->connected();
+		connectAndWrite(pipelinedRequests);
+
+		//Responses to pipelined requests are sent in order. Data received after the end of one response belongs to the next one.
+		responses.resize(requests.size());
+		std::vector<char> pendingData;
+		try
+		{
+			readResponse(responses.front(), false, pendingData);
+		}
+		catch(const HttpClientSocketClosedException& ex)
+		{
+			//None of the requests was answered, so it is safe to send all of them again on a new connection.
+			if(!reusedConnection) throw;
+			_socket->close();
+			responses.front().reset();
+			_rawContent.clear();
+			pendingData.clear();
+			connectAndWrite(pipelinedRequests);
+			readResponse(responses.front(), false, pendingData);
+		}
+		for(size_t i = 1; i < responses.size(); i++)
+		{
+			readResponse(responses[i], false, pendingData);
+		}
+		finishConnection(responses.back(), false, pendingData);
+	}
+	catch(...)
+	{
+		//Some of the pipelined responses might still be on the way. Never reuse the connection.
+		_socket->close();
+		throw;
+	}
+}
+
+void HttpClient::finishConnection(Http& http, bool responseIsHeaderOnly, const std::vector<char>& pendingData)
+{
+	bool serverCloses = (http.getHeader().connection & Http::Connection::Enum::close) || (http.getHeader().protocol == Http::Protocol::Enum::http10 && !(http.getHeader().connection & Http::Connection::Enum::keepAlive));
+	//Unread content or unexpected data would be mistaken for the next response.
+	if(!_keepAlive || serverCloses || responseIsHeaderOnly || !pendingData.empty()) _socket->close();
+	else _reusable = true;
+}
+
+void HttpClient::connectAndWrite(const std::string& request)
+{
     try
     {
         if(!_socket->connected()) _socket->open();
@@ -150,37 +252,50 @@ void HttpClient::sendRequest(const std::string& request, Http& http, bool respon
     }
     catch(const BaseLib::SocketDataLimitException& ex)
     {
-        if(!_keepAlive) _socket->close();
         throw HttpClientException("Unable to write to HTTP server \"" + _hostname + "\": " + ex.what());
     }
     catch(const BaseLib::SocketOperationException& ex)
     {
-        if(!_keepAlive) _socket->close();
         throw HttpClientException("Unable to write to HTTP server \"" + _hostname + "\": " + ex.what());
     }
 
+    std::this_thread::sleep_for(std::chrono::milliseconds(5)); //Some servers need a little, before the socket can be read.
+}
+
+void HttpClient::readResponse(Http& http, bool responseIsHeaderOnly, std::vector<char>& pendingData)
+{
+    bool receivedData = !pendingData.empty();
+    if(!pendingData.empty())
+    {
+        try
+        {
+            int32_t processedBytes = http.process(pendingData.data(), pendingData.size());
+            pendingData.erase(pendingData.begin(), pendingData.begin() + processedBytes);
+        }
+        catch(HttpException& ex)
+        {
+            throw HttpClientException("Unable to read from HTTP server \"" + _hostname + "\": " + ex.what(), ex.responseCode());
+        }
+        if(http.isFinished() || (http.headerIsFinished() && responseIsHeaderOnly))
+        {
+            http.setFinished();
+            return;
+        }
+    }
+
     ssize_t receivedBytes;
 
     int32_t bufferPos = 0;
     const int32_t bufferMax = 4096;
     std::array<char, bufferMax + 1> buffer{};
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(5)); //Some servers need a little, before the socket can be read.
-
     bool firstLoop = true;
     while(true)
     {
         if(!firstLoop && !_socket->connected())
         {
-            if(http.getContentSize() == 0 || http.getHeader().responseCode == -1)
-            {
-                throw HttpClientException("Unable to read from HTTP server \"" + _hostname + "\": Connection closed.");
-            }
-            else
-            {
-                http.setFinished();
-                break;
-            }
+            finishClosedResponse(http, receivedData);
+            break;
         }
         firstLoop = false;
 
@@ -192,29 +307,27 @@ void HttpClient::sendRequest(const std::string& request, Http& http, bool respon
                 throw HttpClientException("Unable to read from HTTP server \"" + _hostname + "\" (1): Buffer overflow.");
             }
             receivedBytes = _socket->proofread(buffer.data() + bufferPos, bufferMax - bufferPos);
+            if(receivedBytes > 0) receivedData = true;
 
             //Some clients send only one byte in the first packet
             if(receivedBytes < 13 && bufferPos == 0 && !http.headerIsFinished()) receivedBytes += _socket->proofread(buffer.data() + bufferPos + 1, bufferMax - bufferPos - 1);
         }
         catch(const BaseLib::SocketTimeOutException& ex)
         {
-            if(!_keepAlive) _socket->close();
             throw HttpClientException("Unable to read from HTTP server \"" + _hostname + "\" (1): " + ex.what());
         }
         catch(const BaseLib::SocketClosedException& ex)
         {
-            http.setFinished();
+            finishClosedResponse(http, receivedData);
             break;
         }
         catch(const BaseLib::SocketOperationException& ex)
         {
-            if(!_keepAlive) _socket->close();
             throw HttpClientException("Unable to read from HTTP server \"" + _hostname + "\" (3): " + ex.what());
         }
 
         if(bufferPos + receivedBytes > bufferMax)
         {
-            if(!_keepAlive) _socket->close();
             throw HttpClientException("Unable to read from HTTP server \"" + _hostname + "\" (2): Buffer overflow.");
         }
 
@@ -238,7 +351,8 @@ void HttpClient::sendRequest(const std::string& request, Http& http, bool respon
         try
         {
             if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: Received packet from HTTP server \"" + _hostname + "\": " + std::string(buffer.begin(), buffer.begin() + receivedBytes));
-            http.process(buffer.data(), receivedBytes);
+            int32_t processedBytes = http.process(buffer.data(), receivedBytes);
+            if(http.isFinished() && processedBytes < receivedBytes) pendingData.insert(pendingData.end(), buffer.begin() + processedBytes, buffer.begin() + receivedBytes);
             if(http.headerIsFinished() && responseIsHeaderOnly)
             {
                 http.setFinished();
@@ -247,18 +361,27 @@ void HttpClient::sendRequest(const std::string& request, Http& http, bool respon
         }
         catch(HttpException& ex)
         {
-            if(!_keepAlive) _socket->close();
             throw HttpClientException("Unable to read from HTTP server \"" + _hostname + "\": " + ex.what(), ex.responseCode());
         }
         if(http.getContentSize() > 104857600 || http.getHeader().contentLength > 104857600)
         {
-            if(!_keepAlive) _socket->close();
             throw HttpClientException("Unable to read from HTTP server \"" + _hostname + "\": Packet with data larger than 100 MiB received.");
         }
 
         if(http.isFinished()) break;
     }
-    if(!_keepAlive) _socket->close();
+}
+
+void HttpClient::finishClosedResponse(Http& http, bool receivedData)
+{
+    _socket->close();
+    if(!receivedData) throw HttpClientSocketClosedException("Unable to read from HTTP server \"" + _hostname + "\": Connection closed before a response was received.");
+    //Only responses without length information are terminated by closing the connection.
+    if(!http.headerIsFinished() || http.getHeader().contentLength > 0 || (http.getHeader().transferEncoding & Http::TransferEncoding::Enum::chunked))
+    {
+        throw HttpClientException("Unable to read from HTTP server \"" + _hostname + "\": Connection closed before the response was complete.");
+    }
+    http.setFinished();
 }
 
 }
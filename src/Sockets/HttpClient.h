@@ -143,6 +143,12 @@ public:
 	 */
 	bool connected() { return _socket && _socket->connected(); }
 
+	/**
+	 * Returns "true" when the last request completed cleanly and the connection can be used for the next request.
+	 * After any error the connection is closed and this method returns "false".
+	 */
+	bool isReusable() { return _reusable && connected(); }
+
 	/**
 	 * Closes the socket.
 	 */
@@ -167,7 +173,8 @@ public:
 	std::string getIpAddress() { return _socket ? _socket->getIpAddress() : ""; }
 
 	/*
-	 * Sends an HTTP request and returns the response.
+	 * Sends an HTTP request and returns the response. When a reused keep-alive connection is closed by the server
+	 * before the first byte of the response is received, the request is sent again once on a new connection.
 	 *
 	 * @param[in] request The HTTP request including the full header.
 	 * @param[out] response The HTTP response without the header.
@@ -215,6 +222,27 @@ public:
 	 * @param[out] dataOut The data returned.
 	 */
 	void post(const std::string& path, std::string& dataIn, Http& dataOut);
+
+	/*
+	 * Sends multiple HTTP requests at once using HTTP/1.1 pipelining and returns the responses in the same order. Only
+	 * use this for idempotent requests (e. g. GET) and only with servers supporting pipelining. When a reused connection
+	 * is closed before the first response starts, all requests are sent again once on a new connection. When it is
+	 * closed later, an exception is thrown.
+	 *
+	 * @param[in] requests The HTTP requests including the full headers.
+	 * @param[out] responses The HTTP responses.
+	 */
+	void sendRequests(const std::vector<std::string>& requests, std::vector<Http>& responses);
+
+	/*
+	 * Creates a GET or POST request with the headers used by get() and post().
+	 *
+	 * @param method The HTTP method.
+	 * @param path The path to request.
+	 * @param content The content to send or nullptr.
+	 * @return Returns the request.
+	 */
+	std::string constructRequest(const std::string& method, const std::string& path, const std::string* content);
 protected:
 	/**
 	 * The common base library object.
@@ -257,6 +285,43 @@ protected:
 	 * Stores the raw response
 	 */
 	std::vector<char> _rawContent;
+
+	/**
+	 * Set when the last request completed cleanly on a keep-alive connection.
+	 */
+	bool _reusable = false;
+
+	/**
+	 * Connects to the server if necessary and sends the request. _socketMutex needs to be locked.
+	 */
+	void connectAndWrite(const std::string& request);
+
+	/**
+	 * Reads one response. _socketMutex needs to be locked.
+	 *
+	 * @param http The object to store the response in.
+	 * @param responseIsHeaderOnly Stop reading after the header.
+	 * @param pendingData Received data not processed yet. It is processed first. Data received after the end of the response is appended.
+	 */
+	void readResponse(Http& http, bool responseIsHeaderOnly, std::vector<char>& pendingData);
+
+	/**
+	 * Finishes a response whose connection was closed by the server. This is only valid for responses without
+	 * "Content-Length" and without chunked transfer encoding. _socketMutex needs to be locked.
+	 *
+	 * @param http The response.
+	 * @param receivedData Set to "true" when at least one byte of the response was received.
+	 */
+	void finishClosedResponse(Http& http, bool receivedData);
+
+	/**
+	 * Closes the socket unless the connection can be used for another request. _socketMutex needs to be locked.
+	 *
+	 * @param http The last response received.
+	 * @param responseIsHeaderOnly "true" when the content of the response was not read.
+	 * @param pendingData Data received after the last response.
+	 */
+	void finishConnection(Http& http, bool responseIsHeaderOnly, const std::vector<char>& pendingData);
 };
 
 }
@@ -0,0 +1,151 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../BaseLib.h"
+#include "HttpClientPool.h"
+
+namespace BaseLib
+{
+
+HttpClientPool::HttpClientPool(BaseLib::SharedObjects* baseLib, uint32_t idleTimeout, uint32_t maxIdleClients)
+{
+	_bl = baseLib;
+	_data = std::make_shared<PoolData>();
+	_data->idleTimeout = idleTimeout;
+	_data->maxIdleClients = maxIdleClients;
+}
+
+HttpClientPool::~HttpClientPool()
+{
+	clear();
+}
+
+std::shared_ptr<HttpClient> HttpClientPool::getClient(const std::string& hostname, int32_t port, bool useSsl, const std::string& caFile, bool verifyCertificate, const std::string& certPath, const std::string& keyPath)
+{
+	std::string key;
+	key.reserve(hostname.size() + caFile.size() + certPath.size() + keyPath.size() + 16);
+	key.append(hostname).append(1, '\0').append(std::to_string(port)).append(1, '\0').append(useSsl ? "1" : "0").append(verifyCertificate ? "1" : "0").append(1, '\0').append(caFile).append(1, '\0').append(certPath).append(1, '\0').append(keyPath);
+
+	std::unique_ptr<HttpClient> client;
+	TcpSocket::PTlsSessionData tlsSessionData;
+	std::list<IdleClient> expiredClients;
+	{
+		std::lock_guard<std::mutex> poolGuard(_data->mutex);
+		collectGarbage(*_data, HelperFunctions::getTime(), expiredClients);
+		auto clientsIterator = _data->idleClients.find(key);
+		if(clientsIterator != _data->idleClients.end() && !clientsIterator->second.empty())
+		{
+			//Use the most recently released client. Its connection is the least likely to be closed by the server.
+			client = std::move(clientsIterator->second.back().client);
+			clientsIterator->second.pop_back();
+		}
+		else if(useSsl)
+		{
+			auto& sessionData = _data->tlsSessions[key];
+			if(!sessionData) sessionData = std::make_shared<TcpSocket::TlsSessionData>();
+			tlsSessionData = sessionData;
+		}
+	}
+	//Close expired connections without holding the mutex.
+	expiredClients.clear();
+
+	if(!client)
+	{
+		client.reset(new HttpClient(_bl, hostname, port, true, useSsl, caFile, verifyCertificate, certPath, keyPath));
+		if(tlsSessionData) client->getSocket()->setTlsSessionData(tlsSessionData);
+	}
+
+	std::weak_ptr<PoolData> data = _data;
+	return std::shared_ptr<HttpClient>(client.release(), [data, key](HttpClient* client) { release(data, key, client); });
+}
+
+void HttpClientPool::release(const std::weak_ptr<PoolData>& data, const std::string& key, HttpClient* client)
+{
+	std::unique_ptr<HttpClient> clientGuard(client);
+	try
+	{
+		std::shared_ptr<PoolData> poolData = data.lock();
+		if(!poolData || !client->isReusable()) return;
+		std::lock_guard<std::mutex> poolGuard(poolData->mutex);
+		auto& clients = poolData->idleClients[key];
+		if(clients.size() >= poolData->maxIdleClients) return;
+		IdleClient idleClient;
+		idleClient.client = std::move(clientGuard);
+		idleClient.releaseTime = HelperFunctions::getTime();
+		clients.push_back(std::move(idleClient));
+	}
+	catch(const std::exception&)
+	{
+		//The client is closed by clientGuard.
+	}
+}
+
+void HttpClientPool::collectGarbage()
+{
+	std::list<IdleClient> expiredClients;
+	{
+		std::lock_guard<std::mutex> poolGuard(_data->mutex);
+		collectGarbage(*_data, HelperFunctions::getTime(), expiredClients);
+	}
+}
+
+void HttpClientPool::collectGarbage(PoolData& data, int64_t time, std::list<IdleClient>& expiredClients)
+{
+	for(auto clientsIterator = data.idleClients.begin(); clientsIterator != data.idleClients.end();)
+	{
+		auto& clients = clientsIterator->second;
+		//Clients are sorted by release time
+		while(!clients.empty() && time - clients.front().releaseTime >= data.idleTimeout) expiredClients.splice(expiredClients.end(), clients, clients.begin());
+		if(clients.empty()) clientsIterator = data.idleClients.erase(clientsIterator);
+		else ++clientsIterator;
+	}
+}
+
+void HttpClientPool::clear()
+{
+	std::map<std::string, std::list<IdleClient>> idleClients;
+	{
+		std::lock_guard<std::mutex> poolGuard(_data->mutex);
+		idleClients.swap(_data->idleClients);
+	}
+}
+
+size_t HttpClientPool::idleClientCount()
+{
+	std::lock_guard<std::mutex> poolGuard(_data->mutex);
+	size_t count = 0;
+	for(auto& clients : _data->idleClients)
+	{
+		count += clients.second.size();
+	}
+	return count;
+}
+
+}
@@ -0,0 +1,131 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef HTTPCLIENTPOOL_H_
+#define HTTPCLIENTPOOL_H_
+
+#include "HttpClient.h"
+
+#include <list>
+#include <map>
+
+namespace BaseLib
+{
+
+/**
+ * Pool of keep-alive HttpClient objects. Clients are identified by hostname, port and TLS settings. A client returned
+ * by getClient() is exclusively used by the caller and automatically returned to the pool, when the last copy of the
+ * pointer is destroyed. Only clients whose last request completed cleanly are put back into the pool; after any error
+ * the connection is closed and the client discarded. Clients which are idle longer than the idle timeout are closed.
+ * TLS clients with the same key share their TLS session data, so new and reconnecting clients resume the last session
+ * instead of doing a full handshake. The class is thread safe.
+ *
+ * Example:
+ *
+ *     BaseLib::HttpClientPool pool(_bl);
+ *     std::string response;
+ *     pool.getClient("192.168.0.10", 80)->get("/status", response);
+ */
+class HttpClientPool
+{
+public:
+	/**
+	 * Constructor
+	 *
+	 * @param baseLib The common base library object.
+	 * @param idleTimeout (default 30000) The time in milliseconds after which idle connections are closed.
+	 * @param maxIdleClients (default 4) The maximum number of idle clients per key.
+	 */
+	HttpClientPool(BaseLib::SharedObjects* baseLib, uint32_t idleTimeout = 30000, uint32_t maxIdleClients = 4);
+
+	/**
+	 * Destructor. Closes all idle clients. Clients in use are closed when they are released.
+	 */
+	virtual ~HttpClientPool();
+
+	/**
+	 * Returns an idle client for the provided settings or creates a new one. For parameter descriptions see the
+	 * constructor of HttpClient. The client always uses keep-alive connections.
+	 *
+	 * @return Returns the client. It is returned to the pool automatically.
+	 */
+	std::shared_ptr<HttpClient> getClient(const std::string& hostname, int32_t port = 80, bool useSsl = false, const std::string& caFile = "", bool verifyCertificate = true, const std::string& certPath = "", const std::string& keyPath = "");
+
+	/**
+	 * Closes all clients idle longer than the idle timeout. This is also done on each call of getClient().
+	 */
+	void collectGarbage();
+
+	/**
+	 * Closes all idle clients. The TLS session data is kept.
+	 */
+	void clear();
+
+	/**
+	 * Returns the number of idle clients in the pool.
+	 */
+	size_t idleClientCount();
+
+	/**
+	 * Sets the time in milliseconds after which idle connections are closed.
+	 */
+	void setIdleTimeout(uint32_t value) { _data->idleTimeout = value; }
+private:
+	struct IdleClient
+	{
+		std::unique_ptr<HttpClient> client;
+		int64_t releaseTime = 0;
+	};
+
+	/**
+	 * The data shared with the deleters of the returned clients, so they can outlive the pool.
+	 */
+	struct PoolData
+	{
+		std::mutex mutex;
+		std::atomic<uint32_t> idleTimeout{30000};
+		uint32_t maxIdleClients = 4;
+		std::map<std::string, std::list<IdleClient>> idleClients;
+		std::map<std::string, TcpSocket::PTlsSessionData> tlsSessions;
+	};
+
+	BaseLib::SharedObjects* _bl = nullptr;
+	std::shared_ptr<PoolData> _data;
+
+	/**
+	 * Moves all clients idle longer than the idle timeout to "expiredClients". The caller closes them after unlocking the
+	 * pool mutex.
+	 */
+	static void collectGarbage(PoolData& data, int64_t time, std::list<IdleClient>& expiredClients);
+	static void release(const std::weak_ptr<PoolData>& data, const std::string& key, HttpClient* client);
+};
+
+}
+#endif
@@ -30,6 +30,7 @@
 
 #include "../BaseLib.h"
 #include "HttpServer.h"
+#include "../Encoding/GZip.h"
 
 namespace BaseLib
 {
@@ -54,6 +55,20 @@ HttpServer::HttpServer(BaseLib::SharedObjects* baseLib, HttpServerInfo& serverIn
     _connectionClosedCallback.swap(serverInfo.connectionClosedCallback);
 	_packetReceivedCallback.swap(serverInfo.packetReceivedCallback);
 
+	if(!serverInfo.contentPath.empty())
+	{
+		char* contentPath = realpath(serverInfo.contentPath.c_str(), nullptr);
+		if(contentPath)
+		{
+			_contentPath = contentPath;
+			free(contentPath);
+			if(_contentPath.back() == '/') _contentPath.pop_back();
+		}
+		else _bl->out.printError("Error: Content path " + serverInfo.contentPath + " does not exist.");
+	}
+	_staticFileCacheMaxFileSize = serverInfo.staticFileCacheMaxFileSize;
+	_staticFileCacheSize = serverInfo.staticFileCacheSize;
+
 	_socket = std::make_shared<TcpSocket>(baseLib, tcpServerInfo);
 }
 
@@ -140,7 +155,8 @@ void HttpServer::packetReceived(int32_t clientId, TcpSocket::TcpPacket& packet)
 			processedBytes = http->process((char*)(packet.data() + processedBytes), packet.size() - processedBytes);
 			if(http->isFinished())
 			{
-				if(_packetReceivedCallback) _packetReceivedCallback(clientId, *http);
+				if(!_contentPath.empty() && sendStaticFile(clientId, *http)) {}
+				else if(_packetReceivedCallback) _packetReceivedCallback(clientId, *http);
 				http->reset();
 			}
 		}
@@ -163,4 +179,197 @@ void HttpServer::send(int32_t clientId, const std::vector<char>& packet, bool cl
     _socket->sendToClient(clientId, packet, closeConnection);
 }
 
+bool HttpServer::sendStaticFile(int32_t clientId, Http& http)
+{
+	int32_t fileDescriptor = -1;
+	try
+	{
+		auto& header = http.getHeader();
+		if(_contentPath.empty() || (header.method != "GET" && header.method != "HEAD")) return false;
+
+		std::string path = _contentPath + header.path;
+		struct stat fileInfo{};
+		if(stat(path.c_str(), &fileInfo) == -1) return false;
+		if(S_ISDIR(fileInfo.st_mode))
+		{
+			if(path.back() != '/') path.push_back('/');
+			path.append("index.html");
+		}
+
+		//Don't follow symlinks pointing out of the content path.
+		char* realPath = realpath(path.c_str(), nullptr);
+		if(!realPath) return false;
+		path = realPath;
+		free(realPath);
+		if(path.compare(0, _contentPath.size() + 1, _contentPath + '/') != 0) return false;
+
+		fileDescriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if(fileDescriptor == -1) return false;
+		if(fstat(fileDescriptor, &fileInfo) == -1 || !S_ISREG(fileInfo.st_mode))
+		{
+			close(fileDescriptor);
+			return false;
+		}
+
+		std::string contentType;
+		auto extensionPosition = path.find_last_of("./");
+		if(extensionPosition != std::string::npos && path.at(extensionPosition) == '.')
+		{
+			std::string extension = path.substr(extensionPosition + 1);
+			contentType = http.getMimeType(HelperFunctions::toLower(extension));
+		}
+		if(contentType.empty()) contentType = "application/octet-stream";
+
+		bool compressible = _staticFileCacheMaxFileSize > 0 && isCompressible(contentType);
+		PCompressedFile compressedFile;
+		if(compressible && (header.acceptEncoding & Http::AcceptEncoding::Enum::gzip) && fileInfo.st_size <= (off_t)_staticFileCacheMaxFileSize)
+		{
+			compressedFile = getCompressedFile(path, fileDescriptor, fileInfo);
+		}
+
+		//Both representations need their own entity tag.
+		std::string entityTag = "\"" + HelperFunctions::getHexString((int64_t)fileInfo.st_mtim.tv_sec) + "-" + HelperFunctions::getHexString((int64_t)fileInfo.st_mtim.tv_nsec) + "-" + HelperFunctions::getHexString((int64_t)fileInfo.st_size) + (compressedFile ? "-gz\"" : "\"");
+
+		bool notModified = false;
+		auto fieldIterator = header.fields.find("if-none-match");
+		if(fieldIterator != header.fields.end()) notModified = fieldIterator->second == "*" || fieldIterator->second.find(entityTag) != std::string::npos;
+		else
+		{
+			fieldIterator = header.fields.find("if-modified-since");
+			if(fieldIterator != header.fields.end())
+			{
+				time_t modifiedSince = parseHttpDate(fieldIterator->second);
+				notModified = modifiedSince != -1 && fileInfo.st_mtime <= modifiedSince;
+			}
+		}
+
+		bool closeConnection = (header.connection & Http::Connection::Enum::close) || (header.protocol == Http::Protocol::Enum::http10 && !(header.connection & Http::Connection::Enum::keepAlive));
+		std::vector<std::string> additionalHeaders;
+		additionalHeaders.reserve(5);
+		additionalHeaders.push_back("ETag: " + entityTag);
+		additionalHeaders.push_back("Last-Modified: " + getHttpDate(fileInfo.st_mtime));
+		if(compressible) additionalHeaders.push_back("Vary: Accept-Encoding");
+		if(closeConnection) additionalHeaders.push_back("Connection: close");
+
+		std::string responseHeader;
+		if(notModified)
+		{
+			//A 304 response must not contain "Content-Length" when it differs from the one of the full response.
+			responseHeader.append("HTTP/1.1 304 Not Modified\r\n");
+			for(auto& additionalHeader : additionalHeaders)
+			{
+				responseHeader.append(additionalHeader).append("\r\n");
+			}
+			responseHeader.append("\r\n");
+			_socket->sendToClient(clientId, std::vector<char>(responseHeader.begin(), responseHeader.end()), closeConnection);
+		}
+		else if(compressedFile)
+		{
+			additionalHeaders.push_back("Content-Encoding: gzip");
+			Http::constructHeader(compressedFile->content.size(), contentType, 200, "OK", additionalHeaders, responseHeader);
+			std::vector<iovec> vectors{ iovec{ (void*)responseHeader.data(), responseHeader.size() } };
+			if(header.method != "HEAD") vectors.push_back(iovec{ (void*)compressedFile->content.data(), compressedFile->content.size() });
+			_socket->sendToClient(clientId, vectors, closeConnection);
+		}
+		else
+		{
+			Http::constructHeader(fileInfo.st_size, contentType, 200, "OK", additionalHeaders, responseHeader);
+			_socket->sendFileToClient(clientId, responseHeader, fileDescriptor, header.method == "HEAD" ? 0 : fileInfo.st_size, closeConnection);
+		}
+
+		close(fileDescriptor);
+		return true;
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	if(fileDescriptor != -1) close(fileDescriptor);
+	return false;
+}
+
+HttpServer::PCompressedFile HttpServer::getCompressedFile(const std::string& path, int32_t fileDescriptor, const struct stat& fileInfo)
+{
+	try
+	{
+		{
+			std::lock_guard<std::mutex> staticFileCacheGuard(_staticFileCacheMutex);
+			auto cacheIterator = _staticFileCache.find(path);
+			if(cacheIterator != _staticFileCache.end())
+			{
+				auto& file = *cacheIterator->second;
+				if(file->modificationTime == fileInfo.st_mtim.tv_sec && file->modificationTimeNanoseconds == fileInfo.st_mtim.tv_nsec && file->size == fileInfo.st_size)
+				{
+					_staticFileCacheList.splice(_staticFileCacheList.begin(), _staticFileCacheList, cacheIterator->second);
+					return _staticFileCacheList.front();
+				}
+			}
+		}
+
+		std::vector<char> content(fileInfo.st_size);
+		size_t bytesRead = 0;
+		while(bytesRead < content.size())
+		{
+			ssize_t result = pread(fileDescriptor, content.data() + bytesRead, content.size() - bytesRead, bytesRead);
+			if(result == -1 && errno == EINTR) continue;
+			if(result <= 0) return PCompressedFile(); //File changed while reading
+			bytesRead += result;
+		}
+
+		auto file = std::make_shared<CompressedFile>();
+		file->path = path;
+		file->modificationTime = fileInfo.st_mtim.tv_sec;
+		file->modificationTimeNanoseconds = fileInfo.st_mtim.tv_nsec;
+		file->size = fileInfo.st_size;
+		file->content = GZip::compress<std::string, std::vector<char>>(content, 9);
+
+		std::lock_guard<std::mutex> staticFileCacheGuard(_staticFileCacheMutex);
+		auto cacheIterator = _staticFileCache.find(path);
+		if(cacheIterator != _staticFileCache.end())
+		{
+			_staticFileCacheBytes -= (*cacheIterator->second)->content.size();
+			_staticFileCacheList.erase(cacheIterator->second);
+			_staticFileCache.erase(cacheIterator);
+		}
+		if(file->content.size() > _staticFileCacheSize) return file;
+		_staticFileCacheList.push_front(file);
+		_staticFileCache.emplace(path, _staticFileCacheList.begin());
+		_staticFileCacheBytes += file->content.size();
+		while(_staticFileCacheBytes > _staticFileCacheSize)
+		{
+			auto& leastRecentlyUsedFile = _staticFileCacheList.back();
+			_staticFileCacheBytes -= leastRecentlyUsedFile->content.size();
+			_staticFileCache.erase(leastRecentlyUsedFile->path);
+			_staticFileCacheList.pop_back();
+		}
+		return file;
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return PCompressedFile();
+}
+
+bool HttpServer::isCompressible(const std::string& contentType)
+{
+	return contentType.compare(0, 5, "text/") == 0 || contentType == "application/javascript" || contentType == "application/json" || contentType == "application/xml" || contentType == "image/svg+xml";
+}
+
+std::string HttpServer::getHttpDate(time_t time)
+{
+	std::tm timeInfo{};
+	gmtime_r(&time, &timeInfo);
+	std::array<char, 64> buffer{};
+	size_t size = strftime(buffer.data(), buffer.size(), "%a, %d %b %Y %H:%M:%S GMT", &timeInfo);
+	return std::string(buffer.data(), size);
+}
+
+time_t HttpServer::parseHttpDate(const std::string& date)
+{
+	std::tm timeInfo{};
+	if(!strptime(date.c_str(), "%a, %d %b %Y %H:%M:%S", &timeInfo)) return -1;
+	return timegm(&timeInfo);
+}
+
 }
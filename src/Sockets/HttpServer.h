@@ -37,6 +37,9 @@
 #include "TcpSocket.h"
 
 #include <atomic>
+#include <list>
+
+#include <sys/stat.h>
 
 namespace BaseLib
 {
@@ -134,6 +137,24 @@ public:
 		std::string dhParamData;
 		bool requireClientCert = false;
 
+		/**
+		 * When set, GET and HEAD requests for files in this directory are answered by the server itself and are not passed to
+		 * packetReceivedCallback. For directories "index.html" is sent.
+		 *
+		 * @see sendStaticFile()
+		 */
+		std::string contentPath;
+
+		/**
+		 * Compressible files up to this size are kept gzipped in memory for clients accepting gzip. 0 disables compression.
+		 */
+		uint32_t staticFileCacheMaxFileSize = 131072;
+
+		/**
+		 * The maximum total size of the gzipped files in memory. The least recently used files are removed first.
+		 */
+		uint32_t staticFileCacheSize = 4194304;
+
         std::function<void(int32_t clientId, std::string address, uint16_t port)> newConnectionCallback;
         std::function<void(int32_t clientId)> connectionClosedCallback;
 		std::function<void(int32_t clientId, Http& http)> packetReceivedCallback;
@@ -170,12 +191,34 @@ public:
 
 	void send(int32_t clientId, const TcpSocket::TcpPacket& packet, bool closeConnection = true);
 	void send(int32_t clientId, const std::vector<char>& packet, bool closeConnection = true);
+
+	/**
+	 * Answers a GET or HEAD request with a file from HttpServerInfo::contentPath. Unencrypted connections use sendfile(), so the
+	 * file content isn't copied to user space. "ETag", "If-None-Match" and "If-Modified-Since" are supported, so browsers can
+	 * revalidate their caches without downloading the file again. Small compressible files are sent gzipped when the client
+	 * accepts it.
+	 *
+	 * @param clientId The ID of the client the request was received from.
+	 * @param http The request.
+	 * @return Returns false if the request is not for an existing file in HttpServerInfo::contentPath. Nothing is sent in that case.
+	 */
+	bool sendStaticFile(int32_t clientId, Http& http);
 protected:
 	struct HttpClientInfo
 	{
 		std::shared_ptr<Http> http;
 	};
 
+	struct CompressedFile
+	{
+		std::string path;
+		time_t modificationTime = 0;
+		long modificationTimeNanoseconds = 0;
+		off_t size = 0;
+		std::string content;
+	};
+	typedef std::shared_ptr<CompressedFile> PCompressedFile;
+
 	BaseLib::SharedObjects* _bl = nullptr;
 	std::shared_ptr<TcpSocket> _socket;
 
@@ -186,9 +229,25 @@ protected:
     std::function<void(int32_t clientId)> _connectionClosedCallback;
 	std::function<void(int32_t clientId, Http& http)> _packetReceivedCallback;
 
+	std::string _contentPath;
+	uint32_t _staticFileCacheMaxFileSize = 0;
+	uint32_t _staticFileCacheSize = 0;
+	std::mutex _staticFileCacheMutex;
+	size_t _staticFileCacheBytes = 0;
+	std::list<PCompressedFile> _staticFileCacheList; //The most recently used file first
+	std::unordered_map<std::string, std::list<PCompressedFile>::iterator> _staticFileCache;
+
 	void newConnection(int32_t clientId, std::string address, uint16_t port);
 	void connectionClosed(int32_t clientId);
 	void packetReceived(int32_t clientId, TcpSocket::TcpPacket& packet);
+
+	/**
+	 * Returns the gzipped content of a file. The content is taken from the cache if the file didn't change.
+	 */
+	PCompressedFile getCompressedFile(const std::string& path, int32_t fileDescriptor, const struct stat& fileInfo);
+	static bool isCompressible(const std::string& contentType);
+	static std::string getHttpDate(time_t time);
+	static time_t parseHttpDate(const std::string& date);
 };
 
 }
@@ -191,10 +191,8 @@ void Ssdp::searchDevices(const std::string& stHeader, uint32_t timeout, std::vec
 		sendSearchBroadcast(serverSocketDescriptor, stHeader, timeout);
 
 		uint64_t startTime = _bl->hf.getTime();
-		std::array<char, 1024> buffer;
+		DatagramBatch batch(16, 1024);
 		int32_t bytesReceived = 0;
-		struct sockaddr_in si_other{};
-		socklen_t slen = sizeof(si_other);
 		fd_set readFileDescriptor;
 		timeval socketTimeout{};
 		int32_t nfds = 0;
@@ -234,24 +232,29 @@ void Ssdp::searchDevices(const std::string& stHeader, uint32_t timeout, std::vec
                     continue;
 				}
 
-				bytesReceived = recvfrom(serverSocketDescriptor->descriptor, buffer.data(), buffer.size(), 0, (struct sockaddr *)&si_other, &slen);
-				if(bytesReceived == 0)
-				{
-					http.reset();
-					continue;
-				}
+				//Read all queued responses with one system call. During discovery many devices answer at the same time.
+				bytesReceived = batch.receive(serverSocketDescriptor->descriptor);
+				if(bytesReceived == 0) continue;
                 else if(bytesReceived == -1)
                 {
                     _bl->out.printError("Error: Socket closed (3).");
                     _bl->fileDescriptorManager.shutdown(serverSocketDescriptor);
                     continue;
                 }
-				if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: SSDP response received:\n" + std::string(buffer.data(), bytesReceived));
-				http.process(buffer.data(), bytesReceived, false);
-				if(http.headerIsFinished())
+				for(size_t i = 0; i < batch.size(); i++)
 				{
-					processPacket(http, stHeader, info);
-					http.reset();
+					if(batch.length(i) == 0)
+					{
+						http.reset();
+						continue;
+					}
+					if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: SSDP response received:\n" + std::string(batch.data(i), batch.length(i)));
+					http.process(batch.data(i), batch.length(i), false);
+					if(http.headerIsFinished())
+					{
+						processPacket(http, stHeader, info);
+						http.reset();
+					}
 				}
 			}
 			catch(const std::exception& ex)
@@ -284,10 +287,8 @@ void Ssdp::searchDevicesPassive(const std::string& stHeader, uint32_t timeout, s
 		if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: Searching for SSDP devices ...");
 
 		uint64_t startTime = _bl->hf.getTime();
-		std::array<char, 1024> buffer;
+		DatagramBatch batch(16, 1024);
 		int32_t bytesReceived = 0;
-		struct sockaddr_in si_other{};
-		socklen_t slen = sizeof(si_other);
 		fd_set readFileDescriptor;
 		timeval socketTimeout{};
 		int32_t nfds = 0;
@@ -323,7 +324,7 @@ void Ssdp::searchDevicesPassive(const std::string& stHeader, uint32_t timeout, s
                     continue;
 				}
 
-				bytesReceived = recvfrom(serverSocketDescriptor->descriptor, buffer.data(), buffer.size(), 0, (struct sockaddr *)&si_other, &slen);
+				bytesReceived = batch.receive(serverSocketDescriptor->descriptor);
 				if(bytesReceived == 0) continue;
                 else if(bytesReceived == -1)
                 {
@@ -331,10 +332,14 @@ void Ssdp::searchDevicesPassive(const std::string& stHeader, uint32_t timeout, s
                     _bl->fileDescriptorManager.shutdown(serverSocketDescriptor);
                     continue;
                 }
-				if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: SSDP response received:\n" + std::string(buffer.data(), bytesReceived));
-				http.reset();
-				http.process(buffer.data(), bytesReceived, false);
-				if(http.headerIsFinished()) processPacketPassive(http, stHeader, info);
+				for(size_t i = 0; i < batch.size(); i++)
+				{
+					if(batch.length(i) == 0) continue;
+					if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: SSDP response received:\n" + std::string(batch.data(i), batch.length(i)));
+					http.reset();
+					http.process(batch.data(i), batch.length(i), false);
+					if(http.headerIsFinished()) processPacketPassive(http, stHeader, info);
+				}
 			}
 			catch(const std::exception& ex)
 			{
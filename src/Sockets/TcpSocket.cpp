@@ -160,6 +160,8 @@ TcpSocket::TcpSocket(BaseLib::SharedObjects* baseLib, TcpServerInfo& serverInfo)
 	_newConnectionCallback.swap(serverInfo.newConnectionCallback);
     _connectionClosedCallback.swap(serverInfo.connectionClosedCallback);
 	_packetReceivedCallback.swap(serverInfo.packetReceivedCallback);
+	_writeQueueHighWaterMark = serverInfo.writeQueueHighWaterMark;
+	_disconnectSlowClients = serverInfo.disconnectSlowClients;
 
     _serverThreads.resize(serverInfo.serverThreads);
 }
@@ -332,6 +334,15 @@ std::string TcpSocket::getIpAddress()
         return GNUTLS_E_SUCCESS;
     }
 
+    /**
+     * TLS push function for queued writes. Unlike GnuTLS' default it doesn't block, so gnutls_record_send() returns GNUTLS_E_AGAIN
+     * when the socket buffer is full.
+     */
+    ssize_t nonBlockingTlsPush(gnutls_transport_ptr_t transport, const void* data, size_t size)
+    {
+        return send((int)(uintptr_t)transport, data, size, MSG_NOSIGNAL | MSG_DONTWAIT);
+    }
+
 	void TcpSocket::initClientSsl(PTcpClientData& clientData)
 	{
 		if(!_tlsPriorityCache)
@@ -439,34 +450,212 @@ std::string TcpSocket::getIpAddress()
 		}
 		catch(const std::exception& ex)
 		{
-			_bl->fileDescriptorManager.close(clientData->fileDescriptor);
-            if(_connectionClosedCallback) _connectionClosedCallback(clientData->id);
+			closeClient(clientData);
 		}
 	}
 
+	TcpSocket::PTcpClientData TcpSocket::getClientData(int32_t clientId)
+	{
+		ClientShard& shard = getClientShard(clientId);
+		std::lock_guard<std::mutex> clientsGuard(shard.mutex);
+		auto clientIterator = shard.clients.find(clientId);
+		if(clientIterator == shard.clients.end()) return PTcpClientData();
+		return clientIterator->second;
+	}
+
+	void TcpSocket::closeClient(const PTcpClientData& clientData)
+	{
+		//The server thread, the write queue and the send methods can all detect a closed connection. Only the first one closes it.
+		if(clientData->closed.exchange(true)) return;
+		_bl->fileDescriptorManager.close(clientData->fileDescriptor);
+		if(_connectionClosedCallback) _connectionClosedCallback(clientData->id);
+	}
+
+	ssize_t TcpSocket::sendNonBlocking(TcpClientData& clientData, const iovec* vectors, size_t count)
+	{
+		if(!clientData.fileDescriptor || clientData.fileDescriptor->descriptor == -1) return -1;
+		if(count == 0) return 0;
+
+		ssize_t bytesWritten = 0;
+		if(clientData.fileDescriptor->tlsSession)
+		{
+			do
+			{
+				bytesWritten = gnutls_record_send(clientData.fileDescriptor->tlsSession, vectors[0].iov_base, vectors[0].iov_len);
+			} while(bytesWritten == GNUTLS_E_INTERRUPTED);
+			if(bytesWritten == GNUTLS_E_AGAIN) return 0;
+			if(bytesWritten < 0) return -1;
+		}
+		else
+		{
+			msghdr message{};
+			message.msg_iov = (iovec*)vectors;
+			message.msg_iovlen = count;
+			do
+			{
+				bytesWritten = sendmsg(clientData.fileDescriptor->descriptor, &message, MSG_NOSIGNAL | MSG_DONTWAIT);
+			} while(bytesWritten == -1 && errno == EINTR);
+			if(bytesWritten == -1) return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+		}
+		return bytesWritten;
+	}
+
+	bool TcpSocket::flushWriteQueue(TcpClientData& clientData)
+	{
+		std::array<iovec, 64> vectors{};
+		while(!clientData.writeQueue.empty())
+		{
+			size_t count = 0;
+			for(auto& buffer : clientData.writeQueue)
+			{
+				if(count == vectors.size()) break;
+				size_t offset = (count == 0) ? clientData.writeQueueOffset : 0;
+				vectors[count].iov_base = (void*)(buffer.data() + offset);
+				vectors[count].iov_len = buffer.size() - offset;
+				count++;
+			}
+
+			ssize_t bytesWritten = sendNonBlocking(clientData, vectors.data(), count);
+			if(bytesWritten == -1) return false;
+			if(bytesWritten == 0) return true;
+
+			clientData.writeQueueSize -= bytesWritten;
+			while(bytesWritten > 0)
+			{
+				size_t remainingBytes = clientData.writeQueue.front().size() - clientData.writeQueueOffset;
+				if((size_t)bytesWritten < remainingBytes)
+				{
+					clientData.writeQueueOffset += bytesWritten;
+					break;
+				}
+				bytesWritten -= remainingBytes;
+				clientData.writeQueue.pop_front();
+				clientData.writeQueueOffset = 0;
+			}
+		}
+		return true;
+	}
+
+	void TcpSocket::queuePacket(const PTcpClientData& clientData, const iovec* vectors, size_t count, bool closeConnection)
+	{
+		size_t size = 0;
+		for(size_t i = 0; i < count; i++)
+		{
+			size += vectors[i].iov_len;
+		}
+
+		bool slowClient = false;
+		bool error = false;
+		bool close = false;
+		{
+			std::lock_guard<std::mutex> writeQueueGuard(clientData->writeQueueMutex);
+			if(clientData->writeQueueSize + size > _writeQueueHighWaterMark)
+			{
+				_droppedPackets++;
+				_droppedBytes += size;
+				if(!_disconnectSlowClients) return;
+				_droppedBytes += clientData->writeQueueSize;
+				clientData->writeQueue.clear();
+				clientData->writeQueueOffset = 0;
+				clientData->writeQueueSize = 0;
+				slowClient = true;
+			}
+			else
+			{
+				bool queueWasEmpty = clientData->writeQueue.empty();
+				size_t bytesWritten = 0;
+				if(queueWasEmpty)
+				{
+					//Try to write directly from "vectors", so nothing needs to be copied in the common case.
+					ssize_t result = sendNonBlocking(*clientData, vectors, count);
+					if(result == -1) error = true;
+					else bytesWritten = result;
+				}
+
+				if(!error)
+				{
+					for(size_t i = 0; i < count; i++)
+					{
+						if(bytesWritten >= vectors[i].iov_len)
+						{
+							bytesWritten -= vectors[i].iov_len;
+							continue;
+						}
+						const char* data = (const char*)vectors[i].iov_base;
+						clientData->writeQueue.emplace_back(data + bytesWritten, data + vectors[i].iov_len);
+						clientData->writeQueueSize += vectors[i].iov_len - bytesWritten;
+						bytesWritten = 0;
+					}
+					if(!queueWasEmpty && !flushWriteQueue(*clientData)) error = true;
+				}
+
+				if(closeConnection)
+				{
+					if(clientData->writeQueue.empty()) close = true;
+					else clientData->closeWhenWritten = true;
+				}
+			}
+		}
+
+		if(slowClient)
+		{
+			_slowClientDisconnects++;
+			_bl->out.printInfo("Info: Disconnecting client " + std::to_string(clientData->id) + ", because it doesn't read its data fast enough.");
+		}
+		if(slowClient || error || close) closeClient(clientData);
+	}
+
+	void TcpSocket::processWriteQueue(const PTcpClientData& clientData)
+	{
+		bool close = false;
+		{
+			std::lock_guard<std::mutex> writeQueueGuard(clientData->writeQueueMutex);
+			if(!flushWriteQueue(*clientData)) close = true;
+			else if(clientData->writeQueue.empty() && clientData->closeWhenWritten) close = true;
+		}
+		if(close) closeClient(clientData);
+	}
+
+	TcpSocket::WriteQueueMetrics TcpSocket::getWriteQueueMetrics()
+	{
+		WriteQueueMetrics metrics;
+		for(auto& shard : _clientShards)
+		{
+			std::lock_guard<std::mutex> clientsGuard(shard.mutex);
+			for(auto& client : shard.clients)
+			{
+				size_t queuedBytes = client.second->writeQueueSize;
+				metrics.queuedBytes += queuedBytes;
+				if(queuedBytes > metrics.maxClientQueuedBytes) metrics.maxClientQueuedBytes = queuedBytes;
+			}
+		}
+		metrics.droppedPackets = _droppedPackets;
+		metrics.droppedBytes = _droppedBytes;
+		metrics.slowClientDisconnects = _slowClientDisconnects;
+		return metrics;
+	}
+
 	void TcpSocket::sendToClient(int32_t clientId, const TcpPacket& packet, bool closeConnection)
 	{
 		PTcpClientData clientData;
 		try
 		{
+			clientData = getClientData(clientId);
+			if(!clientData) return;
+
+			if(_writeQueueHighWaterMark > 0)
 			{
-				std::lock_guard<std::mutex> clientsGuard(_clientsMutex);
-				auto clientIterator = _clients.find(clientId);
-				if(clientIterator == _clients.end()) return;
-				clientData = clientIterator->second;
+				iovec vector{ (void*)packet.data(), packet.size() };
+				queuePacket(clientData, &vector, 1, closeConnection);
+				return;
 			}
 
 			clientData->socket->proofwrite((char*)packet.data(), packet.size());
-			if(closeConnection)
-			{
-				_bl->fileDescriptorManager.close(clientData->fileDescriptor);
-				if(_connectionClosedCallback) _connectionClosedCallback(clientData->id);
-			}
+			if(closeConnection) closeClient(clientData);
 		}
 		catch(const std::exception& ex)
 		{
-			_bl->fileDescriptorManager.close(clientData->fileDescriptor);
-			if(_connectionClosedCallback) _connectionClosedCallback(clientData->id);
+			if(clientData) closeClient(clientData);
 		}
 	}
 
@@ -475,33 +664,84 @@ std::string TcpSocket::getIpAddress()
 		PTcpClientData clientData;
 		try
 		{
+			clientData = getClientData(clientId);
+			if(!clientData) return;
+
+			if(_writeQueueHighWaterMark > 0)
 			{
-				std::lock_guard<std::mutex> clientsGuard(_clientsMutex);
-				auto clientIterator = _clients.find(clientId);
-				if(clientIterator == _clients.end()) return;
-				clientData = clientIterator->second;
+				iovec vector{ (void*)packet.data(), packet.size() };
+				queuePacket(clientData, &vector, 1, closeConnection);
+				return;
 			}
 
 			clientData->socket->proofwrite((char*)packet.data(), packet.size());
-			if(closeConnection)
+			if(closeConnection) closeClient(clientData);
+		}
+		catch(const std::exception& ex)
+		{
+			if(clientData) closeClient(clientData);
+		}
+	}
+
+	void TcpSocket::sendToClient(int32_t clientId, const std::vector<iovec>& vectors, bool closeConnection)
+	{
+		PTcpClientData clientData;
+		try
+		{
+			clientData = getClientData(clientId);
+			if(!clientData) return;
+
+			if(_writeQueueHighWaterMark > 0)
 			{
-				_bl->fileDescriptorManager.close(clientData->fileDescriptor);
-				if(_connectionClosedCallback) _connectionClosedCallback(clientData->id);
+				queuePacket(clientData, vectors.data(), vectors.size(), closeConnection);
+				return;
 			}
+
+			clientData->socket->proofwrite(vectors);
+			if(closeConnection) closeClient(clientData);
 		}
 		catch(const std::exception& ex)
 		{
-			_bl->fileDescriptorManager.close(clientData->fileDescriptor);
-			if(_connectionClosedCallback) _connectionClosedCallback(clientData->id);
+			if(clientData) closeClient(clientData);
+		}
+	}
+
+	void TcpSocket::sendFileToClient(int32_t clientId, const std::string& header, int32_t fileDescriptor, size_t size, bool closeConnection)
+	{
+		PTcpClientData clientData;
+		try
+		{
+			clientData = getClientData(clientId);
+			if(!clientData) return;
+
+			if(_writeQueueHighWaterMark > 0)
+			{
+				//Queued writes must not block, so the response is queued in one piece. A response larger than the queue can never be
+				//queued and a partially queued response would corrupt the stream, so the connection is closed in that case.
+				if(header.size() + size > _writeQueueHighWaterMark) throw SocketDataLimitException("File is larger than the write queue.");
+				std::vector<char> fileData(size);
+				if(size > 0 && readFile(fileDescriptor, fileData.data(), size, 0) != size) throw SocketOperationException("Unexpected end of file.");
+				std::array<iovec, 2> vectors{ iovec{ (void*)header.data(), header.size() }, iovec{ fileData.data(), size } };
+				queuePacket(clientData, vectors.data(), size > 0 ? 2 : 1, closeConnection);
+				return;
+			}
+
+			clientData->socket->proofwriteFile(header, fileDescriptor, size);
+			if(closeConnection) closeClient(clientData);
+		}
+		catch(const std::exception& ex)
+		{
+			if(clientData) closeClient(clientData);
 		}
 	}
 
 	void TcpSocket::closeClientConnection(int32_t clientId)
 	{
+        auto clientData = getClientData(clientId);
+        if(clientData)
         {
-            std::lock_guard<std::mutex> clientsGuard(_clientsMutex);
-            auto clientIterator = _clients.find(clientId);
-            if(clientIterator != _clients.end()) clientIterator->second->socket->close();
+            if(clientData->closed.exchange(true)) return;
+            clientData->socket->close();
         }
 
         if(_connectionClosedCallback) _connectionClosedCallback(clientId);
@@ -509,15 +749,13 @@ std::string TcpSocket::getIpAddress()
 
     int32_t TcpSocket::clientCount()
     {
-        std::lock_guard<std::mutex> clientsGuard(_clientsMutex);
-        return _clients.size();
+        return _clientCount;
     }
 
     std::string TcpSocket::getClientCertDn(int32_t clientId)
     {
-        std::lock_guard<std::mutex> clientsGuard(_clientsMutex);
-        auto clientIterator = _clients.find(clientId);
-        if(clientIterator != _clients.end()) return clientIterator->second->clientCertDn;
+        auto clientData = getClientData(clientId);
+        if(clientData) return clientData->clientCertDn;
         return "";
     }
 
@@ -546,8 +784,10 @@ std::string TcpSocket::getIpAddress()
 				timeout.tv_sec = 0;
 				timeout.tv_usec = 100000;
 				fd_set readFileDescriptor;
+				fd_set writeFileDescriptor;
 				int32_t maxfd = 0;
 				FD_ZERO(&readFileDescriptor);
+				FD_ZERO(&writeFileDescriptor);
 				{
 					auto fileDescriptorGuard = _bl->fileDescriptorManager.getLock();
 					fileDescriptorGuard.lock();
@@ -559,15 +799,16 @@ std::string TcpSocket::getIpAddress()
 						{
 							if(!client.second->fileDescriptor || client.second->fileDescriptor->descriptor == -1) continue;
 							FD_SET(client.second->fileDescriptor->descriptor, &readFileDescriptor);
+							if(client.second->writeQueueSize > 0) FD_SET(client.second->fileDescriptor->descriptor, &writeFileDescriptor);
 							if(client.second->fileDescriptor->descriptor > maxfd) maxfd = client.second->fileDescriptor->descriptor;
 						}
 					}
 				}
 
-				result = select(maxfd + 1, &readFileDescriptor, nullptr, nullptr, &timeout);
+				result = select(maxfd + 1, &readFileDescriptor, &writeFileDescriptor, nullptr, &timeout);
 				if(result == 0)
 				{
-					if(HelperFunctions::getTime() - _lastGarbageCollection > 60000 || _clients.size() >= _maxConnections)
+					if(HelperFunctions::getTime() - _lastGarbageCollection > 60000 || _clientCount >= _maxConnections)
                     {
                         collectGarbage();
                         collectGarbage(clients);
@@ -581,6 +822,15 @@ std::string TcpSocket::getIpAddress()
 					continue;
 				}
 
+				if(_writeQueueHighWaterMark > 0)
+				{
+					for(auto& client : clients)
+					{
+						if(!client.second->fileDescriptor || client.second->fileDescriptor->descriptor == -1) continue;
+						if(FD_ISSET(client.second->fileDescriptor->descriptor, &writeFileDescriptor)) processWriteQueue(client.second);
+					}
+				}
+
 				if (FD_ISSET(socketDescriptor, &readFileDescriptor) && !_stopServer)
 				{
 					struct sockaddr_storage clientInfo{};
@@ -605,10 +855,10 @@ std::string TcpSocket::getIpAddress()
 						}
 						std::string address = std::string(ipString);
 
-						if(_clients.size() > _maxConnections)
+						if(_clientCount > _maxConnections)
 						{
 							collectGarbage();
-							if(_clients.size() > _maxConnections)
+							if(_clientCount > _maxConnections)
 							{
                                 _bl->out.printError("Error: No more clients can connect to me as the maximum number of allowed connections is reached. Listen IP: " + _listenAddress + ", bound port: " + _listenPort + ", client IP: " + ipString);
 								_bl->fileDescriptorManager.shutdown(clientFileDescriptor);
@@ -630,13 +880,19 @@ std::string TcpSocket::getIpAddress()
 						clientData->socket->setReadTimeout(100000);
 						clientData->socket->setWriteTimeout(15000000);
 
-                        if(_useSsl) initClientSsl(clientData);
+                        if(_useSsl)
+                        {
+                            initClientSsl(clientData);
+                            if(_writeQueueHighWaterMark > 0) gnutls_transport_set_push_function(clientData->fileDescriptor->tlsSession, &nonBlockingTlsPush);
+                        }
 
 						{
-                            std::lock_guard<std::mutex> clientsGuard(_clientsMutex);
 							currentClientId = _currentClientId++;
 							clientData->id = currentClientId;
-							_clients[currentClientId] = clientData;
+							ClientShard& shard = getClientShard(currentClientId);
+							std::lock_guard<std::mutex> clientsGuard(shard.mutex);
+							shard.clients[currentClientId] = clientData;
+							_clientCount++;
 						}
 
 						clients[currentClientId] = clientData;
@@ -660,7 +916,7 @@ std::string TcpSocket::getIpAddress()
 				{
 					for(auto& client : clients)
 					{
-						if(client.second->fileDescriptor->descriptor == -1) continue;
+						if(!client.second->fileDescriptor || client.second->fileDescriptor->descriptor == -1) continue;
 						if(FD_ISSET(client.second->fileDescriptor->descriptor, &readFileDescriptor))
 						{
 							clientData = client.second;
@@ -684,18 +940,19 @@ std::string TcpSocket::getIpAddress()
 	{
 		_lastGarbageCollection = BaseLib::HelperFunctions::getTime();
 
-		std::lock_guard<std::mutex> clientsGuard(_clientsMutex);
-		std::vector<int32_t> clientsToRemove;
+		for(auto& shard : _clientShards)
 		{
-			for(auto& client : _clients)
+			std::lock_guard<std::mutex> clientsGuard(shard.mutex);
+			for(auto clientIterator = shard.clients.begin(); clientIterator != shard.clients.end();)
 			{
-				if(!client.second->fileDescriptor || client.second->fileDescriptor->descriptor == -1) clientsToRemove.push_back(client.first);
+				if(!clientIterator->second->fileDescriptor || clientIterator->second->fileDescriptor->descriptor == -1)
+				{
+					clientIterator = shard.clients.erase(clientIterator);
+					_clientCount--;
+				}
+				else clientIterator++;
 			}
 		}
-		for(auto& client : clientsToRemove)
-		{
-			_clients.erase(client);
-		}
 	}
 
     void TcpSocket::collectGarbage(std::map<int32_t, PTcpClientData>& clients)
@@ -788,7 +1045,7 @@ PFileDescriptor TcpSocket::bindAndReturnSocket(FileDescriptorManager& fileDescri
 		socketDescriptor.reset();
 		throw SocketOperationException("Error: Could get port listening on: " + std::string(strerror(error)));
 	}
-	listenPort = addressInfo.sin_port;
+	listenPort = ntohs(addressInfo.sin_port);
 
 	try
     {
@@ -1070,9 +1327,41 @@ void TcpSocket::close()
 	std::unique_lock<std::mutex> readGuard(_readMutex, std::defer_lock);
 	std::unique_lock<std::mutex> writeGuard(_writeMutex, std::defer_lock);
 	std::lock(readGuard, writeGuard);
+	//With TLS 1.3 session tickets are sent after the handshake, so get the latest session data before closing.
+	storeTlsSessionData();
 	_bl->fileDescriptorManager.close(_socketDescriptor);
 }
 
+void TcpSocket::setTlsSessionResumption(bool value)
+{
+	std::unique_lock<std::mutex> readGuard(_readMutex, std::defer_lock);
+	std::unique_lock<std::mutex> writeGuard(_writeMutex, std::defer_lock);
+	std::lock(readGuard, writeGuard);
+	if(!value) _tlsSessionData.reset();
+	else if(!_tlsSessionData) _tlsSessionData = std::make_shared<TlsSessionData>();
+}
+
+void TcpSocket::setTlsSessionData(const PTlsSessionData& value)
+{
+	std::unique_lock<std::mutex> readGuard(_readMutex, std::defer_lock);
+	std::unique_lock<std::mutex> writeGuard(_writeMutex, std::defer_lock);
+	std::lock(readGuard, writeGuard);
+	_tlsSessionData = value;
+}
+
+void TcpSocket::storeTlsSessionData()
+{
+	if(!_tlsSessionData || _isServer || !_socketDescriptor || !_socketDescriptor->tlsSession) return;
+	gnutls_datum_t sessionData{};
+	if(gnutls_session_get_data2(_socketDescriptor->tlsSession, &sessionData) != GNUTLS_E_SUCCESS) return;
+	if(sessionData.data && sessionData.size > 0)
+	{
+		std::lock_guard<std::mutex> sessionDataGuard(_tlsSessionData->mutex);
+		_tlsSessionData->data.assign(sessionData.data, sessionData.data + sessionData.size);
+	}
+	gnutls_free(sessionData.data);
+}
+
 int32_t TcpSocket::proofread(char* buffer, int32_t bufferSize)
 {
 	bool moreData = false;
@@ -1363,6 +1652,265 @@ int32_t TcpSocket::proofwrite(const char* buffer, int32_t bytesToWrite)
 	return totalBytesWritten;
 }
 
+int32_t TcpSocket::proofwrite(const std::vector<iovec>& vectors)
+{
+	if(!_socketDescriptor) throw SocketOperationException("Socket descriptor is nullptr.");
+	std::unique_lock<std::mutex> writeGuard(_writeMutex);
+	if(!connected())
+	{
+		writeGuard.unlock();
+		autoConnect();
+		writeGuard.lock();
+	}
+
+	return writeVectors(writeGuard, vectors);
+}
+
+int32_t TcpSocket::writeVectors(std::unique_lock<std::mutex>& writeGuard, const std::vector<iovec>& vectors)
+{
+	size_t bytesToWrite = 0;
+	std::vector<iovec> remainingVectors;
+	remainingVectors.reserve(vectors.size());
+	for(auto& vector : vectors)
+	{
+		if(vector.iov_len == 0) continue;
+		bytesToWrite += vector.iov_len;
+		remainingVectors.push_back(vector);
+	}
+	if(bytesToWrite == 0) return 0;
+	if(bytesToWrite > 104857600) throw SocketDataLimitException("Data size is larger than 100 MiB.");
+
+	if(_socketDescriptor->tlsSession)
+	{
+		//In corked mode GnuTLS only buffers the data. It is encrypted and sent in as few records as possible on uncork.
+		gnutls_record_cork(_socketDescriptor->tlsSession);
+		for(auto& vector : remainingVectors)
+		{
+			ssize_t result = 0;
+			do
+			{
+				result = gnutls_record_send(_socketDescriptor->tlsSession, vector.iov_base, vector.iov_len);
+			} while(result == GNUTLS_E_INTERRUPTED || result == GNUTLS_E_AGAIN);
+			if(result < 0)
+			{
+				gnutls_record_uncork(_socketDescriptor->tlsSession, 0);
+				writeGuard.unlock();
+				close();
+				throw SocketOperationException(gnutls_strerror(result));
+			}
+		}
+	}
+
+	size_t vectorIndex = 0;
+	size_t totalBytesWritten = 0;
+	while(totalBytesWritten < bytesToWrite)
+	{
+		timeval timeout{};
+		int32_t seconds = _writeTimeout / 1000000;
+		timeout.tv_sec = seconds;
+		timeout.tv_usec = _writeTimeout - (1000000 * seconds);
+		fd_set writeFileDescriptor;
+		FD_ZERO(&writeFileDescriptor);
+		auto fileDescriptorGuard = _bl->fileDescriptorManager.getLock();
+		fileDescriptorGuard.lock();
+		int32_t nfds = _socketDescriptor->descriptor + 1;
+		if(nfds <= 0)
+		{
+			fileDescriptorGuard.unlock();
+			writeGuard.unlock();
+			close();
+			throw SocketClosedException("Connection to client number " + std::to_string(_socketDescriptor->id) + " closed (4).");
+		}
+		FD_SET(_socketDescriptor->descriptor, &writeFileDescriptor);
+		fileDescriptorGuard.unlock();
+		int32_t readyFds = select(nfds, NULL, &writeFileDescriptor, NULL, &timeout);
+		if(readyFds == 0)
+		{
+			if(_socketDescriptor->tlsSession) gnutls_record_discard_queued(_socketDescriptor->tlsSession);
+			throw SocketTimeOutException("Writing to socket timed out.");
+		}
+		if(readyFds != 1)
+		{
+			writeGuard.unlock();
+			close();
+			throw SocketClosedException("Connection to client number " + std::to_string(_socketDescriptor->id) + " closed (5).");
+		}
+
+		ssize_t bytesWritten = 0;
+		if(_socketDescriptor->tlsSession)
+		{
+			do
+			{
+				bytesWritten = gnutls_record_uncork(_socketDescriptor->tlsSession, 0);
+			} while(bytesWritten == GNUTLS_E_INTERRUPTED);
+			if(bytesWritten == GNUTLS_E_AGAIN) continue;
+			if(bytesWritten >= 0)
+			{
+				//The corked buffer is sent completely.
+				totalBytesWritten = bytesToWrite;
+				break;
+			}
+		}
+		else
+		{
+			msghdr message{};
+			message.msg_iov = remainingVectors.data() + vectorIndex;
+			message.msg_iovlen = std::min(remainingVectors.size() - vectorIndex, (size_t)IOV_MAX);
+			do
+			{
+				bytesWritten = sendmsg(_socketDescriptor->descriptor, &message, MSG_NOSIGNAL);
+			} while(bytesWritten == -1 && (errno == EAGAIN || errno == EINTR));
+		}
+		if(bytesWritten <= 0)
+		{
+			writeGuard.unlock();
+			close();
+			writeGuard.lock();
+			if(_socketDescriptor->tlsSession)
+			{
+				throw SocketOperationException(gnutls_strerror(bytesWritten));
+			}
+			else
+			{
+				throw SocketOperationException(strerror(errno));
+			}
+		}
+
+		totalBytesWritten += bytesWritten;
+		while(bytesWritten > 0 && vectorIndex < remainingVectors.size())
+		{
+			iovec& vector = remainingVectors[vectorIndex];
+			if((size_t)bytesWritten < vector.iov_len)
+			{
+				vector.iov_base = (char*)vector.iov_base + bytesWritten;
+				vector.iov_len -= bytesWritten;
+				break;
+			}
+			bytesWritten -= vector.iov_len;
+			vectorIndex++;
+		}
+	}
+	return totalBytesWritten;
+}
+
+size_t TcpSocket::readFile(int32_t fileDescriptor, char* buffer, size_t length, off_t offset)
+{
+	size_t totalBytesRead = 0;
+	while(totalBytesRead < length)
+	{
+		ssize_t bytesRead = pread(fileDescriptor, buffer + totalBytesRead, length - totalBytesRead, offset + totalBytesRead);
+		if(bytesRead == -1)
+		{
+			if(errno == EINTR) continue;
+			throw SocketOperationException("Could not read file: " + std::string(strerror(errno)));
+		}
+		if(bytesRead == 0) break;
+		totalBytesRead += bytesRead;
+	}
+	return totalBytesRead;
+}
+
+int64_t TcpSocket::proofwriteFile(const std::string& header, int32_t fileDescriptor, size_t size)
+{
+	if(!_socketDescriptor) throw SocketOperationException("Socket descriptor is nullptr.");
+	std::unique_lock<std::mutex> writeGuard(_writeMutex);
+	if(!connected())
+	{
+		writeGuard.unlock();
+		autoConnect();
+		writeGuard.lock();
+	}
+
+	if(_socketDescriptor->tlsSession)
+	{
+		//GnuTLS needs the data in user space to encrypt it. The file is read with pread() instead of being mapped, as accessing a
+		//mapping beyond the end of a file truncated in the meantime raises SIGBUS. The write lock is held for the whole file, so
+		//other writes can't end up in the middle of it.
+		const size_t chunkSize = 1048576;
+		if(_fileBuffer.size() < std::min(size, chunkSize)) _fileBuffer.resize(std::min(size, chunkSize));
+		int64_t totalBytesWritten = 0;
+		size_t offset = 0;
+		do
+		{
+			size_t length = std::min(size - offset, chunkSize);
+			if(length > 0 && readFile(fileDescriptor, _fileBuffer.data(), length, offset) != length)
+			{
+				//The promised amount of data can't be sent anymore, so the connection needs to be closed.
+				writeGuard.unlock();
+				close();
+				throw SocketOperationException("Unexpected end of file.");
+			}
+			std::vector<iovec> vectors;
+			vectors.reserve(2);
+			if(offset == 0) vectors.push_back(iovec{ (void*)header.data(), header.size() });
+			if(length > 0) vectors.push_back(iovec{ _fileBuffer.data(), length });
+			totalBytesWritten += writeVectors(writeGuard, vectors);
+			offset += length;
+		} while(offset < size);
+		return totalBytesWritten;
+	}
+
+	size_t bytesToWrite = header.size() + size;
+	size_t totalBytesWritten = 0;
+	off_t fileOffset = 0;
+	while(totalBytesWritten < bytesToWrite)
+	{
+		timeval timeout{};
+		int32_t seconds = _writeTimeout / 1000000;
+		timeout.tv_sec = seconds;
+		timeout.tv_usec = _writeTimeout - (1000000 * seconds);
+		fd_set writeFileDescriptor;
+		FD_ZERO(&writeFileDescriptor);
+		auto fileDescriptorGuard = _bl->fileDescriptorManager.getLock();
+		fileDescriptorGuard.lock();
+		int32_t nfds = _socketDescriptor->descriptor + 1;
+		if(nfds <= 0)
+		{
+			fileDescriptorGuard.unlock();
+			writeGuard.unlock();
+			close();
+			throw SocketClosedException("Connection to client number " + std::to_string(_socketDescriptor->id) + " closed (4).");
+		}
+		FD_SET(_socketDescriptor->descriptor, &writeFileDescriptor);
+		fileDescriptorGuard.unlock();
+		int32_t readyFds = select(nfds, NULL, &writeFileDescriptor, NULL, &timeout);
+		if(readyFds == 0) throw SocketTimeOutException("Writing to socket timed out.");
+		if(readyFds != 1)
+		{
+			writeGuard.unlock();
+			close();
+			throw SocketClosedException("Connection to client number " + std::to_string(_socketDescriptor->id) + " closed (5).");
+		}
+
+		ssize_t bytesWritten = 0;
+		if(totalBytesWritten < header.size())
+		{
+			//MSG_MORE keeps the kernel from sending the header in a packet of its own.
+			do
+			{
+				bytesWritten = send(_socketDescriptor->descriptor, header.data() + totalBytesWritten, header.size() - totalBytesWritten, MSG_NOSIGNAL | (size > 0 ? MSG_MORE : 0));
+			} while(bytesWritten == -1 && (errno == EAGAIN || errno == EINTR));
+		}
+		else
+		{
+			do
+			{
+				bytesWritten = sendfile(_socketDescriptor->descriptor, fileDescriptor, &fileOffset, size - fileOffset);
+			} while(bytesWritten == -1 && (errno == EAGAIN || errno == EINTR));
+		}
+		if(bytesWritten <= 0)
+		{
+			//When the file got shorter, the promised amount of data can't be sent anymore, so the connection needs to be closed, too.
+			std::string error = bytesWritten == 0 ? "Unexpected end of file." : strerror(errno);
+			writeGuard.unlock();
+			close();
+			throw SocketOperationException(error);
+		}
+		totalBytesWritten += bytesWritten;
+	}
+	return totalBytesWritten;
+}
+
 int32_t TcpSocket::proofwrite(const std::string& data)
 {
 	if(!_socketDescriptor) throw SocketOperationException("Socket descriptor is nullptr.");
@@ -1464,7 +2012,9 @@ void TcpSocket::getSocketDescriptor()
 	std::unique_lock<std::mutex> writeGuard(_writeMutex, std::defer_lock);
 	std::lock(readGuard, writeGuard);
 	if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: Calling getFileDescriptor...");
+	storeTlsSessionData();
 	_bl->fileDescriptorManager.shutdown(_socketDescriptor);
+	_tlsSessionResumed = false;
 
 	try
 	{
@@ -1525,15 +2075,27 @@ void TcpSocket::getSsl()
 			throw SocketSslException("Could not set server's hostname: " + std::string(gnutls_strerror(result)));
 		}
 	}
+	if(_tlsSessionData)
+	{
+		std::lock_guard<std::mutex> sessionDataGuard(_tlsSessionData->mutex);
+		//Failing to set the session data is not fatal. A full handshake is done in that case.
+		if(!_tlsSessionData->data.empty() && gnutls_session_set_data(_socketDescriptor->tlsSession, _tlsSessionData->data.data(), _tlsSessionData->data.size()) != GNUTLS_E_SUCCESS) _tlsSessionData->data.clear();
+	}
 	do
 	{
 		result = gnutls_handshake(_socketDescriptor->tlsSession);
 	} while (result < 0 && gnutls_error_is_fatal(result) == 0);
 	if(result != GNUTLS_E_SUCCESS)
 	{
+		if(_tlsSessionData)
+		{
+			std::lock_guard<std::mutex> sessionDataGuard(_tlsSessionData->mutex);
+			_tlsSessionData->data.clear();
+		}
 		_bl->fileDescriptorManager.shutdown(_socketDescriptor);
 		throw SocketSslHandshakeFailedException("Error during TLS handshake: " + std::string(gnutls_strerror(result)));
 	}
+	_tlsSessionResumed = gnutls_session_is_resumed(_socketDescriptor->tlsSession) != 0;
 
 	//Now verify the certificate
 	uint32_t serverCertChainLength = 0;
@@ -1586,7 +2148,8 @@ void TcpSocket::getSsl()
         }
 		gnutls_x509_crt_deinit(serverCert);
 	}
-	_bl->out.printInfo("Info: SSL handshake with client " + std::to_string(_socketDescriptor->id) + " completed successfully.");
+	storeTlsSessionData();
+	_bl->out.printInfo("Info: SSL handshake with client " + std::to_string(_socketDescriptor->id) + " completed successfully" + (_tlsSessionResumed ? " (session resumed)." : "."));
 }
 
 void TcpSocket::getConnection()
@@ -36,8 +36,10 @@
 
 #include <thread>
 #include <string>
+#include <array>
 #include <vector>
 #include <list>
+#include <deque>
 #include <iterator>
 #include <mutex>
 #include <memory>
@@ -56,6 +58,8 @@
 #include <netinet/in.h> //Needed for BSD
 #include <netdb.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/sendfile.h>
 #include <sys/un.h>
 #include <errno.h>
 #include <poll.h>
@@ -165,6 +169,21 @@ public:
 		std::vector<uint8_t> buffer;
 		std::shared_ptr<TcpSocket> socket;
         std::string clientCertDn;
+		/**
+		 * Set by the first close of the connection, so the connection closed callback is called only once per client.
+		 */
+		std::atomic_bool closed{false};
+
+		// {{{ Queued writes (see TcpServerInfo::writeQueueHighWaterMark)
+			std::mutex writeQueueMutex;
+			std::deque<std::vector<char>> writeQueue;
+			/**
+			 * Number of bytes of the first element of "writeQueue" already written.
+			 */
+			size_t writeQueueOffset = 0;
+			std::atomic<size_t> writeQueueSize{0};
+			bool closeWhenWritten = false;
+		// }}}
 
 		TcpClientData()
 		{
@@ -196,6 +215,35 @@ public:
 		std::function<void(int32_t clientId, std::string address, uint16_t port)> newConnectionCallback;
 		std::function<void(int32_t clientId)> connectionClosedCallback;
 		std::function<void(int32_t clientId, TcpPacket& packet)> packetReceivedCallback;
+
+		/**
+		 * When not 0, sendToClient() doesn't block. Data that can't be written immediately is queued per client and written by the
+		 * server thread when the socket becomes writable. When the queue of a client would exceed this number of bytes, the client
+		 * is disconnected or, if "disconnectSlowClients" is false, the packet is dropped. When 0, sendToClient() blocks until the
+		 * data is written or the write timeout is reached.
+		 */
+		size_t writeQueueHighWaterMark = 0;
+		bool disconnectSlowClients = true;
+	};
+
+	/**
+	 * Statistics about the write queues of a server. See TcpServerInfo::writeQueueHighWaterMark.
+	 */
+	struct WriteQueueMetrics
+	{
+		/**
+		 * The bytes currently queued for all clients.
+		 */
+		size_t queuedBytes = 0;
+
+		/**
+		 * The bytes currently queued for the client with the largest queue.
+		 */
+		size_t maxClientQueuedBytes = 0;
+
+		uint64_t droppedPackets = 0;
+		uint64_t droppedBytes = 0;
+		uint64_t slowClientDisconnects = 0;
 	};
 
 	// {{{ TCP server or client
@@ -326,6 +374,41 @@ public:
      * @param hostname The compare the certificate's common name to.
      */
     void setVerificationHostname(std::string hostname) { close(); _verificationHostname = hostname; }
+
+    /**
+     * TLS session parameters of the last connection to a server. Can be shared by sockets connecting to the same server with
+     * the same TLS settings (see setTlsSessionData()).
+     */
+    struct TlsSessionData
+    {
+        std::mutex mutex;
+        std::vector<uint8_t> data;
+    };
+    typedef std::shared_ptr<TlsSessionData> PTlsSessionData;
+
+    /**
+     * Only relevant for TLS client connections. When enabled, the TLS session parameters of the last connection are
+     * stored and used to resume the session on the next connect, which avoids a full handshake. Disabled by default.
+     *
+     * @param value Set to true to resume TLS sessions.
+     */
+    void setTlsSessionResumption(bool value);
+
+    /**
+     * Only relevant for TLS client connections. Enables TLS session resumption and stores the session parameters in "value",
+     * so other sockets connecting to the same server can resume the session, too. Only share the object between sockets
+     * with the same hostname, port and TLS settings.
+     *
+     * @param value The shared session data or nullptr to disable session resumption.
+     */
+    void setTlsSessionData(const PTlsSessionData& value);
+
+    /**
+     * Only relevant for TLS client connections.
+     *
+     * @return Returns true when the current connection was established by resuming a previous TLS session.
+     */
+    bool tlsSessionResumed() { return _tlsSessionResumed; }
 	std::unordered_map<std::string, gnutls_certificate_credentials_t>& getCredentials() { return _x509Credentials; }
 
 	/**
@@ -408,6 +491,36 @@ public:
      */
 	int32_t proofwrite(const char* buffer, int32_t bytesToWrite);
 
+    /**
+     * Writes several buffers to a socket as if they were one (scatter-gather). Use it to send e. g. a header and a body without
+     * concatenating them first. Unencrypted data is written with sendmsg(). For TLS connections the buffers are collected into as
+     * few records as possible (see gnutls_record_cork()).
+     *
+     * @param vectors The buffers to write in this order.
+     * @returns Returns the number of bytes written. Never returns a negative number.
+     * @throws SocketOperationException Thrown when socket is nullptr.
+     * @throws SocketDataLimitException Thrown when trying to send more than 104857600 bytes of data.
+     * @throws SocketTimeOutException Thrown when writing times out.
+     * @throws SocketClosedException Thrown when socket is closed.
+     */
+	int32_t proofwrite(const std::vector<iovec>& vectors);
+
+    /**
+     * Writes "header" followed by the content of a file to the socket. Unencrypted data is passed to the kernel with sendfile(), so
+     * the file content never enters user space. For TLS connections the file is read in chunks into a buffer reused by all calls.
+     * No other write can happen until the whole file is written. When the file gets shorter while it is sent, the connection is
+     * closed.
+     *
+     * @param header Data to write before the file content, e. g. an HTTP header. Can be empty.
+     * @param fileDescriptor The descriptor of the file to send, opened for reading.
+     * @param size The number of bytes to send from the start of the file.
+     * @returns Returns the number of bytes written including the header.
+     * @throws SocketOperationException Thrown when socket is nullptr or the file can't be read.
+     * @throws SocketTimeOutException Thrown when writing times out.
+     * @throws SocketClosedException Thrown when socket is closed.
+     */
+	int64_t proofwriteFile(const std::string& header, int32_t fileDescriptor, size_t size);
+
 	void open();
 	void close();
 
@@ -482,6 +595,30 @@ public:
          */
         void sendToClient(int32_t clientId, const std::vector<char>& packet, bool closeConnection = false);
 
+        /**
+         * Sends several buffers to a TCP client connected to the server as if they were one, e. g. a header and a body.
+         *
+         * @param clientId The ID of the client as passed to TcpSocket::TcpServerServer::packetReceivedCallback.
+         * @param vectors The buffers to send in this order.
+         * @param closeConnection Close the connection after sending the data.
+         * @see proofwrite(const std::vector<iovec>&)
+         */
+        void sendToClient(int32_t clientId, const std::vector<iovec>& vectors, bool closeConnection = false);
+
+        /**
+         * Sends "header" followed by the content of a file to a TCP client connected to the server. When writes are queued (see
+         * TcpServerInfo::writeQueueHighWaterMark), the file is read completely and queued in one piece. Responses larger than the
+         * high water mark can't be queued, the connection is closed in that case.
+         *
+         * @param clientId The ID of the client as passed to TcpSocket::TcpServerServer::packetReceivedCallback.
+         * @param header Data to send before the file content, e. g. an HTTP header.
+         * @param fileDescriptor The descriptor of the file to send, opened for reading.
+         * @param size The number of bytes to send from the start of the file.
+         * @param closeConnection Close the connection after sending the data.
+         * @see proofwriteFile()
+         */
+        void sendFileToClient(int32_t clientId, const std::string& header, int32_t fileDescriptor, size_t size, bool closeConnection = false);
+
         /**
          * Closes the connection to a connected client.
          *
@@ -495,6 +632,11 @@ public:
          */
         int32_t clientCount();
 
+        /**
+         * Returns the current queue sizes and the number of dropped packets and disconnected clients since the server was created.
+         */
+        WriteQueueMetrics getWriteQueueMetrics();
+
         /**
          * Returns the distinguished name of the client certificate. This method only returns a non empty string if
          * the client certificate is valid.
@@ -527,6 +669,11 @@ protected:
 		std::string _dhParamFile;
 		std::string _dhParamData;
 		bool _requireClientCert = false;
+		size_t _writeQueueHighWaterMark = 0;
+		bool _disconnectSlowClients = true;
+		std::atomic<uint64_t> _droppedPackets{0};
+		std::atomic<uint64_t> _droppedBytes{0};
+		std::atomic<uint64_t> _slowClientDisconnects{0};
 		std::function<void(int32_t clientId, std::string address, uint16_t port)> _newConnectionCallback;
 		std::function<void(int32_t clientId)> _connectionClosedCallback;
 		std::function<void(int32_t clientId, TcpPacket& packet)> _packetReceivedCallback;
@@ -546,20 +693,47 @@ protected:
 		/**
 		 * Stores the current client ID. The client ID is incremented by one for every client, so it is unique for a long time.
 		 */
-		int32_t _currentClientId = 0;
-		std::mutex _clientsMutex;
-		std::map<int32_t, PTcpClientData> _clients;
+		std::atomic_int _currentClientId{0};
+
+		/**
+		 * The clients are distributed over several shards by their ID, so looking up clients (e. g. when sending events to many
+		 * clients from different threads) doesn't serialize on a single lock. Writes to a client are serialized by the client's own
+		 * socket, so no shard lock is held while writing.
+		 */
+		struct ClientShard
+		{
+			std::mutex mutex;
+			std::unordered_map<int32_t, PTcpClientData> clients;
+		};
+		static const uint32_t _clientShardCount = 16;
+		std::array<ClientShard, _clientShardCount> _clientShards;
+		std::atomic_uint _clientCount{0};
 	// }}}
 
 	std::mutex _socketDescriptorMutex;
 	PFileDescriptor _socketDescriptor;
 	bool _useSsl = false;
 	std::unordered_map<std::string, gnutls_certificate_credentials_t> _x509Credentials;
+	bool _tlsSessionResumed = false;
+	PTlsSessionData _tlsSessionData;
+	std::vector<char> _fileBuffer; //Protected by _writeMutex
 
 	void getSocketDescriptor();
 	void getConnection();
 	void getSsl();
 	void initSsl();
+	void storeTlsSessionData();
+
+	/**
+	 * Writes "vectors" to the socket. "writeGuard" must be locked.
+	 */
+	int32_t writeVectors(std::unique_lock<std::mutex>& writeGuard, const std::vector<iovec>& vectors);
+
+	/**
+	 * Reads up to "length" bytes starting at "offset" from a file with pread(). Only returns less than "length" at the end of the
+	 * file.
+	 */
+	static size_t readFile(int32_t fileDescriptor, char* buffer, size_t length, off_t offset);
 	void autoConnect();
     void freeCredentials();
 
@@ -571,6 +745,26 @@ protected:
 		void collectGarbage(std::map<int32_t, PTcpClientData>& clients);
 		void initClientSsl(PTcpClientData& clientData);
 		void readClient(PTcpClientData clientData);
+		ClientShard& getClientShard(int32_t clientId) { return _clientShards[(uint32_t)clientId % _clientShardCount]; }
+		PTcpClientData getClientData(int32_t clientId);
+		void closeClient(const PTcpClientData& clientData);
+
+		/**
+		 * Writes as much of "vectors" to the client as possible without blocking. For TLS connections only the first vector is
+		 * written.
+		 *
+		 * @return Returns the number of bytes written or -1 on error.
+		 */
+		ssize_t sendNonBlocking(TcpClientData& clientData, const iovec* vectors, size_t count);
+
+		/**
+		 * Writes the client's queue until it is empty or the socket would block. "clientData.writeQueueMutex" must be locked.
+		 *
+		 * @return Returns false on error.
+		 */
+		bool flushWriteQueue(TcpClientData& clientData);
+		void queuePacket(const PTcpClientData& clientData, const iovec* vectors, size_t count, bool closeConnection);
+		void processWriteQueue(const PTcpClientData& clientData);
 	// }}}
 };
 
@@ -0,0 +1,395 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../BaseLib.h"
+#include "UdpServer.h"
+
+#include <sys/epoll.h>
+#include <poll.h>
+
+namespace BaseLib
+{
+
+UdpServer::UdpServer(BaseLib::SharedObjects* baseLib, UdpServerInfo& serverInfo)
+{
+	_bl = baseLib;
+	_bufferCount = serverInfo.bufferCount > 0 ? serverInfo.bufferCount : 1;
+	_bufferSize = serverInfo.bufferSize > 0 ? serverInfo.bufferSize : 1;
+	_sendTimeout = serverInfo.sendTimeout;
+	_packetReceivedCallback = serverInfo.packetReceivedCallback;
+
+	_epollDescriptor = _bl->fileDescriptorManager.add(epoll_create1(EPOLL_CLOEXEC));
+	if(!_epollDescriptor || _epollDescriptor->descriptor == -1) throw SocketOperationException("Could not create epoll instance: " + std::string(strerror(errno)));
+}
+
+UdpServer::~UdpServer()
+{
+	waitForServerStopped();
+	_bl->fileDescriptorManager.close(_epollDescriptor);
+}
+
+PFileDescriptor UdpServer::bindSocket(const std::string& address, const std::string& port, std::string& listenAddress, int32_t& listenPort)
+{
+	PFileDescriptor socketDescriptor;
+	addrinfo hostInfo{};
+	addrinfo* serverInfo = nullptr;
+
+	hostInfo.ai_family = AF_UNSPEC;
+	hostInfo.ai_socktype = SOCK_DGRAM;
+	hostInfo.ai_flags = AI_PASSIVE;
+	int32_t result = getaddrinfo(address.c_str(), port.c_str(), &hostInfo, &serverInfo);
+	if(result != 0) throw SocketOperationException("Error: Could not get address information: " + std::string(gai_strerror(result)));
+
+	int32_t yes = 1;
+	bool bound = false;
+	int32_t error = 0;
+	for(struct addrinfo* info = serverInfo; info != nullptr; info = info->ai_next)
+	{
+		socketDescriptor = _bl->fileDescriptorManager.add(socket(info->ai_family, info->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, info->ai_protocol));
+		if(socketDescriptor->descriptor == -1)
+		{
+			error = errno;
+			continue;
+		}
+		if(setsockopt(socketDescriptor->descriptor, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(int32_t)) == -1 ||
+		   bind(socketDescriptor->descriptor.load(), info->ai_addr, info->ai_addrlen) == -1)
+		{
+			error = errno;
+			_bl->fileDescriptorManager.close(socketDescriptor);
+			continue;
+		}
+		bound = true;
+		break;
+	}
+	freeaddrinfo(serverInfo);
+	if(!bound)
+	{
+		if(error == EADDRINUSE) throw SocketAddressInUseException("Error: Could not bind UDP socket to port " + port + ": " + std::string(strerror(error)));
+		else throw SocketBindException("Error: Could not bind UDP socket to port " + port + ": " + std::string(strerror(error)));
+	}
+
+	struct sockaddr_storage addressInfo{};
+	socklen_t addressInfoLength = sizeof(addressInfo);
+	if(getsockname(socketDescriptor->descriptor, (struct sockaddr*)&addressInfo, &addressInfoLength) == -1)
+	{
+		error = errno;
+		_bl->fileDescriptorManager.close(socketDescriptor);
+		throw SocketOperationException("Error: Could not get port listening on: " + std::string(strerror(error)));
+	}
+	std::array<char, INET6_ADDRSTRLEN + 1> ipStringBuffer{};
+	if(addressInfo.ss_family == AF_INET)
+	{
+		auto* s = (struct sockaddr_in*)&addressInfo;
+		inet_ntop(AF_INET, &s->sin_addr, ipStringBuffer.data(), ipStringBuffer.size());
+		listenPort = ntohs(s->sin_port);
+	}
+	else
+	{
+		auto* s = (struct sockaddr_in6*)&addressInfo;
+		inet_ntop(AF_INET6, &s->sin6_addr, ipStringBuffer.data(), ipStringBuffer.size());
+		listenPort = ntohs(s->sin6_port);
+	}
+	ipStringBuffer.back() = 0;
+	listenAddress = std::string(ipStringBuffer.data());
+
+	try
+	{
+		if(listenAddress == "0.0.0.0") listenAddress = Net::getMyIpAddress();
+		else if(listenAddress == "::") listenAddress = Net::getMyIp6Address();
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->fileDescriptorManager.close(socketDescriptor);
+		throw;
+	}
+
+	return socketDescriptor;
+}
+
+int32_t UdpServer::addListener(std::string address, std::string port, std::string& listenAddress, int32_t& listenPort, PacketReceivedCallback packetReceivedCallback)
+{
+	auto listener = std::make_shared<Listener>();
+	listener->fileDescriptor = bindSocket(address, port, listenAddress, listenPort);
+	listener->address = address;
+	listener->port = port;
+	listener->listenAddress = listenAddress;
+	listener->listenPort = listenPort;
+	listener->packetReceivedCallback = packetReceivedCallback ? std::move(packetReceivedCallback) : _packetReceivedCallback;
+
+	std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+	listener->id = _currentListenerId++;
+	if(_currentListenerId < 0) _currentListenerId = 0;
+
+	struct epoll_event event{};
+	event.events = EPOLLIN;
+	event.data.u32 = (uint32_t)listener->id;
+	if(epoll_ctl(_epollDescriptor->descriptor, EPOLL_CTL_ADD, listener->fileDescriptor->descriptor, &event) == -1)
+	{
+		int32_t error = errno;
+		_bl->fileDescriptorManager.close(listener->fileDescriptor);
+		throw SocketOperationException("Error: Could not add UDP socket to epoll: " + std::string(strerror(error)));
+	}
+	_listeners.emplace(listener->id, listener);
+	return listener->id;
+}
+
+void UdpServer::removeListener(int32_t listenerId)
+{
+	try
+	{
+		std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+		auto listenerIterator = _listeners.find(listenerId);
+		if(listenerIterator == _listeners.end()) return;
+		if(listenerIterator->second->fileDescriptor->descriptor != -1) epoll_ctl(_epollDescriptor->descriptor, EPOLL_CTL_DEL, listenerIterator->second->fileDescriptor->descriptor, nullptr);
+		_bl->fileDescriptorManager.close(listenerIterator->second->fileDescriptor);
+		_listeners.erase(listenerIterator);
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+size_t UdpServer::listenerCount()
+{
+	std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+	return _listeners.size();
+}
+
+void UdpServer::openListeners()
+{
+	std::vector<PListener> closedListeners;
+	{
+		std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+		for(auto& listener : _listeners)
+		{
+			if(listener.second->fileDescriptor->descriptor == -1) closedListeners.push_back(listener.second);
+		}
+	}
+
+	for(auto& listener : closedListeners)
+	{
+		//Bind to the port used before, so listeners with a dynamically assigned port keep it.
+		std::string listenAddress;
+		int32_t listenPort = -1;
+		auto fileDescriptor = bindSocket(listener->address, std::to_string(listener->listenPort), listenAddress, listenPort);
+
+		std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+		auto listenerIterator = _listeners.find(listener->id);
+		if(listenerIterator == _listeners.end() || listenerIterator->second != listener)
+		{
+			_bl->fileDescriptorManager.close(fileDescriptor);
+			continue;
+		}
+
+		struct epoll_event event{};
+		event.events = EPOLLIN;
+		event.data.u32 = (uint32_t)listener->id;
+		if(epoll_ctl(_epollDescriptor->descriptor, EPOLL_CTL_ADD, fileDescriptor->descriptor, &event) == -1)
+		{
+			int32_t error = errno;
+			_bl->fileDescriptorManager.close(fileDescriptor);
+			throw SocketOperationException("Error: Could not add UDP socket to epoll: " + std::string(strerror(error)));
+		}
+		//sendToClient() uses listeners without holding _listenersMutex, so the listener is replaced instead of modified.
+		auto openedListener = std::make_shared<Listener>(*listener);
+		openedListener->fileDescriptor = fileDescriptor;
+		openedListener->listenAddress = listenAddress;
+		listenerIterator->second = openedListener;
+	}
+}
+
+void UdpServer::startServer()
+{
+	if(!_stopServer) return;
+	_bl->threadManager.join(_serverThread);
+	openListeners();
+	_stopServer = false;
+	_bl->threadManager.start(_serverThread, true, &UdpServer::serverThread, this);
+}
+
+int32_t UdpServer::startServer(std::string address, std::string port, std::string& listenAddress)
+{
+	//When the server is restarted, the listener added by the last start is reopened instead of adding a second one.
+	int32_t listenerId = -1;
+	{
+		std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+		for(auto& listener : _listeners)
+		{
+			if(listener.second->fileDescriptor->descriptor == -1 && listener.second->address == address && listener.second->port == port)
+			{
+				listenerId = listener.first;
+				break;
+			}
+		}
+	}
+	if(listenerId == -1)
+	{
+		int32_t listenPort = -1;
+		listenerId = addListener(address, port, listenAddress, listenPort);
+	}
+	startServer();
+	std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+	auto listenerIterator = _listeners.find(listenerId);
+	if(listenerIterator != _listeners.end()) listenAddress = listenerIterator->second->listenAddress;
+	return listenerId;
+}
+
+void UdpServer::stopServer()
+{
+	_stopServer = true;
+}
+
+void UdpServer::waitForServerStopped()
+{
+	_stopServer = true;
+	_bl->threadManager.join(_serverThread);
+
+	//The listeners are kept, so startServer() can open them again.
+	std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+	for(auto& listener : _listeners)
+	{
+		if(listener.second->fileDescriptor->descriptor != -1) epoll_ctl(_epollDescriptor->descriptor, EPOLL_CTL_DEL, listener.second->fileDescriptor->descriptor, nullptr);
+		_bl->fileDescriptorManager.close(listener.second->fileDescriptor);
+	}
+}
+
+void UdpServer::sendToClient(int32_t listenerId, const std::string& ip, uint16_t port, const std::vector<uint8_t>& data)
+{
+	PListener listener;
+	{
+		std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+		auto listenerIterator = _listeners.find(listenerId);
+		if(listenerIterator == _listeners.end()) throw SocketInvalidParametersException("Unknown listener ID: " + std::to_string(listenerId));
+		listener = listenerIterator->second;
+	}
+
+	struct sockaddr_storage address{};
+	socklen_t addressLength = 0;
+	auto* address4 = (struct sockaddr_in*)&address;
+	auto* address6 = (struct sockaddr_in6*)&address;
+	if(inet_pton(AF_INET, ip.c_str(), &address4->sin_addr) == 1)
+	{
+		address4->sin_family = AF_INET;
+		address4->sin_port = htons(port);
+		addressLength = sizeof(struct sockaddr_in);
+	}
+	else if(inet_pton(AF_INET6, ip.c_str(), &address6->sin6_addr) == 1)
+	{
+		address6->sin6_family = AF_INET6;
+		address6->sin6_port = htons(port);
+		addressLength = sizeof(struct sockaddr_in6);
+	}
+	else throw SocketInvalidParametersException("Invalid IP address: " + ip);
+
+	auto endTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(_sendTimeout);
+	while(true)
+	{
+		ssize_t bytesWritten = sendto(listener->fileDescriptor->descriptor, (const char*)data.data(), data.size(), 0, (struct sockaddr*)&address, addressLength);
+		if(bytesWritten != -1) return;
+		if(errno == EINTR) continue;
+		if(errno != EAGAIN && errno != EWOULDBLOCK) throw SocketOperationException("Could not send UDP packet to " + ip + ": " + std::string(strerror(errno)));
+
+		//The socket is non-blocking. Instead of spinning, wait until there is room in the send buffer again.
+		int64_t remainingTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - std::chrono::steady_clock::now()).count();
+		if(remainingTime <= 0) throw SocketTimeOutException("Timeout sending UDP packet to " + ip + ": Send buffer is full.");
+		struct pollfd pollInfo{};
+		pollInfo.fd = listener->fileDescriptor->descriptor;
+		pollInfo.events = POLLOUT;
+		if(poll(&pollInfo, 1, (int)remainingTime) == -1 && errno != EINTR) throw SocketOperationException("Could not send UDP packet to " + ip + ": " + std::string(strerror(errno)));
+	}
+}
+
+void UdpServer::serverThread()
+{
+	DatagramBatch batch(_bufferCount, _bufferSize);
+	std::array<struct epoll_event, 64> events{};
+	UdpPacket packet;
+	while(!_stopServer)
+	{
+		try
+		{
+			int32_t eventCount = epoll_wait(_epollDescriptor->descriptor, events.data(), events.size(), 100);
+			if(eventCount == -1)
+			{
+				if(errno == EINTR) continue;
+				_bl->out.printError("Error: epoll_wait returned -1: " + std::string(strerror(errno)));
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+				continue;
+			}
+
+			for(int32_t i = 0; i < eventCount && !_stopServer; i++)
+			{
+				PListener listener;
+				{
+					std::lock_guard<std::mutex> listenersGuard(_listenersMutex);
+					auto listenerIterator = _listeners.find((int32_t)events[i].data.u32);
+					if(listenerIterator == _listeners.end()) continue;
+					listener = listenerIterator->second;
+				}
+				if(listener->fileDescriptor->descriptor == -1) continue;
+
+				//Read one batch per listener and wakeup, so a busy listener can't starve the others. Remaining datagrams are
+				//returned by the next epoll_wait().
+				int32_t datagramCount = batch.receive(listener->fileDescriptor->descriptor);
+				if(datagramCount < 0)
+				{
+					//Also returned for ICMP errors of previously sent packets (e. g. ECONNREFUSED), so the socket is kept.
+					if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: Could not read from UDP listener " + std::to_string(listener->id) + ": " + std::string(strerror(errno)));
+					continue;
+				}
+				if(!listener->packetReceivedCallback) continue;
+
+				packet.listenerId = listener->id;
+				for(size_t j = 0; j < batch.size(); j++)
+				{
+					try
+					{
+						packet.senderIp = batch.senderIp(j);
+						packet.senderPort = (uint16_t)batch.senderPort(j);
+						packet.data = batch.data(j);
+						packet.size = batch.length(j);
+						listener->packetReceivedCallback(packet);
+					}
+					catch(const std::exception& ex)
+					{
+						_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+					}
+				}
+			}
+		}
+		catch(const std::exception& ex)
+		{
+			_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+		}
+	}
+}
+
+}
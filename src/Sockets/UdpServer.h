@@ -0,0 +1,245 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef UDPSERVER_H_
+#define UDPSERVER_H_
+
+#include "UdpSocket.h"
+
+#include <thread>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <functional>
+
+namespace BaseLib
+{
+
+class SharedObjects;
+
+/**
+ * UDP server. All sockets ("listeners") of one server are handled by a single thread waiting on epoll, so many UDP ports don't
+ * need a thread each. Received datagrams are read in batches into a preallocated buffer pool and passed to packetReceivedCallback.
+ *
+ * UDP Server Example Code
+ * =======================
+ *
+ *     void packetReceived(const BaseLib::UdpServer::UdpPacket& packet)
+ *     {
+ *     	//packet.data is only valid during the callback
+ *     	std::vector<uint8_t> response{'p', 'o', 'n', 'g'};
+ *     	_udpServer->sendToClient(packet.listenerId, packet.senderIp, packet.senderPort, response);
+ *     }
+ *
+ *     void startUdpServer()
+ *     {
+ *     	BaseLib::UdpServer::UdpServerInfo serverInfo;
+ *     	serverInfo.packetReceivedCallback = std::bind(&packetReceived, std::placeholders::_1);
+ *
+ *     	_udpServer = std::make_shared<BaseLib::UdpServer>(_bl.get(), serverInfo);
+ *
+ *     	std::string listenAddress;
+ *     	int32_t listenPort = -1;
+ *     	_udpServer->addListener("0.0.0.0", "3671", listenAddress, listenPort);
+ *     	_udpServer->addListener("0.0.0.0", "1900", listenAddress, listenPort);
+ *     	_udpServer->startServer();
+ *     }
+ *
+ *     void stopUdpServer()
+ *     {
+ *     	_udpServer->stopServer();
+ *     	_udpServer->waitForServerStopped();
+ *     }
+ */
+class UdpServer
+{
+public:
+	struct UdpPacket
+	{
+		int32_t listenerId = -1;
+		std::string senderIp;
+		uint16_t senderPort = 0;
+
+		/**
+		 * Points into the buffer pool of the server. Only valid during the call to packetReceivedCallback.
+		 */
+		const char* data = nullptr;
+		size_t size = 0;
+	};
+
+	typedef std::function<void(const UdpPacket& packet)> PacketReceivedCallback;
+
+	struct UdpServerInfo
+	{
+		/**
+		 * The number of datagrams read with one system call.
+		 */
+		uint32_t bufferCount = 16;
+
+		/**
+		 * The maximum datagram size. Larger datagrams are truncated.
+		 */
+		uint32_t bufferSize = 2048;
+
+		/**
+		 * The time in milliseconds sendToClient() waits for room in the send buffer of the socket.
+		 */
+		uint32_t sendTimeout = 1000;
+
+		/**
+		 * Called for listeners without their own callback.
+		 */
+		PacketReceivedCallback packetReceivedCallback;
+	};
+
+	UdpServer(BaseLib::SharedObjects* baseLib, UdpServerInfo& serverInfo);
+	virtual ~UdpServer();
+
+	/**
+	 * Binds a new socket and adds it to the server. Listeners can be added and removed while the server is running.
+	 *
+	 * @param address The address to bind the socket to (e. g. `::` or `0.0.0.0`).
+	 * @param port The port number to bind the socket to. Pass "0" to get a dynamically assigned port.
+	 * @param[out] listenAddress The IP address the socket was bound to.
+	 * @param[out] listenPort The port the socket was bound to.
+	 * @param packetReceivedCallback The callback for this listener. When empty the callback of UdpServerInfo is used.
+	 * @return Returns the ID of the listener as passed in UdpPacket::listenerId.
+	 * @throws SocketAddressInUseException Thrown when the port is in use.
+	 * @throws SocketBindException Thrown when the socket could not be bound.
+	 * @throws SocketOperationException Thrown on all other errors.
+	 */
+	int32_t addListener(std::string address, std::string port, std::string& listenAddress, int32_t& listenPort, PacketReceivedCallback packetReceivedCallback = PacketReceivedCallback());
+
+	/**
+	 * Removes a listener and closes its socket.
+	 */
+	void removeListener(int32_t listenerId);
+
+	/**
+	 * Returns the number of listeners.
+	 */
+	size_t listenerCount();
+
+	/**
+	 * Starts the event loop. Does nothing when the server is already running. Listeners closed by waitForServerStopped() are opened
+	 * again on the same port.
+	 *
+	 * @throws SocketAddressInUseException Thrown when the port of a listener is in use now.
+	 * @throws SocketBindException Thrown when the socket of a listener could not be bound.
+	 * @throws SocketOperationException Thrown on all other errors.
+	 */
+	void startServer();
+
+	/**
+	 * Adds a listener with the default callback and starts the event loop. When the server was stopped, a listener added by an earlier
+	 * call with the same address and port is opened again instead.
+	 *
+	 * @param address The address to bind the server to (e. g. `::` or `0.0.0.0`).
+	 * @param port The port number to bind the server to.
+	 * @param[out] listenAddress The IP address the server was bound to (e. g. `192.168.0.152`).
+	 * @return Returns the ID of the listener.
+	 */
+	int32_t startServer(std::string address, std::string port, std::string& listenAddress);
+
+	/**
+	 * Starts stopping the server and returns immediately.
+	 */
+	void stopServer();
+
+	/**
+	 * Waits until the server is stopped and closes the sockets of all listeners. The listeners are kept and opened again by
+	 * startServer(). Use removeListener() to remove them.
+	 */
+	void waitForServerStopped();
+
+	/**
+	 * Sends a datagram from the socket of a listener, so the receiver sees the port of the listener as source port.
+	 *
+	 * @param listenerId The ID of the listener to send from.
+	 * @param ip The IP address to send the datagram to.
+	 * @param port The port to send the datagram to.
+	 * @param data The datagram.
+	 * @throws SocketInvalidParametersException Thrown when the listener doesn't exist or the IP address is invalid.
+	 * @throws SocketTimeOutException Thrown when the send buffer stays full for longer than UdpServerInfo::sendTimeout.
+	 * @throws SocketOperationException Thrown when sending fails.
+	 */
+	void sendToClient(int32_t listenerId, const std::string& ip, uint16_t port, const std::vector<uint8_t>& data);
+private:
+	struct Listener
+	{
+		int32_t id = -1;
+		PFileDescriptor fileDescriptor;
+		PacketReceivedCallback packetReceivedCallback;
+
+		/**
+		 * The address and port passed to addListener().
+		 */
+		std::string address;
+		std::string port;
+
+		/**
+		 * The address and port the socket is bound to.
+		 */
+		std::string listenAddress;
+		int32_t listenPort = -1;
+	};
+	typedef std::shared_ptr<Listener> PListener;
+
+	BaseLib::SharedObjects* _bl = nullptr;
+	uint32_t _bufferCount = 16;
+	uint32_t _bufferSize = 2048;
+	uint32_t _sendTimeout = 1000;
+	PacketReceivedCallback _packetReceivedCallback;
+
+	PFileDescriptor _epollDescriptor;
+	std::atomic_bool _stopServer{true};
+	std::thread _serverThread;
+
+	std::mutex _listenersMutex;
+	int32_t _currentListenerId = 0;
+	std::map<int32_t, PListener> _listeners;
+
+	PFileDescriptor bindSocket(const std::string& address, const std::string& port, std::string& listenAddress, int32_t& listenPort);
+
+	/**
+	 * Binds the sockets of listeners closed by waitForServerStopped() again.
+	 */
+	void openListeners();
+	void serverThread();
+};
+
+typedef std::shared_ptr<BaseLib::UdpServer> PUdpServer;
+
+}
+
+#endif
@@ -34,6 +34,150 @@
 namespace BaseLib
 {
 
+DatagramBatch::DatagramBatch(size_t capacity, size_t bufferSize)
+{
+	if(capacity == 0) capacity = 1;
+	if(bufferSize == 0) bufferSize = 1;
+	_bufferSize = bufferSize;
+	_buffers.resize(capacity * bufferSize);
+	_lengths.resize(capacity, 0);
+	_iovecs.resize(capacity);
+	_addresses.resize(capacity);
+#ifndef MACOSSYSTEM
+	_headers.resize(capacity);
+	for(size_t i = 0; i < capacity; i++)
+	{
+		memset(&_headers[i], 0, sizeof(struct mmsghdr));
+		_headers[i].msg_hdr.msg_iov = &_iovecs[i];
+		_headers[i].msg_hdr.msg_iovlen = 1;
+	}
+#endif
+	for(size_t i = 0; i < capacity; i++)
+	{
+		_iovecs[i].iov_base = _buffers.data() + (i * bufferSize);
+	}
+}
+
+std::string DatagramBatch::senderIp(size_t index) const
+{
+	const struct sockaddr_storage& address = _addresses.at(index);
+	std::array<char, INET6_ADDRSTRLEN + 1> ipStringBuffer{};
+	if(address.ss_family == AF_INET)
+	{
+		const struct sockaddr_in* s = (const struct sockaddr_in*)&address;
+		inet_ntop(AF_INET, &s->sin_addr, ipStringBuffer.data(), ipStringBuffer.size());
+	}
+	else if(address.ss_family == AF_INET6)
+	{
+		const struct sockaddr_in6* s = (const struct sockaddr_in6*)&address;
+		inet_ntop(AF_INET6, &s->sin6_addr, ipStringBuffer.data(), ipStringBuffer.size());
+	}
+	ipStringBuffer.back() = 0;
+	return std::string(ipStringBuffer.data());
+}
+
+int32_t DatagramBatch::senderPort(size_t index) const
+{
+	const struct sockaddr_storage& address = _addresses.at(index);
+	if(address.ss_family == AF_INET) return ntohs(((const struct sockaddr_in*)&address)->sin_port);
+	else if(address.ss_family == AF_INET6) return ntohs(((const struct sockaddr_in6*)&address)->sin6_port);
+	return -1;
+}
+
+bool DatagramBatch::push(const char* data, size_t length)
+{
+	if(full() || length > _bufferSize) return false;
+	memcpy(_buffers.data() + (_size * _bufferSize), data, length);
+	_lengths[_size] = length;
+	_size++;
+	return true;
+}
+
+int32_t DatagramBatch::receive(int32_t descriptor)
+{
+	clear();
+#ifdef MACOSSYSTEM
+	for(size_t i = 0; i < _lengths.size(); i++)
+	{
+		socklen_t addressLength = sizeof(struct sockaddr_storage);
+		ssize_t bytesReceived = recvfrom(descriptor, _iovecs[i].iov_base, _bufferSize, MSG_DONTWAIT, (struct sockaddr*)&_addresses[i], &addressLength);
+		if(bytesReceived < 0)
+		{
+			if(errno == EINTR)
+			{
+				i--;
+				continue;
+			}
+			if(_size > 0 || errno == EAGAIN || errno == EWOULDBLOCK) break;
+			return -1;
+		}
+		_lengths[i] = bytesReceived;
+		_size++;
+	}
+	return _size;
+#else
+	for(size_t i = 0; i < _headers.size(); i++)
+	{
+		_iovecs[i].iov_len = _bufferSize;
+		_headers[i].msg_hdr.msg_name = &_addresses[i];
+		_headers[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+		_headers[i].msg_hdr.msg_flags = 0;
+	}
+	int32_t datagramsReceived = 0;
+	do
+	{
+		datagramsReceived = recvmmsg(descriptor, _headers.data(), _headers.size(), MSG_DONTWAIT, nullptr);
+	} while(datagramsReceived == -1 && errno == EINTR);
+	if(datagramsReceived < 0) return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+	for(int32_t i = 0; i < datagramsReceived; i++)
+	{
+		_lengths[i] = _headers[i].msg_len;
+	}
+	_size = datagramsReceived;
+	return datagramsReceived;
+#endif
+}
+
+int32_t DatagramBatch::send(int32_t descriptor, const struct sockaddr* address, socklen_t addressLength)
+{
+	if(_sent >= _size)
+	{
+		clear();
+		return 0;
+	}
+#ifdef MACOSSYSTEM
+	int32_t datagramsSent = 0;
+	while(_sent < _size)
+	{
+		ssize_t bytesSent = sendto(descriptor, data(_sent), _lengths[_sent], 0, address, addressLength);
+		if(bytesSent == -1)
+		{
+			if(errno == EINTR) continue;
+			if(datagramsSent > 0) break;
+			return -1;
+		}
+		_sent++;
+		datagramsSent++;
+	}
+#else
+	for(size_t i = _sent; i < _size; i++)
+	{
+		_iovecs[i].iov_len = _lengths[i];
+		_headers[i].msg_hdr.msg_name = (void*)address;
+		_headers[i].msg_hdr.msg_namelen = addressLength;
+	}
+	int32_t datagramsSent = 0;
+	do
+	{
+		datagramsSent = sendmmsg(descriptor, _headers.data() + _sent, _size - _sent, 0);
+	} while(datagramsSent == -1 && errno == EINTR);
+	if(datagramsSent < 0) return -1;
+	_sent += datagramsSent;
+#endif
+	if(_sent >= _size) clear();
+	return datagramsSent;
+}
+
 UdpSocket::UdpSocket(BaseLib::SharedObjects* baseLib)
 {
 	_bl = baseLib;
@@ -149,6 +293,60 @@ int32_t UdpSocket::proofread(char* buffer, int32_t bufferSize, std::string& send
 	return bytesRead;
 }
 
+int32_t UdpSocket::proofreadBatch(DatagramBatch& batch)
+{
+	batch.clear();
+	if(!_socketDescriptor) throw SocketOperationException("Socket descriptor is nullptr.");
+	_readMutex.lock();
+	if(_autoConnect && !isOpen())
+	{
+		_readMutex.unlock();
+		autoConnect();
+		if(!isOpen()) throw SocketClosedException("Connection to client number " + std::to_string(_socketDescriptor->id) + " closed (8).");
+		_readMutex.lock();
+	}
+	//select() can report the socket as readable although no datagram can be received (e.g. when its checksum is wrong). In that
+	//case select() is called again with the remaining time, so the read timeout is kept.
+	auto endTime = std::chrono::steady_clock::now() + std::chrono::microseconds(_readTimeout);
+	int32_t result = 0;
+	do
+	{
+		int64_t remainingTime = std::chrono::duration_cast<std::chrono::microseconds>(endTime - std::chrono::steady_clock::now()).count();
+		if(remainingTime < 0) remainingTime = 0;
+		timeval timeout;
+		timeout.tv_sec = remainingTime / 1000000;
+		timeout.tv_usec = remainingTime % 1000000;
+		fd_set readFileDescriptor;
+		FD_ZERO(&readFileDescriptor);
+		auto fileDescriptorGuard = _bl->fileDescriptorManager.getLock();
+		fileDescriptorGuard.lock();
+		int32_t nfds = _socketDescriptor->descriptor + 1;
+		if(nfds <= 0)
+		{
+			fileDescriptorGuard.unlock();
+			_readMutex.unlock();
+			throw SocketClosedException("Connection to client number " + std::to_string(_socketDescriptor->id) + " closed (1).");
+		}
+		FD_SET(_socketDescriptor->descriptor, &readFileDescriptor);
+		fileDescriptorGuard.unlock();
+		result = select(nfds, &readFileDescriptor, NULL, NULL, &timeout);
+		if(result == 0)
+		{
+			_readMutex.unlock();
+			throw SocketTimeOutException("Reading from socket timed out.");
+		}
+		if(result != 1)
+		{
+			_readMutex.unlock();
+			throw SocketClosedException("Connection to client number " + std::to_string(_socketDescriptor->id) + " closed (2).");
+		}
+		result = batch.receive(_socketDescriptor->descriptor);
+	} while(result == 0);
+	_readMutex.unlock();
+	if(result < 0) throw SocketClosedException("Connection to client number " + std::to_string(_socketDescriptor->id) + " closed (3).");
+	return result;
+}
+
 int32_t UdpSocket::proofwrite(const std::shared_ptr<std::vector<char>> data)
 {
 	if(!data || data->empty()) return 0;
@@ -273,6 +471,36 @@ int32_t UdpSocket::proofwrite(const std::string& data)
 	return totalBytesWritten;
 }
 
+int32_t UdpSocket::proofwriteBatch(DatagramBatch& batch)
+{
+	if(!_socketDescriptor) throw SocketOperationException("Socket descriptor is nullptr.");
+	_writeMutex.lock();
+	if(!isOpen())
+	{
+		_writeMutex.unlock();
+		autoConnect();
+		if(!isOpen()) throw SocketClosedException("Connection to client number " + std::to_string(_socketDescriptor->id) + " closed (8).");
+		_writeMutex.lock();
+	}
+
+	int32_t totalDatagramsWritten = 0;
+	while(!batch.empty())
+	{
+		int32_t datagramsWritten = batch.send(_socketDescriptor->descriptor, _serverInfo->ai_addr, _serverInfo->ai_addrlen);
+		if(datagramsWritten < 0)
+		{
+			if(errno == EAGAIN) continue;
+			_writeMutex.unlock();
+			batch.clear();
+			close();
+			throw SocketOperationException(strerror(errno));
+		}
+		totalDatagramsWritten += datagramsWritten;
+	}
+	_writeMutex.unlock();
+	return totalDatagramsWritten;
+}
+
 bool UdpSocket::isOpen()
 {
 	if(!_serverInfo || !_socketDescriptor || _socketDescriptor->descriptor == -1) return false;
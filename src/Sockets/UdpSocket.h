@@ -34,11 +34,90 @@
 #include "SocketExceptions.h"
 #include "../Managers/FileDescriptorManager.h"
 
+#include <vector>
+#include <string>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
 namespace BaseLib
 {
 
 class SharedObjects;
 
+/**
+ * Pool of datagram buffers to receive or send multiple datagrams with one system call (recvmmsg() and sendmmsg()). All buffers
+ * are allocated on construction, so reuse one instance for all calls to avoid allocations per packet.
+ */
+class DatagramBatch
+{
+public:
+	/**
+	 * @param capacity The maximum number of datagrams per batch.
+	 * @param bufferSize The maximum size of one datagram. Larger datagrams are truncated on receive.
+	 */
+	DatagramBatch(size_t capacity, size_t bufferSize);
+
+	size_t capacity() const { return _lengths.size(); }
+	size_t bufferSize() const { return _bufferSize; }
+
+	/**
+	 * Returns the number of datagrams received by the last call to receive() or added with push().
+	 */
+	size_t size() const { return _size; }
+	bool empty() const { return _size == 0; }
+	bool full() const { return _size == _lengths.size(); }
+	void clear() { _size = 0; _sent = 0; }
+
+	char* data(size_t index) { return _buffers.data() + (index * _bufferSize); }
+	const char* data(size_t index) const { return _buffers.data() + (index * _bufferSize); }
+	size_t length(size_t index) const { return _lengths.at(index); }
+
+	/**
+	 * Returns the IP address a received datagram was sent from.
+	 */
+	std::string senderIp(size_t index) const;
+
+	/**
+	 * Returns the port a received datagram was sent from.
+	 */
+	int32_t senderPort(size_t index) const;
+
+	/**
+	 * Adds a datagram to send.
+	 *
+	 * @return Returns false when the batch is full or the datagram is larger than the buffer size.
+	 */
+	bool push(const char* data, size_t length);
+
+	/**
+	 * Reads all datagrams available on "descriptor" without blocking, up to the capacity of the batch. Previous content is
+	 * discarded.
+	 *
+	 * @return Returns the number of datagrams received, 0 when no data is available or -1 on errors with errno set.
+	 */
+	int32_t receive(int32_t descriptor);
+
+	/**
+	 * Sends the datagrams not sent yet to "address". Sent datagrams are removed from the batch, so call again to send the
+	 * rest when the socket buffer was full.
+	 *
+	 * @return Returns the number of datagrams sent or -1 on errors with errno set.
+	 */
+	int32_t send(int32_t descriptor, const struct sockaddr* address, socklen_t addressLength);
+private:
+	size_t _bufferSize = 0;
+	size_t _size = 0;
+	size_t _sent = 0;
+	std::vector<char> _buffers;
+	std::vector<size_t> _lengths;
+	std::vector<struct iovec> _iovecs;
+	std::vector<struct sockaddr_storage> _addresses;
+#ifndef MACOSSYSTEM
+	std::vector<struct mmsghdr> _headers;
+#endif
+};
+
 class UdpSocket
 {
 public:
@@ -69,10 +148,31 @@ public:
 	 */
 	int32_t proofread(char* buffer, int32_t bufferSize, std::string& senderIp);
 
+	/**
+	 * Like proofread(), but after waiting for the first datagram all datagrams already queued on the socket are read with one system
+	 * call, up to the capacity of "batch". Use DatagramBatch::senderIp() to get the sender of each datagram.
+	 *
+	 * @param[in,out] batch The buffers to read the datagrams into. Previous content is discarded.
+	 * @return Returns the number of datagrams read. Never returns 0 or a negative number.
+	 * @throws SocketTimeOutException Thrown on timeout.
+	 * @throws SocketClosedException Thrown when socket was closed.
+	 * @throws SocketOperationException Thrown when socket is nullptr.
+	 */
+	int32_t proofreadBatch(DatagramBatch& batch);
+
 	int32_t proofwrite(const std::shared_ptr<std::vector<char>> data);
 	int32_t proofwrite(const std::vector<char>& data);
 	int32_t proofwrite(const std::string& data);
 	int32_t proofwrite(const char* buffer, int32_t bytesToWrite);
+
+	/**
+	 * Sends all datagrams in "batch" with as few system calls as possible and clears it.
+	 *
+	 * @return Returns the number of datagrams sent.
+	 * @throws SocketClosedException Thrown when socket was closed.
+	 * @throws SocketOperationException Thrown on send errors.
+	 */
+	int32_t proofwriteBatch(DatagramBatch& batch);
 	void open();
 	void close();
 protected:
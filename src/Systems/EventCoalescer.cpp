@@ -0,0 +1,269 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "EventCoalescer.h"
+#include "../BaseLib.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace BaseLib
+{
+namespace Systems
+{
+
+EventCoalescer::EventCoalescer(BaseLib::SharedObjects* baseLib, uint32_t interval, double minDelta, EventCallback eventCallback)
+{
+	_bl = baseLib;
+	_interval = interval;
+	_minDelta = minDelta < 0 ? 0 : minDelta;
+	_eventCallback.swap(eventCallback);
+	_stopFlushThread = (_interval == 0);
+	if(_interval > 0) _bl->threadManager.start(_flushThread, true, &EventCoalescer::flushThread, this);
+}
+
+EventCoalescer::~EventCoalescer()
+{
+	_stopFlushThread = true;
+	_flushThreadConditionVariable.notify_all();
+	_bl->threadManager.join(_flushThread);
+}
+
+void EventCoalescer::dispose()
+{
+	{
+		std::lock_guard<std::mutex> flushThreadGuard(_flushThreadMutex);
+		_stopFlushThread = true;
+	}
+	_flushThreadConditionVariable.notify_all();
+	_bl->threadManager.join(_flushThread);
+	flush();
+}
+
+bool EventCoalescer::filter(Window& window, const std::string& variable, const PVariable& value)
+{
+	if(_minDelta == 0 || !value) return true;
+
+	double number = 0;
+	if(value->type == VariableType::tInteger) number = value->integerValue;
+	else if(value->type == VariableType::tInteger64) number = value->integerValue64;
+	else if(value->type == VariableType::tFloat) number = value->floatValue;
+	else return true;
+
+	auto lastValueIterator = window.lastValues.find(variable);
+	if(lastValueIterator == window.lastValues.end())
+	{
+		window.lastValues.emplace(variable, number);
+		return true;
+	}
+	if(std::fabs(number - lastValueIterator->second) < _minDelta) return false;
+	lastValueIterator->second = number;
+	return true;
+}
+
+void EventCoalescer::takePendingEvent(const std::pair<uint64_t, int32_t>& key, Window& window, int64_t time, std::vector<Event>& events)
+{
+	Event event;
+	event.source = window.source;
+	event.peerId = key.first;
+	event.channel = key.second;
+	event.deviceAddress = window.deviceAddress;
+	event.variables = std::make_shared<std::vector<std::string>>(std::move(window.variables));
+	event.values = std::make_shared<std::vector<PVariable>>(std::move(window.values));
+	events.emplace_back(std::move(event));
+	window.variables.clear();
+	window.values.clear();
+	window.lastEvent = time;
+}
+
+void EventCoalescer::passOn(std::vector<Event>& events)
+{
+	for(auto& event : events)
+	{
+		try
+		{
+			_eventCallback(event.source, event.peerId, event.channel, event.deviceAddress, event.variables, event.values);
+		}
+		catch(const std::exception& ex)
+		{
+			_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+		}
+	}
+}
+
+void EventCoalescer::add(std::string& source, uint64_t peerId, int32_t channel, std::string& deviceAddress, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<PVariable>>& values)
+{
+	try
+	{
+		if(!variables || !values)
+		{
+			_eventCallback(source, peerId, channel, deviceAddress, variables, values);
+			return;
+		}
+
+		std::vector<Event> events;
+		{
+			std::lock_guard<std::mutex> windowsGuard(_windowsMutex);
+			auto key = std::make_pair(peerId, channel);
+			Window& window = _windows[key];
+			int64_t time = HelperFunctions::getTime();
+			bool immediate = _stopFlushThread || (window.variables.empty() && time - window.lastEvent >= (int64_t)_interval);
+			if(!window.variables.empty() && (window.source != source || window.deviceAddress != deviceAddress))
+			{
+				//Don't mix events of different origins. The new event is passed on right after the pending one.
+				takePendingEvent(key, window, time, events);
+				immediate = true;
+			}
+
+			size_t size = std::min(variables->size(), values->size());
+			if(immediate)
+			{
+				Event event;
+				event.source = source;
+				event.peerId = peerId;
+				event.channel = channel;
+				event.deviceAddress = deviceAddress;
+				if(_minDelta == 0)
+				{
+					event.variables = variables;
+					event.values = values;
+				}
+				else
+				{
+					event.variables = std::make_shared<std::vector<std::string>>();
+					event.values = std::make_shared<std::vector<PVariable>>();
+					event.variables->reserve(size);
+					event.values->reserve(size);
+					for(size_t i = 0; i < size; i++)
+					{
+						if(!filter(window, variables->at(i), values->at(i))) continue;
+						event.variables->push_back(variables->at(i));
+						event.values->push_back(values->at(i));
+					}
+				}
+				if(!event.variables->empty())
+				{
+					window.lastEvent = time;
+					events.emplace_back(std::move(event));
+				}
+			}
+			else
+			{
+				if(window.variables.empty())
+				{
+					window.source = source;
+					window.deviceAddress = deviceAddress;
+				}
+				for(size_t i = 0; i < size; i++)
+				{
+					if(!filter(window, variables->at(i), values->at(i))) continue;
+					auto variableIterator = std::find(window.variables.begin(), window.variables.end(), variables->at(i));
+					if(variableIterator == window.variables.end())
+					{
+						window.variables.push_back(variables->at(i));
+						window.values.push_back(values->at(i));
+					}
+					else window.values.at(variableIterator - window.variables.begin()) = values->at(i);
+				}
+			}
+		}
+		passOn(events);
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void EventCoalescer::flush()
+{
+	try
+	{
+		std::vector<Event> events;
+		{
+			std::lock_guard<std::mutex> windowsGuard(_windowsMutex);
+			int64_t time = HelperFunctions::getTime();
+			for(auto& window : _windows)
+			{
+				if(!window.second.variables.empty()) takePendingEvent(window.first, window.second, time, events);
+			}
+		}
+		passOn(events);
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void EventCoalescer::flushThread()
+{
+	int64_t tick = std::max(_interval / 4, (uint32_t)1);
+	while(!_stopFlushThread)
+	{
+		try
+		{
+			{
+				std::unique_lock<std::mutex> flushThreadGuard(_flushThreadMutex);
+				_flushThreadConditionVariable.wait_for(flushThreadGuard, std::chrono::milliseconds(tick), [&] { return _stopFlushThread.load(); });
+			}
+			if(_stopFlushThread) break;
+
+			std::vector<Event> events;
+			{
+				std::lock_guard<std::mutex> windowsGuard(_windowsMutex);
+				int64_t time = HelperFunctions::getTime();
+				for(auto windowIterator = _windows.begin(); windowIterator != _windows.end();)
+				{
+					Window& window = windowIterator->second;
+					if(!window.variables.empty())
+					{
+						if(time - window.lastEvent >= (int64_t)_interval) takePendingEvent(windowIterator->first, window, time, events);
+					}
+					else if(_minDelta == 0 && time - window.lastEvent > 60000)
+					{
+						//Without "minDelta" idle windows don't hold any state.
+						windowIterator = _windows.erase(windowIterator);
+						continue;
+					}
+					windowIterator++;
+				}
+			}
+			passOn(events);
+		}
+		catch(const std::exception& ex)
+		{
+			_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+		}
+	}
+}
+
+}
+}
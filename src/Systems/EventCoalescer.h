@@ -0,0 +1,138 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef EVENTCOALESCER_H_
+#define EVENTCOALESCER_H_
+
+#include "../Variable.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <map>
+
+namespace BaseLib
+{
+
+class SharedObjects;
+
+namespace Systems
+{
+
+/**
+ * Merges the value events of noisy peers. Events are grouped by peer and channel. The first event of a channel is passed on
+ * immediately. Further events within "interval" milliseconds are collected, only the latest value of each variable is kept, and
+ * they are passed on as one event when the interval has elapsed. Additionally, numeric values differing by less than "minDelta"
+ * from the value last passed on are dropped.
+ *
+ * The events passed on late are sent from the coalescer's own thread.
+ */
+class EventCoalescer
+{
+public:
+	typedef std::function<void(std::string& source, uint64_t peerId, int32_t channel, std::string& deviceAddress, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<PVariable>>& values)> EventCallback;
+
+	/**
+	 * Constructor.
+	 *
+	 * @param baseLib The base library object.
+	 * @param interval The minimum time in milliseconds between two events of the same channel. 0 disables merging.
+	 * @param minDelta The minimum difference of a numeric value to the value last passed on. 0 disables the filter.
+	 * @param eventCallback Called for every event passed on.
+	 */
+	EventCoalescer(BaseLib::SharedObjects* baseLib, uint32_t interval, double minDelta, EventCallback eventCallback);
+	virtual ~EventCoalescer();
+
+	/**
+	 * Passes on the pending events and stops the flush thread. Events added afterwards are passed on immediately.
+	 */
+	void dispose();
+
+	/**
+	 * Adds an event. Depending on the state of the channel, "eventCallback" is called before this method returns or the values are
+	 * stored until the interval has elapsed.
+	 */
+	void add(std::string& source, uint64_t peerId, int32_t channel, std::string& deviceAddress, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<PVariable>>& values);
+
+	/**
+	 * Passes on all pending events immediately.
+	 */
+	void flush();
+private:
+	struct Event
+	{
+		std::string source;
+		uint64_t peerId = 0;
+		int32_t channel = -1;
+		std::string deviceAddress;
+		std::shared_ptr<std::vector<std::string>> variables;
+		std::shared_ptr<std::vector<PVariable>> values;
+	};
+
+	struct Window
+	{
+		int64_t lastEvent = 0;
+		std::string source;
+		std::string deviceAddress;
+		std::vector<std::string> variables;
+		std::vector<PVariable> values;
+		std::map<std::string, double> lastValues;
+	};
+
+	BaseLib::SharedObjects* _bl = nullptr;
+	uint32_t _interval = 0;
+	double _minDelta = 0;
+	EventCallback _eventCallback;
+
+	std::mutex _windowsMutex;
+	std::map<std::pair<uint64_t, int32_t>, Window> _windows;
+
+	std::atomic_bool _stopFlushThread;
+	std::mutex _flushThreadMutex;
+	std::condition_variable _flushThreadConditionVariable;
+	std::thread _flushThread;
+
+	EventCoalescer(const EventCoalescer&) = delete;
+	EventCoalescer& operator=(const EventCoalescer&) = delete;
+
+	/**
+	 * Returns false when the value should be dropped because of "minDelta". Updates the last value otherwise.
+	 */
+	bool filter(Window& window, const std::string& variable, const PVariable& value);
+	void takePendingEvent(const std::pair<uint64_t, int32_t>& key, Window& window, int64_t time, std::vector<Event>& events);
+	void passOn(std::vector<Event>& events);
+	void flushThread();
+};
+
+}
+}
+#endif
@@ -393,7 +393,7 @@ void FamilySettings::loadFromDatabase()
             PFamilySetting setting(new FamilySetting());
             setting->integerValue = row->second.at(4)->intValue;
             setting->stringValue = std::move(row->second.at(5)->textValue);
-            setting->binaryValue = std::move(*(row->second.at(6)->binaryValue));
+            if(row->second.at(6)->binaryValue) setting->binaryValue = std::move(*(row->second.at(6)->binaryValue));
 
             std::pair<std::string, std::string> interfacePair = HelperFunctions::splitFirst(row->second.at(3)->textValue, '.');
             if(interfacePair.second.empty())
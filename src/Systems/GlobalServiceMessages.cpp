@@ -68,7 +68,7 @@ void GlobalServiceMessages::load()
             serviceMessage->timestamp = row.second.at(5)->intValue;
             serviceMessage->message = row.second.at(7)->textValue;
             serviceMessage->value = row.second.at(6)->intValue;
-            serviceMessage->data = _rpcDecoder->decodeResponse(*row.second.at(9)->binaryValue);
+            if(row.second.at(9)->binaryValue) serviceMessage->data = _rpcDecoder->decodeResponse(*row.second.at(9)->binaryValue);
             _serviceMessages[row.second.at(1)->intValue][row.second.at(3)->intValue][row.second.at(4)->textValue].emplace(row.second.at(7)->textValue, std::move(serviceMessage));
         }
     }
@@ -47,6 +47,24 @@ ICentral::ICentral(int32_t deviceFamily, BaseLib::SharedObjects* baseLib, ICentr
     _pairing = false;
     _timeLeftInPairingMode = 0;
 	_translations = std::make_shared<DeviceTranslations>(baseLib, deviceFamily);
+
+	if(_bl->settings.eventCoalescingInterval() > 0 || _bl->settings.eventCoalescingMinDelta() > 0)
+	{
+		if(_bl->settings.coalesceRpcEvents())
+		{
+			_rpcEventCoalescer.reset(new EventCoalescer(_bl, _bl->settings.eventCoalescingInterval(), _bl->settings.eventCoalescingMinDelta(), [this](std::string& source, uint64_t peerId, int32_t channel, std::string& deviceAddress, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<PVariable>>& values)
+			{
+				raiseRPCEvent(source, peerId, channel, deviceAddress, variables, values);
+			}));
+		}
+		if(_bl->settings.coalesceScriptEvents())
+		{
+			_eventCoalescer.reset(new EventCoalescer(_bl, _bl->settings.eventCoalescingInterval(), _bl->settings.eventCoalescingMinDelta(), [this](std::string& source, uint64_t peerId, int32_t channel, std::string& deviceAddress, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<PVariable>>& values)
+			{
+				raiseEvent(source, peerId, channel, variables, values);
+			}));
+		}
+	}
 }
 
 ICentral::ICentral(int32_t deviceFamily, BaseLib::SharedObjects* baseLib, uint32_t deviceId, std::string serialNumber, int32_t address, ICentralEventSink* eventHandler) : ICentral(deviceFamily, baseLib, eventHandler)
@@ -63,6 +81,8 @@ ICentral::~ICentral()
 void ICentral::dispose(bool wait)
 {
 	_disposing = true;
+	if(_rpcEventCoalescer) _rpcEventCoalescer->dispose();
+	if(_eventCoalescer) _eventCoalescer->dispose();
 	_peers.clear();
 	_peersBySerial.clear();
 	_peersById.clear();
@@ -116,11 +136,25 @@ void ICentral::dispose(bool wait)
         }
         // }}}
 
+		_peersChangeSequence = Peer::nextChangeSequence();
 		if(_eventHandler) ((ICentralEventSink*)_eventHandler)->onRPCNewDevices(ids, deviceDescriptions);
 	}
 
 	void ICentral::raiseRPCDeleteDevices(std::vector<uint64_t>& ids, PVariable deviceAddresses, PVariable deviceInfo)
 	{
+		{
+			std::lock_guard<std::mutex> deletedPeersGuard(_deletedPeersMutex);
+			for(auto id : ids)
+			{
+				_deletedPeers.emplace_back(Peer::nextChangeSequence(), id);
+			}
+			while(_deletedPeers.size() > _maxDeletedPeers)
+			{
+				_deletedPeersHorizon = _deletedPeers.front().first;
+				_deletedPeers.pop_front();
+			}
+		}
+		_peersChangeSequence = Peer::nextChangeSequence();
 		if(_eventHandler) ((ICentralEventSink*)_eventHandler)->onRPCDeleteDevices(ids, deviceAddresses, deviceInfo);
 	}
 
@@ -160,7 +194,8 @@ void ICentral::dispose(bool wait)
 
 	void ICentral::onRPCEvent(std::string& source, uint64_t id, int32_t channel, std::string& deviceAddress, std::shared_ptr<std::vector<std::string>>& valueKeys, std::shared_ptr<std::vector<PVariable>>& values)
 	{
-		raiseRPCEvent(source, id, channel, deviceAddress, valueKeys, values);
+		if(_rpcEventCoalescer) _rpcEventCoalescer->add(source, id, channel, deviceAddress, valueKeys, values);
+		else raiseRPCEvent(source, id, channel, deviceAddress, valueKeys, values);
 	}
 
 	void ICentral::onRPCUpdateDevice(uint64_t id, int32_t channel, std::string address, int32_t hint)
@@ -170,7 +205,12 @@ void ICentral::dispose(bool wait)
 
 	void ICentral::onEvent(std::string& source, uint64_t peerId, int32_t channel, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<PVariable>>& values)
 	{
-		raiseEvent(source, peerId, channel, variables, values);
+		if(_eventCoalescer)
+		{
+			std::string deviceAddress;
+			_eventCoalescer->add(source, peerId, channel, deviceAddress, variables, values);
+		}
+		else raiseEvent(source, peerId, channel, variables, values);
 	}
 
 	void ICentral::onRunScript(ScriptEngine::PScriptInfo& scriptInfo, bool wait)
@@ -182,8 +222,263 @@ void ICentral::dispose(bool wait)
 	{
 		return raiseInvokeRpc(methodName, parameters);
 	}
+
+	void ICentral::onAssignmentAdded(Peer::AssignmentType::Enum type, uint64_t id, uint64_t peerId, int32_t channel, const std::string& variable)
+	{
+		if(id == 0 || (uint32_t)type > Peer::AssignmentType::role) return;
+		std::lock_guard<std::mutex> assignmentIndexGuard(_assignmentIndexMutex);
+		_assignmentIndex[type][id][peerId][channel].emplace(variable);
+		_assignmentKeysByPeer[peerId].emplace((int32_t)type, id);
+	}
+
+	void ICentral::onAssignmentRemoved(Peer::AssignmentType::Enum type, uint64_t id, uint64_t peerId, int32_t channel, const std::string& variable)
+	{
+		if(id == 0 || (uint32_t)type > Peer::AssignmentType::role) return;
+		std::lock_guard<std::mutex> assignmentIndexGuard(_assignmentIndexMutex);
+		auto idIterator = _assignmentIndex[type].find(id);
+		if(idIterator == _assignmentIndex[type].end()) return;
+		auto peerIterator = idIterator->second.find(peerId);
+		if(peerIterator == idIterator->second.end()) return;
+		auto channelIterator = peerIterator->second.find(channel);
+		if(channelIterator == peerIterator->second.end()) return;
+
+		channelIterator->second.erase(variable);
+		if(!channelIterator->second.empty()) return;
+		peerIterator->second.erase(channelIterator);
+		if(!peerIterator->second.empty()) return;
+		idIterator->second.erase(peerIterator);
+		if(idIterator->second.empty()) _assignmentIndex[type].erase(idIterator);
+
+		auto keysIterator = _assignmentKeysByPeer.find(peerId);
+		if(keysIterator == _assignmentKeysByPeer.end()) return;
+		keysIterator->second.erase(std::make_pair((int32_t)type, id));
+		if(keysIterator->second.empty()) _assignmentKeysByPeer.erase(keysIterator);
+	}
+
+	void ICentral::onAssignmentsReset(uint64_t peerId, const std::vector<Peer::Assignment>& assignments, bool indexed)
+	{
+		std::lock_guard<std::mutex> assignmentIndexGuard(_assignmentIndexMutex);
+		if(indexed) _unindexedPeers.erase(peerId);
+		else _unindexedPeers.emplace(peerId);
+		auto keysIterator = _assignmentKeysByPeer.find(peerId);
+		if(keysIterator != _assignmentKeysByPeer.end())
+		{
+			for(auto& key : keysIterator->second)
+			{
+				auto& index = _assignmentIndex[key.first];
+				auto idIterator = index.find(key.second);
+				if(idIterator == index.end()) continue;
+				idIterator->second.erase(peerId);
+				if(idIterator->second.empty()) index.erase(idIterator);
+			}
+			_assignmentKeysByPeer.erase(keysIterator);
+		}
+
+		for(auto& assignment : assignments)
+		{
+			if(assignment.id == 0 || (uint32_t)assignment.type > Peer::AssignmentType::role) continue;
+			_assignmentIndex[assignment.type][assignment.id][peerId][assignment.channel].emplace(assignment.variable);
+			_assignmentKeysByPeer[peerId].emplace((int32_t)assignment.type, assignment.id);
+		}
+	}
 // }}}
 
+std::map<uint64_t, std::map<int32_t, std::set<std::string>>> ICentral::getAssignments(Peer::AssignmentType::Enum type, uint64_t id)
+{
+	try
+	{
+		if((uint32_t)type > Peer::AssignmentType::role) return AssignedPeers();
+		std::lock_guard<std::mutex> assignmentIndexGuard(_assignmentIndexMutex);
+		auto idIterator = _assignmentIndex[type].find(id);
+		if(idIterator != _assignmentIndex[type].end()) return idIterator->second;
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return AssignedPeers();
+}
+
+std::vector<std::shared_ptr<Peer>> ICentral::getUnindexedPeers()
+{
+	std::vector<std::shared_ptr<Peer>> peers;
+	try
+	{
+		std::set<uint64_t> peerIds;
+		{
+			std::lock_guard<std::mutex> assignmentIndexGuard(_assignmentIndexMutex);
+			if(_unindexedPeers.empty()) return peers;
+			peerIds = _unindexedPeers;
+		}
+		peers.reserve(peerIds.size());
+		for(auto peerId : peerIds)
+		{
+			auto peer = getPeer(peerId);
+			if(peer) peers.push_back(peer);
+		}
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+	return peers;
+}
+
+PVariable ICentral::getDeletedPeersSince(uint64_t since, bool& complete)
+{
+	PVariable deleted = std::make_shared<Variable>(VariableType::tArray);
+	std::lock_guard<std::mutex> deletedPeersGuard(_deletedPeersMutex);
+	//Tokens of other runs are either lower than the horizon or higher than the current change sequence.
+	complete = since == 0 || since < _deletedPeersHorizon || !Peer::isKnownChangeSequence(since);
+	if(complete) return deleted;
+	for(auto i = _deletedPeers.rbegin(); i != _deletedPeers.rend() && i->first > since; ++i)
+	{
+		deleted->arrayValue->push_back(std::make_shared<Variable>(i->second));
+	}
+	return deleted;
+}
+
+namespace
+{
+	/**
+	 * Splits 0 to count - 1 into "threadCount" contiguous ranges and calls "function" for each index. The calling thread processes
+	 * the first range itself. An exception thrown by "function" doesn't stop the other indexes from being processed. The first one is
+	 * rethrown when all ranges are done, the others are logged.
+	 */
+	void forEachIndex(SharedObjects* bl, size_t count, size_t threadCount, const std::function<void(size_t index)>& function)
+	{
+		std::mutex exceptionMutex;
+		std::exception_ptr exception;
+		auto processRange = [&](size_t start, size_t end)
+		{
+			for(size_t i = start; i < end; i++)
+			{
+				try
+				{
+					function(i);
+				}
+				catch(const std::exception& ex)
+				{
+					std::lock_guard<std::mutex> exceptionGuard(exceptionMutex);
+					if(!exception) exception = std::current_exception();
+					else bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+				}
+				catch(...)
+				{
+					//Nothing may escape, as ranges run in threads of their own.
+					std::lock_guard<std::mutex> exceptionGuard(exceptionMutex);
+					if(!exception) exception = std::current_exception();
+					else bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__);
+				}
+			}
+		};
+
+		if(threadCount > count) threadCount = count;
+		if(threadCount <= 1)
+		{
+			processRange(0, count);
+			if(exception) std::rethrow_exception(exception);
+			return;
+		}
+
+		//Tasks of the thread pool must not wait for other tasks, so pool workers fall back to separate threads.
+		bool useThreadPool = bl->threadManager.threadPoolRunning() && !bl->threadManager.isThreadPoolWorker();
+		size_t rangeSize = (count + threadCount - 1) / threadCount;
+		std::vector<std::future<void>> futures;
+		std::vector<std::thread> threads;
+		futures.reserve(threadCount);
+		threads.reserve(threadCount);
+
+		for(size_t start = rangeSize; start < count; start += rangeSize)
+		{
+			size_t end = std::min(start + rangeSize, count);
+			if(useThreadPool)
+			{
+				try
+				{
+					futures.push_back(bl->threadManager.submit(processRange, start, end));
+					continue;
+				}
+				catch(const Exception& ex)
+				{
+					useThreadPool = false;
+				}
+			}
+
+			threads.emplace_back();
+			if(!bl->threadManager.start(threads.back(), false, processRange, start, end))
+			{
+				threads.pop_back();
+				processRange(start, end);
+			}
+		}
+
+		processRange(0, std::min(rangeSize, count));
+
+		for(auto& future : futures)
+		{
+			future.wait();
+		}
+		for(auto& thread : threads)
+		{
+			bl->threadManager.join(thread);
+		}
+		if(exception) std::rethrow_exception(exception);
+	}
+}
+
+void ICentral::forEachPeer(const std::vector<std::shared_ptr<Peer>>& peers, const std::function<void(size_t index, const std::shared_ptr<Peer>& peer)>& function)
+{
+	forEachIndex(_bl, peers.size(), _bl->settings.rpcBulkThreadCount(), [&](size_t index) { function(index, peers[index]); });
+}
+
+void ICentral::loadPeersInParallel(const std::function<void(std::map<uint32_t, std::shared_ptr<Database::DataColumn>>& row, std::shared_ptr<Database::DataTable>& config)>& loadPeer)
+{
+	try
+	{
+		auto startTime = std::chrono::steady_clock::now();
+
+		std::unordered_map<uint64_t, std::shared_ptr<Database::DataTable>> configs;
+		_bl->db->getPeerParametersOfCentral(_deviceId, [&](uint64_t peerId, std::shared_ptr<Database::DataTable>& rows) { configs[peerId] = rows; });
+		std::shared_ptr<Database::DataTable> peerRows = _bl->db->getPeers(_deviceId);
+
+		auto databaseTime = std::chrono::steady_clock::now();
+
+		size_t threadCount = _bl->settings.peerLoadThreadCount();
+		loadPeersInParallel(*peerRows, configs, threadCount, loadPeer);
+
+		auto endTime = std::chrono::steady_clock::now();
+		_bl->out.printInfo("Info: Loaded " + std::to_string(peerRows->size()) + " peers of central " + std::to_string(_deviceId) + " in " + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count()) + " ms (database: " + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(databaseTime - startTime).count()) + " ms, threads: " + std::to_string(std::min(threadCount, peerRows->size())) + ").");
+	}
+	catch(const std::exception& ex)
+	{
+		_bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+	}
+}
+
+void ICentral::loadPeersInParallel(Database::DataTable& peerRows, std::unordered_map<uint64_t, std::shared_ptr<Database::DataTable>>& configs, size_t threadCount, const std::function<void(std::map<uint32_t, std::shared_ptr<Database::DataColumn>>& row, std::shared_ptr<Database::DataTable>& config)>& loadPeer)
+{
+	std::vector<std::map<uint32_t, std::shared_ptr<Database::DataColumn>>*> rows;
+	std::vector<std::shared_ptr<Database::DataTable>> peerConfigs;
+	rows.reserve(peerRows.size());
+	peerConfigs.reserve(peerRows.size());
+	for(auto& row : peerRows)
+	{
+		if(row.second.empty()) continue;
+		//Peers the database controller returned no parameters for get no config, so Peer::load() reads their parameters itself.
+		auto configIterator = configs.find((uint64_t)row.second.at(0)->intValue);
+		rows.push_back(&row.second);
+		peerConfigs.push_back(configIterator != configs.end() ? configIterator->second : std::shared_ptr<Database::DataTable>());
+	}
+	configs.clear();
+
+	forEachIndex(_bl, rows.size(), threadCount, [&](size_t index)
+	{
+		loadPeer(*rows[index], peerConfigs[index]);
+		peerConfigs[index].reset();
+	});
+}
+
 std::vector<std::shared_ptr<Peer>> ICentral::getPeers()
 {
 	try
@@ -289,6 +584,12 @@ bool ICentral::peerExists(uint64_t id)
     return false;
 }
 
+uint64_t ICentral::getDescriptionChangeSequence()
+{
+	//Both come from the same monotonic counter. Peer changes are tracked process wide, which only invalidates a little too often.
+	return std::max(_peersChangeSequence.load(), Peer::getLastDescriptionChangeSequence());
+}
+
 bool ICentral::peerExists(std::string serialNumber)
 {
 	try
@@ -314,6 +615,28 @@ void ICentral::setPeerId(uint64_t oldPeerId, uint64_t newPeerId)
 			if(_peersById.find(oldPeerId) != _peersById.end()) _peersById.erase(oldPeerId);
 			_peersById[newPeerId] = peer;
 		}
+		_peersChangeSequence = Peer::nextChangeSequence();
+
+		{
+			std::lock_guard<std::mutex> assignmentIndexGuard(_assignmentIndexMutex);
+			auto keysIterator = _assignmentKeysByPeer.find(oldPeerId);
+			if(keysIterator != _assignmentKeysByPeer.end())
+			{
+				for(auto& key : keysIterator->second)
+				{
+					auto& index = _assignmentIndex[key.first];
+					auto idIterator = index.find(key.second);
+					if(idIterator == index.end()) continue;
+					auto peerIterator = idIterator->second.find(oldPeerId);
+					if(peerIterator == idIterator->second.end()) continue;
+					idIterator->second[newPeerId] = std::move(peerIterator->second);
+					idIterator->second.erase(oldPeerId);
+				}
+				_assignmentKeysByPeer[newPeerId] = std::move(keysIterator->second);
+				_assignmentKeysByPeer.erase(oldPeerId);
+			}
+			if(_unindexedPeers.erase(oldPeerId) > 0) _unindexedPeers.emplace(newPeerId);
+		}
 
 		std::vector<std::shared_ptr<Peer>> peers = getPeers();
 		for(std::vector<std::shared_ptr<Peer>>::iterator i = peers.begin(); i != peers.end(); ++i)
@@ -560,12 +883,14 @@ PVariable ICentral::getAllConfig(PRpcClientInfo clientInfo, uint64_t peerId, boo
 		{
 			//Copy all peers first, because getAllConfig takes very long and we don't want to lock _peersMutex too long
 			std::vector<std::shared_ptr<Peer>> peers = getPeers();
+			if(checkAcls) peers.erase(std::remove_if(peers.begin(), peers.end(), [&](const std::shared_ptr<Peer>& peer) { return !clientInfo->acls->checkDeviceReadAccess(peer); }), peers.end());
 
-			for(std::vector<std::shared_ptr<Peer>>::iterator i = peers.begin(); i != peers.end(); ++i)
-			{
-				if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(*i)) continue;
+			std::vector<PVariable> configs(peers.size());
+			forEachPeer(peers, [&](size_t index, const std::shared_ptr<Peer>& peer) { configs[index] = peer->getAllConfig(clientInfo); });
 
-				PVariable config = (*i)->getAllConfig(clientInfo);
+			array->arrayValue->reserve(configs.size());
+			for(auto& config : configs)
+			{
 				if(!config || config->errorStruct) continue;
 				array->arrayValue->push_back(config);
 			}
@@ -608,13 +933,14 @@ PVariable ICentral::getAllValues(PRpcClientInfo clientInfo, BaseLib::PArray peer
 		{
 			//Copy all peers first, because getAllValues takes very long and we don't want to lock _peersMutex too long
 			std::vector<std::shared_ptr<Peer>> peers = getPeers();
+			if(checkAcls) peers.erase(std::remove_if(peers.begin(), peers.end(), [&](const std::shared_ptr<Peer>& peer) { return !clientInfo->acls->checkDeviceReadAccess(peer); }), peers.end());
 
-            array->arrayValue->reserve(peers.size());
-			for(auto& peer : peers)
-			{
-                if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
+			std::vector<PVariable> peerValues(peers.size());
+			forEachPeer(peers, [&](size_t index, const std::shared_ptr<Peer>& peer) { peerValues[index] = peer->getAllValues(clientInfo, returnWriteOnly, checkAcls); });
 
-				PVariable values = peer->getAllValues(clientInfo, returnWriteOnly, checkAcls);
+            array->arrayValue->reserve(peerValues.size());
+			for(auto& values : peerValues)
+			{
 				if(!values || values->errorStruct) continue;
 				array->arrayValue->push_back(values);
 			}
@@ -629,13 +955,83 @@ PVariable ICentral::getAllValues(PRpcClientInfo clientInfo, BaseLib::PArray peer
     return Variable::createError(-32500, "Unknown application error.");
 }
 
+PVariable ICentral::getAllValuesSince(PRpcClientInfo clientInfo, BaseLib::PArray peerIds, bool returnWriteOnly, uint64_t since, bool checkAcls)
+{
+	try
+	{
+		//Get the token first, so changes made while collecting the values are returned again by the next call
+		uint64_t sequence = Peer::getCurrentChangeSequence();
+		bool complete = false;
+		PVariable deleted = getDeletedPeersSince(since, complete);
+		if(complete) since = 0;
+
+		std::vector<std::shared_ptr<Peer>> peers;
+		if(!peerIds->empty())
+		{
+			peers.reserve(peerIds->size());
+			for(auto& peerId : *peerIds)
+			{
+				std::shared_ptr<Peer> peer = getPeer((uint64_t)peerId->integerValue64);
+				if(peer) peers.push_back(peer);
+			}
+		}
+		else peers = getPeers();
+
+		peers.erase(std::remove_if(peers.begin(), peers.end(), [&](const std::shared_ptr<Peer>& peer)
+		{
+			if(since > 0 && peer->getChangeSequence() <= since) return true;
+			return checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer);
+		}), peers.end());
+
+		std::vector<PVariable> peerValues(peers.size());
+		forEachPeer(peers, [&](size_t index, const std::shared_ptr<Peer>& peer) { peerValues[index] = peer->getAllValuesSince(clientInfo, returnWriteOnly, since, checkAcls); });
+
+		PVariable values = std::make_shared<Variable>(VariableType::tArray);
+		values->arrayValue->reserve(peerValues.size());
+		for(auto& element : peerValues)
+		{
+			if(!element || element->errorStruct) continue;
+			values->arrayValue->push_back(element);
+		}
+
+		PVariable result = std::make_shared<Variable>(VariableType::tStruct);
+		result->structValue->emplace("SEQUENCE", std::make_shared<Variable>(sequence));
+		result->structValue->emplace("COMPLETE", std::make_shared<Variable>(complete));
+		result->structValue->emplace("VALUES", values);
+		result->structValue->emplace("DELETED", deleted);
+		return result;
+	}
+	catch(const std::exception& ex)
+    {
+        _bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return Variable::createError(-32500, "Unknown application error.");
+}
+
 PVariable ICentral::getChannelsInCategory(PRpcClientInfo clientInfo, uint64_t categoryId, bool checkAcls)
 {
 	try
 	{
 		PVariable result = std::make_shared<Variable>(VariableType::tStruct);
-		std::vector<std::shared_ptr<Peer>> peers = getPeers();
-		for(auto peer : peers)
+		auto assignedPeers = getAssignments(Peer::AssignmentType::category, categoryId);
+		for(auto& assignedPeer : assignedPeers)
+		{
+			auto peer = getPeer(assignedPeer.first);
+			if(!peer) continue;
+			if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
+
+			PVariable channelResult = std::make_shared<Variable>(VariableType::tArray);
+			channelResult->arrayValue->reserve(assignedPeer.second.size());
+			for(auto& channelIterator : assignedPeer.second)
+			{
+				//An empty variable name marks the assignment of the channel itself
+				if(channelIterator.second.find("") == channelIterator.second.end()) continue;
+				channelResult->arrayValue->push_back(std::make_shared<Variable>(channelIterator.first));
+			}
+
+			if(!channelResult->arrayValue->empty()) result->structValue->emplace(std::to_string(assignedPeer.first), channelResult);
+		}
+		for(auto& peer : getUnindexedPeers())
 		{
 			if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
 
@@ -647,7 +1043,7 @@ PVariable ICentral::getChannelsInCategory(PRpcClientInfo clientInfo, uint64_t ca
 				channelResult->arrayValue->push_back(std::make_shared<Variable>(channel));
 			}
 
-            if(!channelResult->arrayValue->empty()) result->structValue->emplace(std::to_string(peer->getID()), channelResult);
+			if(!channelResult->arrayValue->empty()) result->structValue->emplace(std::to_string(peer->getID()), channelResult);
 		}
 		return result;
 	}
@@ -663,20 +1059,37 @@ PVariable ICentral::getChannelsInRoom(PRpcClientInfo clientInfo, uint64_t roomId
 	try
 	{
 		PVariable result = std::make_shared<Variable>(VariableType::tStruct);
-		std::vector<std::shared_ptr<Peer>> peers = getPeers();
-		for(auto peer : peers)
+		auto assignedPeers = getAssignments(Peer::AssignmentType::room, roomId);
+		for(auto& assignedPeer : assignedPeers)
+		{
+			auto peer = getPeer(assignedPeer.first);
+			if(!peer) continue;
+			if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
+
+			PVariable channelResult = std::make_shared<Variable>(VariableType::tArray);
+			channelResult->arrayValue->reserve(assignedPeer.second.size());
+			for(auto& channelIterator : assignedPeer.second)
+			{
+				//An empty variable name marks the assignment of the channel itself
+				if(channelIterator.second.find("") == channelIterator.second.end()) continue;
+				channelResult->arrayValue->push_back(std::make_shared<Variable>(channelIterator.first));
+			}
+
+			if(!channelResult->arrayValue->empty()) result->structValue->emplace(std::to_string(assignedPeer.first), channelResult);
+		}
+		for(auto& peer : getUnindexedPeers())
 		{
 			if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
 
 			auto channels = peer->getChannelsInRoom(roomId);
-			PVariable roomsResult = std::make_shared<Variable>(VariableType::tArray);
-			roomsResult->arrayValue->reserve(channels.size());
+			PVariable channelResult = std::make_shared<Variable>(VariableType::tArray);
+			channelResult->arrayValue->reserve(channels.size());
 			for(auto channel : channels)
 			{
-				roomsResult->arrayValue->push_back(std::make_shared<Variable>(channel));
+				channelResult->arrayValue->push_back(std::make_shared<Variable>(channel));
 			}
 
-			if(!roomsResult->arrayValue->empty()) result->structValue->emplace(std::to_string(peer->getID()), roomsResult);
+			if(!channelResult->arrayValue->empty()) result->structValue->emplace(std::to_string(peer->getID()), channelResult);
 		}
 		return result;
 	}
@@ -774,11 +1187,14 @@ PVariable ICentral::getDeviceInfo(PRpcClientInfo clientInfo, uint64_t id, std::m
 				}
 			}
 
-			for(auto& peer : peers)
-			{
-				if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
+			if(checkAcls) peers.erase(std::remove_if(peers.begin(), peers.end(), [&](const std::shared_ptr<Peer>& peer) { return !clientInfo->acls->checkDeviceReadAccess(peer); }), peers.end());
+
+			std::vector<PVariable> infos(peers.size());
+			forEachPeer(peers, [&](size_t index, const std::shared_ptr<Peer>& peer) { infos[index] = peer->getDeviceInfo(clientInfo, fields); });
 
-				PVariable info = peer->getDeviceInfo(clientInfo, fields);
+			array->arrayValue->reserve(infos.size());
+			for(auto& info : infos)
+			{
 				if(!info) continue;
 				array->arrayValue->push_back(info);
 			}
@@ -798,9 +1214,16 @@ PVariable ICentral::getDevicesInCategory(PRpcClientInfo clientInfo, uint64_t cat
 	try
 	{
 		PVariable result = std::make_shared<Variable>(VariableType::tArray);
-		std::vector<std::shared_ptr<Peer>> peers = getPeers();
-		result->arrayValue->reserve(peers.size());
-		for(auto peer : peers)
+		auto assignedPeers = getAssignments(Peer::AssignmentType::category, categoryId);
+		result->arrayValue->reserve(assignedPeers.size());
+		for(auto& assignedPeer : assignedPeers)
+		{
+			auto channelIterator = assignedPeer.second.find(-1);
+			if(channelIterator == assignedPeer.second.end() || channelIterator->second.find("") == channelIterator->second.end()) continue;
+			if(!peerExists(assignedPeer.first)) continue;
+			result->arrayValue->push_back(std::make_shared<Variable>(assignedPeer.first));
+		}
+		for(auto& peer : getUnindexedPeers())
 		{
 			if(peer->hasCategory(-1, categoryId)) result->arrayValue->push_back(std::make_shared<Variable>(peer->getID()));
 		}
@@ -818,9 +1241,16 @@ PVariable ICentral::getDevicesInRoom(PRpcClientInfo clientInfo, uint64_t roomId,
 	try
 	{
 		PVariable result = std::make_shared<Variable>(VariableType::tArray);
-		std::vector<std::shared_ptr<Peer>> peers = getPeers();
-		result->arrayValue->reserve(peers.size());
-		for(auto peer : peers)
+		auto assignedPeers = getAssignments(Peer::AssignmentType::room, roomId);
+		result->arrayValue->reserve(assignedPeers.size());
+		for(auto& assignedPeer : assignedPeers)
+		{
+			auto channelIterator = assignedPeer.second.find(-1);
+			if(channelIterator == assignedPeer.second.end() || channelIterator->second.find("") == channelIterator->second.end()) continue;
+			if(!peerExists(assignedPeer.first)) continue;
+			result->arrayValue->push_back(std::make_shared<Variable>(assignedPeer.first));
+		}
+		for(auto& peer : getUnindexedPeers())
 		{
 			if(peer->getRoom(-1) == roomId) result->arrayValue->push_back(std::make_shared<Variable>(peer->getID()));
 		}
@@ -940,13 +1370,15 @@ PVariable ICentral::getLinks(PRpcClientInfo clientInfo, uint64_t peerId, int32_t
 		{
 			//Copy all peers first, because getLinks takes very long and we don't want to lock _peersMutex too long
 			std::vector<std::shared_ptr<Peer>> peers = getPeers();
+			if(checkAcls) peers.erase(std::remove_if(peers.begin(), peers.end(), [&](const std::shared_ptr<Peer>& peer) { return !clientInfo->acls->checkDeviceReadAccess(peer); }), peers.end());
 
-			for(auto& peer : peers)
-			{
-				if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
+			std::vector<PVariable> links(peers.size());
+			forEachPeer(peers, [&](size_t index, const std::shared_ptr<Peer>& peer) { links[index] = peer->getLink(clientInfo, channel, flags, true); });
 
-				element = peer->getLink(clientInfo, channel, flags, true);
-				array->arrayValue->insert(array->arrayValue->begin(), element->arrayValue->begin(), element->arrayValue->end());
+			for(auto& peerLinks : links)
+			{
+				if(!peerLinks) continue;
+				array->arrayValue->insert(array->arrayValue->begin(), peerLinks->arrayValue->begin(), peerLinks->arrayValue->end());
 			}
 		}
 		else
@@ -1401,9 +1833,30 @@ PVariable ICentral::getVariablesInCategory(PRpcClientInfo clientInfo, uint64_t c
     {
         PVariable variables = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
 
-        std::vector<std::shared_ptr<Peer>> peers = getPeers();
+        auto assignedPeers = getAssignments(Peer::AssignmentType::category, categoryId);
+        for(auto& assignedPeer : assignedPeers)
+        {
+            auto peer = getPeer(assignedPeer.first);
+            if(!peer) continue;
+            if(checkDeviceAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
 
-        for(std::shared_ptr<Peer> peer : peers)
+            auto channels = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+            for(auto& channelIterator : assignedPeer.second)
+            {
+                auto channelVariables = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tArray);
+                channelVariables->arrayValue->reserve(channelIterator.second.size());
+                for(auto& variableName : channelIterator.second)
+                {
+                    if(variableName.empty()) continue;
+                    if(checkVariableAcls && !clientInfo->acls->checkVariableReadAccess(peer, channelIterator.first, variableName)) continue;
+                    channelVariables->arrayValue->push_back(std::make_shared<BaseLib::Variable>(variableName));
+                }
+                if(!channelVariables->arrayValue->empty()) channels->structValue->emplace(std::to_string(channelIterator.first), channelVariables);
+            }
+            if(!channels->structValue->empty()) variables->structValue->emplace(std::to_string(assignedPeer.first), channels);
+        }
+
+        for(auto& peer : getUnindexedPeers())
         {
             if(checkDeviceAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
 
@@ -1426,9 +1879,37 @@ PVariable ICentral::getVariablesInRole(PRpcClientInfo clientInfo, uint64_t roleI
 	{
 		PVariable variables = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
 
-		std::vector<std::shared_ptr<Peer>> peers = getPeers();
+		auto assignedPeers = getAssignments(Peer::AssignmentType::role, roleId);
+		for(auto& assignedPeer : assignedPeers)
+		{
+			auto peer = getPeer(assignedPeer.first);
+			if(!peer) continue;
+			if(checkDeviceAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
+
+			auto channels = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+			for(auto& channelIterator : assignedPeer.second)
+			{
+				auto channelVariables = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+				for(auto& variableName : channelIterator.second)
+				{
+					if(variableName.empty()) continue;
+					if(checkVariableAcls && !clientInfo->acls->checkVariableReadAccess(peer, channelIterator.first, variableName)) continue;
+
+					std::string name = variableName;
+					auto roles = peer->getVariableRoles(channelIterator.first, name);
+					auto roleIterator = roles.find(roleId);
+					if(roleIterator == roles.end()) continue;
+					auto entry = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+					entry->structValue->emplace("direction", std::make_shared<BaseLib::Variable>((int32_t)roleIterator->second.direction));
+					if(roleIterator->second.invert) entry->structValue->emplace("invert", std::make_shared<BaseLib::Variable>(roleIterator->second.invert));
+					channelVariables->structValue->emplace(variableName, entry);
+				}
+				if(!channelVariables->structValue->empty()) channels->structValue->emplace(std::to_string(channelIterator.first), channelVariables);
+			}
+			if(!channels->structValue->empty()) variables->structValue->emplace(std::to_string(assignedPeer.first), channels);
+		}
 
-		for(std::shared_ptr<Peer> peer : peers)
+		for(auto& peer : getUnindexedPeers())
 		{
 			if(checkDeviceAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
 
@@ -1451,9 +1932,30 @@ PVariable ICentral::getVariablesInRoom(PRpcClientInfo clientInfo, uint64_t categ
     {
         PVariable variables = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
 
-        std::vector<std::shared_ptr<Peer>> peers = getPeers();
+        auto assignedPeers = getAssignments(Peer::AssignmentType::room, categoryId);
+        for(auto& assignedPeer : assignedPeers)
+        {
+            auto peer = getPeer(assignedPeer.first);
+            if(!peer) continue;
+            if(checkDeviceAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
 
-        for(std::shared_ptr<Peer> peer : peers)
+            auto channels = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+            for(auto& channelIterator : assignedPeer.second)
+            {
+                auto channelVariables = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tArray);
+                channelVariables->arrayValue->reserve(channelIterator.second.size());
+                for(auto& variableName : channelIterator.second)
+                {
+                    if(variableName.empty()) continue;
+                    if(checkVariableAcls && !clientInfo->acls->checkVariableReadAccess(peer, channelIterator.first, variableName)) continue;
+                    channelVariables->arrayValue->push_back(std::make_shared<BaseLib::Variable>(variableName));
+                }
+                if(!channelVariables->arrayValue->empty()) channels->structValue->emplace(std::to_string(channelIterator.first), channelVariables);
+            }
+            if(!channels->structValue->empty()) variables->structValue->emplace(std::to_string(assignedPeer.first), channels);
+        }
+
+        for(auto& peer : getUnindexedPeers())
         {
             if(checkDeviceAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
 
@@ -1482,13 +1984,17 @@ PVariable ICentral::listDevices(PRpcClientInfo clientInfo, bool channels, std::m
 		PVariable array(new Variable(VariableType::tArray));
 
 		std::vector<std::shared_ptr<Peer>> peers = getPeers();
-
-		for(std::shared_ptr<Peer> peer : peers)
+		peers.erase(std::remove_if(peers.begin(), peers.end(), [&](const std::shared_ptr<Peer>& peer)
 		{
-			if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) continue;
+			if(checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer)) return true;
+			return knownDevices && knownDevices->find(peer->getID()) != knownDevices->end();
+		}), peers.end());
 
-			if(knownDevices && knownDevices->find(peer->getID()) != knownDevices->end()) continue;
-			std::shared_ptr<std::vector<PVariable>> descriptions = peer->getDeviceDescriptions(clientInfo, channels, fields);
+		std::vector<std::shared_ptr<std::vector<PVariable>>> peerDescriptions(peers.size());
+		forEachPeer(peers, [&](size_t index, const std::shared_ptr<Peer>& peer) { peerDescriptions[index] = peer->getDeviceDescriptions(clientInfo, channels, fields); });
+
+		for(auto& descriptions : peerDescriptions)
+		{
 			if(!descriptions) continue;
 			for(PVariable description : *descriptions)
 			{
@@ -1505,6 +2011,46 @@ PVariable ICentral::listDevices(PRpcClientInfo clientInfo, bool channels, std::m
     return Variable::createError(-32500, "Unknown application error.");
 }
 
+PVariable ICentral::listDevicesSince(PRpcClientInfo clientInfo, bool channels, std::map<std::string, bool> fields, uint64_t since, bool checkAcls)
+{
+	try
+	{
+		uint64_t sequence = Peer::getCurrentChangeSequence();
+		bool complete = false;
+		PVariable deleted = getDeletedPeersSince(since, complete);
+		if(complete) since = 0;
+
+		std::vector<std::shared_ptr<Peer>> peers = getPeers();
+		peers.erase(std::remove_if(peers.begin(), peers.end(), [&](const std::shared_ptr<Peer>& peer)
+		{
+			if(since > 0 && peer->getDescriptionChangeSequence() <= since) return true;
+			return checkAcls && !clientInfo->acls->checkDeviceReadAccess(peer);
+		}), peers.end());
+
+		std::vector<std::shared_ptr<std::vector<PVariable>>> peerDescriptions(peers.size());
+		forEachPeer(peers, [&](size_t index, const std::shared_ptr<Peer>& peer) { peerDescriptions[index] = peer->getDeviceDescriptions(clientInfo, channels, fields); });
+
+		PVariable devices = std::make_shared<Variable>(VariableType::tArray);
+		for(auto& descriptions : peerDescriptions)
+		{
+			if(!descriptions) continue;
+			devices->arrayValue->insert(devices->arrayValue->end(), descriptions->begin(), descriptions->end());
+		}
+
+		PVariable result = std::make_shared<Variable>(VariableType::tStruct);
+		result->structValue->emplace("SEQUENCE", std::make_shared<Variable>(sequence));
+		result->structValue->emplace("COMPLETE", std::make_shared<Variable>(complete));
+		result->structValue->emplace("DEVICES", devices);
+		result->structValue->emplace("DELETED", deleted);
+		return result;
+	}
+	catch(const std::exception& ex)
+    {
+        _bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return Variable::createError(-32500, "Unknown application error.");
+}
+
 PVariable ICentral::listTeams(BaseLib::PRpcClientInfo clientInfo, bool checkAcls)
 {
 	try
@@ -37,8 +37,10 @@
 #include "../Sockets/RpcClientInfo.h"
 #include "IPhysicalInterface.h"
 #include "Peer.h"
+#include "EventCoalescer.h"
 
 #include <set>
+#include <deque>
 
 using namespace BaseLib::DeviceDescription;
 
@@ -130,6 +132,13 @@ public:
 	virtual bool peerExists(int32_t address);
 	virtual bool peerExists(std::string serialNumber);
 	virtual bool peerExists(uint64_t id);
+
+	/**
+	 * Returns the change sequence of the last change affecting the device descriptions of the central's peers: peers being
+	 * created, deleted or renumbered and changes of names, rooms, categories or the configuration of peers. Responses of read only
+	 * RPC methods like listDevices can be cached as long as it stays the same (see Rpc::RpcResponseCache).
+	 */
+	uint64_t getDescriptionChangeSequence();
 	virtual uint64_t getPeerIdFromSerial(std::string& serialNumber);
 
 	virtual PVariable activateLinkParamset(PRpcClientInfo clientInfo, std::string serialNumber, int32_t channel, std::string remoteSerialNumber, int32_t remoteChannel, bool longPress) { return Variable::createError(-32601, "Method not implemented for this central."); }
@@ -144,6 +153,19 @@ public:
 	virtual PVariable deleteDevice(PRpcClientInfo clientInfo, uint64_t peerId, int32_t flags) { return Variable::createError(-32601, "Method not implemented for this central."); }
 	virtual PVariable getAllConfig(PRpcClientInfo clientInfo, uint64_t peerId, bool checkAcls);
 	virtual PVariable getAllValues(PRpcClientInfo clientInfo, BaseLib::PArray peerIds, bool returnWriteOnly, bool checkAcls);
+
+	/**
+	 * Delta variant of getAllValues. Only returns peers, channels and variables changed after the change sequence "since".
+	 *
+	 * @param clientInfo Information about the RPC client.
+	 * @param peerIds The peers to return or an empty array for all peers.
+	 * @param returnWriteOnly Also return write only variables.
+	 * @param since The value of "SEQUENCE" of the last call or 0 to get everything.
+	 * @param checkAcls Check the ACLs of the client.
+	 * @return Returns a Struct with the entries "SEQUENCE" (the token for the next call), "COMPLETE" (true when all values were
+	 * returned, because "since" was 0 or too old), "VALUES" (like getAllValues) and "DELETED" (IDs of peers deleted after "since").
+	 */
+	virtual PVariable getAllValuesSince(PRpcClientInfo clientInfo, BaseLib::PArray peerIds, bool returnWriteOnly, uint64_t since, bool checkAcls);
 	virtual PVariable getChannelsInCategory(PRpcClientInfo clientInfo, uint64_t categoryId, bool checkAcls);
 	virtual PVariable getChannelsInRoom(PRpcClientInfo clientInfo, uint64_t roomId, bool checkAcls);
 	virtual PVariable getConfigParameter(PRpcClientInfo clientInfo, std::string serialNumber, uint32_t channel, std::string name);
@@ -183,6 +205,12 @@ public:
 	virtual PVariable invokeFamilyMethod(PRpcClientInfo clientInfo, std::string& methodName, PArray parameters)  { return Variable::createError(-32601, "Method not implemented for this central."); }
 	virtual PVariable listDevices(PRpcClientInfo clientInfo, bool channels, std::map<std::string, bool> fields, bool checkAcls);
 	virtual PVariable listDevices(PRpcClientInfo clientInfo, bool channels, std::map<std::string, bool> fields, std::shared_ptr<std::set<uint64_t>> knownDevices, bool checkAcls);
+
+	/**
+	 * Delta variant of listDevices. Only returns the descriptions of peers whose description changed after the change sequence
+	 * "since". The returned Struct has the same entries as the one of getAllValuesSince with "DEVICES" instead of "VALUES".
+	 */
+	virtual PVariable listDevicesSince(PRpcClientInfo clientInfo, bool channels, std::map<std::string, bool> fields, uint64_t since, bool checkAcls);
 	virtual PVariable listTeams(BaseLib::PRpcClientInfo clientInfo, bool checkAcls);
 	virtual PVariable putParamset(PRpcClientInfo clientInfo, std::string serialNumber, int32_t channel, ParameterGroup::Type::Enum type, std::string remoteSerialNumber, int32_t remoteChannel, PVariable paramset);
 	virtual PVariable putParamset(PRpcClientInfo clientInfo, uint64_t peerId, int32_t channel, ParameterGroup::Type::Enum type, uint64_t remoteId, int32_t remoteChannel, PVariable paramset, bool checkAcls);
@@ -238,6 +266,55 @@ protected:
     std::map<int64_t, std::list<PPairingState>> _newPeers;
     std::list<PPairingMessage> _pairingMessages;
 
+    /**
+     * Merge the events of noisy peers before they are passed to RPC clients and to scripts. Only set when enabled by the settings
+     * "eventCoalescingInterval" or "eventCoalescingMinDelta" and "coalesceRpcEvents" or "coalesceScriptEvents" respectively.
+     */
+    std::unique_ptr<EventCoalescer> _rpcEventCoalescer;
+    std::unique_ptr<EventCoalescer> _eventCoalescer;
+
+    // {{{ Deleted peers for the delta variants of the bulk calls
+        static const size_t _maxDeletedPeers = 1000;
+        std::mutex _deletedPeersMutex;
+        /**
+         * Change sequence and ID of deleted peers, oldest first.
+         */
+        std::deque<std::pair<uint64_t, uint64_t>> _deletedPeers;
+        /**
+         * Change sequence of the newest entry removed from _deletedPeers. Older tokens require a full update. Starts at the
+         * initial change sequence, because deletions before the last restart are not known.
+         */
+        uint64_t _deletedPeersHorizon = Peer::getInitialChangeSequence();
+
+        /**
+         * Returns the IDs of all peers deleted after "since" and sets "complete" to true when "since" is 0 or older than
+         * _deletedPeersHorizon.
+         */
+        PVariable getDeletedPeersSince(uint64_t since, bool& complete);
+    // }}}
+
+    /**
+     * Change sequence of the last peer added, deleted or renumbered.
+     */
+    std::atomic<uint64_t> _peersChangeSequence{0};
+
+    // {{{ Room, category and role indexes
+        typedef std::map<uint64_t, std::map<int32_t, std::set<std::string>>> AssignedPeers;
+        std::mutex _assignmentIndexMutex;
+        /**
+         * Inverted indexes from room, category and role ID to the assigned channels and variables, indexed by Peer::AssignmentType.
+         */
+        std::unordered_map<uint64_t, AssignedPeers> _assignmentIndex[3];
+        /**
+         * Index keys (type and ID) every peer is listed under. Used to remove a peer from the indexes without scanning them.
+         */
+        std::unordered_map<uint64_t, std::set<std::pair<int32_t, uint64_t>>> _assignmentKeysByPeer;
+        /**
+         * Peers returning "false" for Peer::usesAssignmentIndex(). They are queried through their virtual methods.
+         */
+        std::set<uint64_t> _unindexedPeers;
+    // }}}
+
 	//Event handling
     std::map<std::string, PEventHandler> _physicalInterfaceEventhandlers;
 
@@ -272,8 +349,67 @@ protected:
 		virtual void onEvent(std::string& source, uint64_t peerID, int32_t channel, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<std::shared_ptr<BaseLib::Variable>>>& values);
 		virtual void onRunScript(ScriptEngine::PScriptInfo& scriptInfo, bool wait);
 		virtual BaseLib::PVariable onInvokeRpc(std::string& methodName, BaseLib::PArray& parameters);
+
+		virtual void onAssignmentAdded(Peer::AssignmentType::Enum type, uint64_t id, uint64_t peerId, int32_t channel, const std::string& variable);
+		virtual void onAssignmentRemoved(Peer::AssignmentType::Enum type, uint64_t id, uint64_t peerId, int32_t channel, const std::string& variable);
+		virtual void onAssignmentsReset(uint64_t peerId, const std::vector<Peer::Assignment>& assignments, bool indexed);
 	// }}}
 
+	/**
+	 * Returns all channels and variables assigned to a room, category or role. The result is a copy of the index entry, so no lock is
+	 * held while the caller accesses the peers.
+	 *
+	 * @param type The assignment type to look up.
+	 * @param id The ID of the room, category or role.
+	 * @return Returns a map with the peer ID as key and a map of channel to variable names as value. An empty variable name stands
+	 * for the channel itself.
+	 */
+	std::map<uint64_t, std::map<int32_t, std::set<std::string>>> getAssignments(Peer::AssignmentType::Enum type, uint64_t id);
+
+	/**
+	 * Returns the peers not listed in the room, category and role indexes (see Peer::usesAssignmentIndex()).
+	 */
+	std::vector<std::shared_ptr<Peer>> getUnindexedPeers();
+
+	/**
+	 * Calls "function" for every element of "peers". Depending on the setting "rpcBulkThreadCount", the peer list is split into
+	 * contiguous ranges which are processed in parallel. The calling thread processes the first range itself and returns when all
+	 * ranges are done. "function" gets the index of the peer, so callers can assemble the results in the order of "peers".
+	 *
+	 * When "function" throws, the remaining peers are still processed. The first exception is then rethrown to the caller and the
+	 * others are logged.
+	 *
+	 * @param peers The peers to process.
+	 * @param function The function to call for each peer. It is called from multiple threads at once.
+	 */
+	void forEachPeer(const std::vector<std::shared_ptr<Peer>>& peers, const std::function<void(size_t index, const std::shared_ptr<Peer>& peer)>& function);
+
+	/**
+	 * Helper for loadPeers(). Reads the parameters of all peers of this central with
+	 * IDatabaseController::getPeerParametersOfCentral() instead of one query per peer and then calls "loadPeer" for every row
+	 * returned by IDatabaseController::getPeers(). Depending on the setting "peerLoadThreadCount", the peers are loaded in
+	 * parallel. The time needed is logged.
+	 *
+	 * "loadPeer" creates the peer, passes "config" to Peer::setPreloadedConfig() and then calls Peer::load(). As it is called from
+	 * multiple threads at once, it needs to lock the peer maps when adding the peer, and Peer::load() must not depend on other peers
+	 * being loaded.
+	 *
+	 * @param loadPeer Called for each peer with the peer's row from getPeers() and its parameters. "config" is nullptr for peers the
+	 * database controller returned no parameters for, so Peer::load() reads them itself.
+	 */
+	void loadPeersInParallel(const std::function<void(std::map<uint32_t, std::shared_ptr<Database::DataColumn>>& row, std::shared_ptr<Database::DataTable>& config)>& loadPeer);
+
+	/**
+	 * Calls "loadPeer" for every row of "peerRows" in up to "threadCount" threads. See loadPeersInParallel() above.
+	 *
+	 * @param peerRows The rows returned by IDatabaseController::getPeers().
+	 * @param configs The parameters of the peers by peer ID. The map is cleared.
+	 * @param threadCount The maximum number of threads to use.
+	 * @param loadPeer Called for each peer.
+	 * @throws Exception Rethrows the first exception thrown by "loadPeer" after all peers are processed.
+	 */
+	void loadPeersInParallel(Database::DataTable& peerRows, std::unordered_map<uint64_t, std::shared_ptr<Database::DataTable>>& configs, size_t threadCount, const std::function<void(std::map<uint32_t, std::shared_ptr<Database::DataColumn>>& row, std::shared_ptr<Database::DataTable>& config)>& loadPeer);
+
 	virtual void setPeerId(uint64_t oldPeerId, uint64_t newPeerId);
 	virtual void deletePeersFromDatabase();
 	virtual void loadVariables() = 0;
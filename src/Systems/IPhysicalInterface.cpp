@@ -368,7 +368,7 @@ void IPhysicalInterface::setGPIO(uint32_t index, bool value)
 		{
 			_bl->out.printError("Could not write GPIO with index " + std::to_string(index) + ".");
 		}
-		_bl->out.printDebug("Debug: GPIO " + std::to_string(_settings->gpio.at(index).number) + " set to " + std::to_string(value) + ".");
+		_bl->out.printDebugLazy([&]() { return "Debug: GPIO " + std::to_string(_settings->gpio.at(index).number) + " set to " + std::to_string(value) + "."; });
 	}
 	catch(const std::exception& ex)
     {
@@ -1,5 +1,6 @@
 #include <memory>
 #include <iostream>
+#include <random>
 
 /* Copyright 2013-2019 Homegear GmbH
  *
@@ -51,8 +52,7 @@ RpcConfigurationParameter::RpcConfigurationParameter(RpcConfigurationParameter c
     _partialBinaryData = rhs._partialBinaryData;
     _logicalData = rhs._logicalData;
     _room = rhs._room;
-    _categories = rhs._categories;
-    _roles = rhs._roles;
+    if(rhs._assignments) _assignments.reset(new Assignments(*rhs._assignments));
 }
 
 RpcConfigurationParameter& RpcConfigurationParameter::operator=(const RpcConfigurationParameter& rhs)
@@ -65,27 +65,38 @@ RpcConfigurationParameter& RpcConfigurationParameter::operator=(const RpcConfigu
     _partialBinaryData = rhs._partialBinaryData;
     _logicalData = rhs._logicalData;
     _room = rhs._room;
-    _categories = rhs._categories;
-    _roles = rhs._roles;
+    if(rhs._assignments) _assignments.reset(new Assignments(*rhs._assignments));
+    else _assignments.reset();
     return *this;
 }
 
 std::string RpcConfigurationParameter::getCategoryString()
 {
-    std::lock_guard<std::mutex> categoriesGuard(_categoriesMutex);
+    std::lock_guard<std::mutex> assignmentsGuard(_assignmentsMutex);
+    if(!_assignments) return "";
     std::ostringstream categories;
-    for(auto category : _categories)
+    for(auto category : _assignments->categories)
     {
         categories << std::to_string(category) << ",";
     }
     return categories.str();
 }
 
+Role RpcConfigurationParameter::getRole(uint64_t id)
+{
+    std::lock_guard<std::mutex> assignmentsGuard(_assignmentsMutex);
+    if(!_assignments) return Role();
+    auto rolesIterator = _assignments->roles.find(id);
+    if(rolesIterator != _assignments->roles.end()) return rolesIterator->second;
+    return Role();
+}
+
 std::string RpcConfigurationParameter::getRoleString()
 {
-    std::lock_guard<std::mutex> rolesGuard(_rolesMutex);
+    std::lock_guard<std::mutex> assignmentsGuard(_assignmentsMutex);
+    if(!_assignments) return "";
     std::ostringstream roles;
-    for(auto role : _roles)
+    for(auto role : _assignments->roles)
     {
         roles << std::to_string(role.first) << "-" << std::to_string((int32_t)role.second.direction) << "-" << std::to_string((int32_t)role.second.invert) << ",";
     }
@@ -125,6 +136,12 @@ void RpcConfigurationParameter::setBinaryData(std::vector<uint8_t>& value) noexc
     _binaryData = value;
 }
 
+void RpcConfigurationParameter::setBinaryData(std::vector<uint8_t>&& value) noexcept
+{
+    std::lock_guard<std::mutex> dataGuard(_binaryDataMutex);
+    _binaryData = std::move(value);
+}
+
 std::vector<uint8_t> RpcConfigurationParameter::getPartialBinaryData() noexcept
 {
     std::lock_guard<std::mutex> dataGuard(_binaryDataMutex);
@@ -205,17 +222,31 @@ void ConfigDataBlock::setBinaryData(std::vector<uint8_t>& value) noexcept
     _binaryData = value;
 }
 
+void ConfigDataBlock::setBinaryData(std::vector<uint8_t>&& value) noexcept
+{
+    std::lock_guard<std::mutex> dataGuard(_binaryDataMutex);
+    _binaryData = std::move(value);
+}
+
 bool ConfigDataBlock::equals(std::vector<uint8_t>& value) noexcept
 {
     std::lock_guard<std::mutex> dataGuard(_binaryDataMutex);
     return value == _binaryData;
 }
 
+const uint64_t Peer::_initialChangeSequence = Peer::createInitialChangeSequence();
+std::atomic<uint64_t> Peer::_changeSequenceCounter{Peer::_initialChangeSequence};
+std::atomic<uint64_t> Peer::_lastDescriptionChangeSequence{Peer::_initialChangeSequence};
+
 Peer::Peer(SharedObjects* baseLib, uint32_t parentId, IPeerEventSink* eventHandler)
 {
     try
     {
         deleting = false;
+        _creationChangeSequence = ++_changeSequenceCounter;
+        _changeSequence = _creationChangeSequence.load();
+        _descriptionChangeSequence = _creationChangeSequence.load();
+        _lastDescriptionChangeSequence = _creationChangeSequence.load();
 
         _bl = baseLib;
         _parentID = parentId;
@@ -300,12 +331,14 @@ void Peer::raiseRemoveWebserverEventHandler()
 
 void Peer::raiseRPCEvent(std::string& source, uint64_t peerId, int32_t channel, std::string& deviceAddress, std::shared_ptr<std::vector<std::string>>& valueKeys, std::shared_ptr<std::vector<PVariable>>& values)
 {
+    if(peerId == _peerID && valueKeys) markValuesChanged(channel, *valueKeys);
     if(_peerID == 0) return;
     if(_eventHandler) ((IPeerEventSink*)_eventHandler)->onRPCEvent(source, peerId, channel, deviceAddress, valueKeys, values);
 }
 
 void Peer::raiseRPCUpdateDevice(uint64_t id, int32_t channel, std::string address, int32_t hint)
 {
+    if(id == _peerID) markChannelChanged(channel, true);
     if(_eventHandler) ((IPeerEventSink*)_eventHandler)->onRPCUpdateDevice(id, channel, address, hint);
 }
 
@@ -325,6 +358,28 @@ PVariable Peer::raiseInvokeRpc(std::string& methodName, PArray& parameters)
     if(_eventHandler) return ((IPeerEventSink*)_eventHandler)->onInvokeRpc(methodName, parameters);
     else return std::make_shared<Variable>();
 }
+
+void Peer::raiseAssignmentAdded(AssignmentType::Enum type, uint64_t id, int32_t channel, const std::string& variable)
+{
+    if(variable.empty()) markChannelChanged(channel, true);
+    else markValuesChanged(channel, std::vector<std::string>{ variable });
+    if(_peerID == 0 || id == 0 || !usesAssignmentIndex()) return;
+    if(_eventHandler) ((IPeerEventSink*)_eventHandler)->onAssignmentAdded(type, id, _peerID, channel, variable);
+}
+
+void Peer::raiseAssignmentRemoved(AssignmentType::Enum type, uint64_t id, int32_t channel, const std::string& variable)
+{
+    if(variable.empty()) markChannelChanged(channel, true);
+    else markValuesChanged(channel, std::vector<std::string>{ variable });
+    if(_peerID == 0 || id == 0 || !usesAssignmentIndex()) return;
+    if(_eventHandler) ((IPeerEventSink*)_eventHandler)->onAssignmentRemoved(type, id, _peerID, channel, variable);
+}
+
+void Peer::raiseAssignmentsReset(const std::vector<Assignment>& assignments, bool indexed)
+{
+    if(_peerID == 0) return;
+    if(_eventHandler) ((IPeerEventSink*)_eventHandler)->onAssignmentsReset(_peerID, assignments, indexed);
+}
 //End event handling
 
 //ServiceMessages event handling
@@ -348,19 +403,21 @@ void Peer::onSaveParameter(std::string name, uint32_t channel, std::vector<uint8
     try
     {
         if(_peerID == 0) return; //Peer not saved yet
-        if(valuesCentral.find(channel) == valuesCentral.end())
+        auto channelIterator = valuesCentral.find(channel);
+        if(channelIterator == valuesCentral.end())
         {
             //Service message variables sometimes just don't exist. So only output a debug message.
             if(channel != 0) _bl->out.printWarning("Warning: Could not set parameter " + name + " on channel " + std::to_string(channel) + " for peer " + std::to_string(_peerID) + ". Channel does not exist.");
-            else _bl->out.printDebug("Debug: Could not set parameter " + name + " on channel " + std::to_string(channel) + " for peer " + std::to_string(_peerID) + ". Channel does not exist.");
+            else _bl->out.printDebugLazy([&]() { return "Debug: Could not set parameter " + name + " on channel " + std::to_string(channel) + " for peer " + std::to_string(_peerID) + ". Channel does not exist."; });
             return;
         }
-        if(valuesCentral.at(channel).find(name) == valuesCentral.at(channel).end())
+        auto parameterIterator = channelIterator->second.find(name);
+        if(parameterIterator == channelIterator->second.end())
         {
-            if(_bl->debugLevel >= 5) _bl->out.printDebug("Debug: Could not set parameter " + name + " on channel " + std::to_string(channel) + " for peer " + std::to_string(_peerID) + ". Parameter does not exist.");
+            _bl->out.printDebugLazy([&]() { return "Debug: Could not set parameter " + name + " on channel " + std::to_string(channel) + " for peer " + std::to_string(_peerID) + ". Parameter does not exist."; });
             return;
         }
-        RpcConfigurationParameter& parameter = valuesCentral.at(channel).at(name);
+        RpcConfigurationParameter& parameter = parameterIterator->second;
         if(parameter.equals(data)) return;
         parameter.setBinaryData(data);
         saveParameter(parameter.databaseId, ParameterGroup::Type::Enum::variables, channel, name, data);
@@ -401,12 +458,71 @@ void Peer::onEnqueuePendingQueues()
 }
 //End ServiceMessages event handling
 
+// {{{ Change sequences
+uint64_t Peer::createInitialChangeSequence()
+{
+    //19 bits of epoch leave 44 bits for changes and keep tokens positive when they are transferred as signed 64 bit integers.
+    std::random_device randomDevice;
+    std::uniform_int_distribution<uint64_t> distribution(1, (1ull << 19) - 1);
+    return distribution(randomDevice) << 44;
+}
+
+uint64_t Peer::getChannelChangeSequence(int32_t channel)
+{
+    std::lock_guard<std::mutex> changeSequencesGuard(_changeSequencesMutex);
+    auto channelIterator = _channelChangeSequences.find(channel);
+    if(channelIterator == _channelChangeSequences.end()) return 0;
+    return channelIterator->second;
+}
+
+uint64_t Peer::getValueChangeSequence(int32_t channel, const std::string& name)
+{
+    std::lock_guard<std::mutex> changeSequencesGuard(_changeSequencesMutex);
+    auto channelIterator = _valueChangeSequences.find(channel);
+    if(channelIterator == _valueChangeSequences.end()) return 0;
+    auto valueIterator = channelIterator->second.find(name);
+    if(valueIterator == channelIterator->second.end()) return 0;
+    return valueIterator->second;
+}
+
+void Peer::markValuesChanged(int32_t channel, const std::vector<std::string>& names)
+{
+    uint64_t sequence = ++_changeSequenceCounter;
+    {
+        std::lock_guard<std::mutex> changeSequencesGuard(_changeSequencesMutex);
+        auto& channelValues = _valueChangeSequences[channel];
+        for(auto& name : names)
+        {
+            channelValues[name] = sequence;
+        }
+        _channelChangeSequences[channel] = sequence;
+    }
+    _changeSequence = sequence;
+}
+
+void Peer::markChannelChanged(int32_t channel, bool description)
+{
+    uint64_t sequence = ++_changeSequenceCounter;
+    {
+        std::lock_guard<std::mutex> changeSequencesGuard(_changeSequencesMutex);
+        _channelChangeSequences[channel] = sequence;
+    }
+    if(description)
+    {
+        _descriptionChangeSequence = sequence;
+        _lastDescriptionChangeSequence = sequence;
+    }
+    _changeSequence = sequence;
+}
+// }}}
+
 void Peer::setID(uint64_t id)
 {
     if(_peerID == 0)
     {
         _peerID = id;
         if(serviceMessages) serviceMessages->setPeerId(id);
+        indexAssignments();
     }
     else _bl->out.printError("Cannot reset peer ID");
 }
@@ -437,6 +553,7 @@ void Peer::setName(int32_t channel, std::string value)
 
     std::lock_guard<std::mutex> namesGuard(_namesMutex);
     _names[channel] = value;
+    markChannelChanged(channel, true);
 
     std::ostringstream names;
     for(auto namePair : _names)
@@ -496,7 +613,13 @@ bool Peer::setRoom(int32_t channel, uint64_t roomId)
     }
 
     std::lock_guard<std::mutex> roomGuard(_roomMutex);
-    _rooms[channel] = roomId;
+    uint64_t& room = _rooms[channel];
+    if(room != roomId)
+    {
+        raiseAssignmentRemoved(AssignmentType::room, room, channel, "");
+        raiseAssignmentAdded(AssignmentType::room, roomId, channel, "");
+    }
+    room = roomId;
 
     std::ostringstream rooms;
     for(auto roomPair : _rooms)
@@ -580,7 +703,7 @@ bool Peer::addCategory(int32_t channel, uint64_t categoryId)
     }
 
     std::lock_guard<std::mutex> categoriesGuard(_categoriesMutex);
-    _categories[channel].emplace(categoryId);
+    if(_categories[channel].emplace(categoryId).second) raiseAssignmentAdded(AssignmentType::category, categoryId, channel, "");
 
     std::ostringstream categories;
     for(auto categoryPair : _categories)
@@ -606,7 +729,7 @@ bool Peer::removeCategory(int32_t channel, uint64_t categoryId)
     auto channelIterator = _categories.find(channel);
     if(channelIterator == _categories.end()) return false;
 
-    channelIterator->second.erase(categoryId);
+    if(channelIterator->second.erase(categoryId) > 0) raiseAssignmentRemoved(AssignmentType::category, categoryId, channel, "");
     if(channelIterator->second.empty()) _categories.erase(channel);
 
     std::ostringstream categories;
@@ -854,6 +977,7 @@ void Peer::deleteFromDatabase()
     try
     {
         deleting = true;
+        raiseAssignmentsReset(std::vector<Assignment>(), true);
         std::string dataId = "";
         _bl->db->deleteMetadata(_peerID, _serialNumber, dataId);
         _bl->db->deletePeer(_peerID);
@@ -885,6 +1009,8 @@ void Peer::initializeCentralConfig()
                 initializeValueSet(i->first, (*j)->variables);
             }
         }
+        indexAssignments();
+        indexParameters();
     }
     catch(const std::exception& ex)
     {
@@ -893,6 +1019,78 @@ void Peer::initializeCentralConfig()
     _bl->db->releaseSavepointAsynchronous(savepointName);
 }
 
+namespace
+{
+    template<typename IndexEntry>
+    void buildParameterIndex(const std::shared_ptr<HomegearDevice>& rpcDevice, std::unordered_map<uint32_t, std::unordered_map<std::string, RpcConfigurationParameter>>& parameters, std::unordered_map<uint32_t, std::vector<IndexEntry>>& index)
+    {
+        index.clear();
+        for(auto& channel : parameters)
+        {
+            std::vector<IndexEntry>& channelIndex = index[channel.first];
+            for(auto& parameter : channel.second)
+            {
+                int32_t nameIndex = rpcDevice->getParameterIndex(parameter.first);
+                if(nameIndex < 0) continue;
+                if((size_t)nameIndex >= channelIndex.size()) channelIndex.resize(nameIndex + 1);
+                channelIndex[nameIndex].parameter = &parameter.second;
+                channelIndex[nameIndex].token = parameter.second.getIndexToken();
+            }
+        }
+    }
+
+    template<typename IndexEntry>
+    RpcConfigurationParameter* findParameter(std::unordered_map<uint32_t, std::unordered_map<std::string, RpcConfigurationParameter>>& parameters, std::unordered_map<uint32_t, std::vector<IndexEntry>>& index, uint32_t channel, const PParameter& parameter)
+    {
+        if(!parameter) return nullptr;
+        if(parameter->nameIndex >= 0)
+        {
+            auto channelIterator = index.find(channel);
+            if(channelIterator != index.end() && (size_t)parameter->nameIndex < channelIterator->second.size())
+            {
+                //An expired token means the entry was erased from the map, the pointer must not be used then.
+                const IndexEntry& indexEntry = channelIterator->second[parameter->nameIndex];
+                RpcConfigurationParameter* entry = indexEntry.token.expired() ? nullptr : indexEntry.parameter;
+                //Parameters of alternative functions share the entry, so compare the ID when the pointer differs.
+                if(entry && entry->rpcParameter && (entry->rpcParameter == parameter || entry->rpcParameter->id == parameter->id)) return entry;
+            }
+        }
+
+        auto channelIterator = parameters.find(channel);
+        if(channelIterator == parameters.end()) return nullptr;
+        auto parameterIterator = channelIterator->second.find(parameter->id);
+        if(parameterIterator == channelIterator->second.end()) return nullptr;
+        return &parameterIterator->second;
+    }
+}
+
+void Peer::indexParameters()
+{
+    try
+    {
+        _valuesCentralIndex.clear();
+        _configCentralIndex.clear();
+        if(!_rpcDevice) return;
+        _rpcDevice->indexParameters();
+        buildParameterIndex(_rpcDevice, valuesCentral, _valuesCentralIndex);
+        buildParameterIndex(_rpcDevice, configCentral, _configCentralIndex);
+    }
+    catch(const std::exception& ex)
+    {
+        _bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+}
+
+RpcConfigurationParameter* Peer::getValueParameter(uint32_t channel, const PParameter& parameter)
+{
+    return findParameter(valuesCentral, _valuesCentralIndex, channel, parameter);
+}
+
+RpcConfigurationParameter* Peer::getConfigParameter(uint32_t channel, const PParameter& parameter)
+{
+    return findParameter(configCentral, _configCentralIndex, channel, parameter);
+}
+
 void Peer::initializeMasterSet(int32_t channel, PConfigParameters masterSet)
 {
     try
@@ -1189,6 +1387,7 @@ void Peer::loadVariables(ICentral* central, std::shared_ptr<Database::DataTable>
                 }
             }
         }
+        indexAssignments();
         return;
     }
     catch(const std::exception& ex)
@@ -1580,7 +1779,9 @@ void Peer::loadConfig()
 
         Rpc::RpcDecoder rpcDecoder(_bl, false, false);
         Database::DataRow data;
-        std::shared_ptr<Database::DataTable> rows = _bl->db->getPeerParameters(_peerID);
+        std::shared_ptr<Database::DataTable> rows;
+        rows.swap(_preloadedConfig);
+        if(!rows) rows = _bl->db->getPeerParameters(_peerID);
         std::shared_ptr<ParameterInfo> parameterGroupSelector;
         std::vector<std::shared_ptr<ParameterInfo>> parameters;
         parameters.reserve(rows->size());
@@ -1594,9 +1795,7 @@ void Peer::loadConfig()
                 uint32_t index = row->second.at(3)->intValue;
                 ConfigDataBlock& config = binaryConfig[index];
                 config.databaseId = databaseId;
-                std::vector<uint8_t> configData;
-                configData.insert(configData.begin(), row->second.at(7)->binaryValue->begin(), row->second.at(7)->binaryValue->end());
-                config.setBinaryData(configData);
+                if(row->second.at(7)->binaryValue) config.setBinaryData(std::vector<uint8_t>(row->second.at(7)->binaryValue->begin(), row->second.at(7)->binaryValue->end()));
             }
             else
             {
@@ -1617,9 +1816,7 @@ void Peer::loadConfig()
                 }
 
                 parameterInfo->parameter.databaseId = databaseId;
-                std::vector<uint8_t> parameterData;
-                parameterData.insert(parameterData.begin(), row->second.at(7)->binaryValue->begin(), row->second.at(7)->binaryValue->end());
-                parameterInfo->parameter.setBinaryData(parameterData);
+                if(row->second.at(7)->binaryValue) parameterInfo->parameter.setBinaryData(std::vector<uint8_t>(row->second.at(7)->binaryValue->begin(), row->second.at(7)->binaryValue->end()));
                 if(!_rpcDevice)
                 {
                     _bl->out.printCritical("Critical: No xml-rpc device found for peer " + std::to_string(_peerID) + ".");
@@ -1629,28 +1826,42 @@ void Peer::loadConfig()
                 { // Rooms / categories / roles
                     parameterInfo->parameter.setRoom((uint64_t)row->second.at(8)->intValue);
 
-                    std::vector<std::string> categoryStrings = HelperFunctions::splitAll(row->second.at(9)->textValue, ',');
-                    for(auto categoryString : categoryStrings)
+                    //Parsed in place, as this runs for every parameter of every peer on startup.
+                    const std::string& categories = row->second.at(9)->textValue;
+                    const char* position = categories.c_str();
+                    while(*position)
                     {
-                        if(categoryString.empty()) continue;
-                        uint64_t category = (uint64_t)Math::getNumber64(categoryString);
+                        char* end = nullptr;
+                        uint64_t category = std::strtoull(position, &end, 10);
                         if(category != 0) parameterInfo->parameter.addCategory(category);
+                        position = std::strchr(end, ',');
+                        if(!position) break;
+                        position++;
                     }
 
-                    std::vector<std::string> roleStrings = HelperFunctions::splitAll(row->second.at(10)->textValue, ',');
-                    for(auto roleString : roleStrings)
+                    //Format: "roleId-direction-invert,roleId-direction-invert,..."
+                    const std::string& roles = row->second.at(10)->textValue;
+                    position = roles.c_str();
+                    while(*position)
                     {
-                        if(roleString.empty()) continue;
-                        auto parts = HelperFunctions::splitAll(roleString, '-');
-                        uint64_t roleId = Math::getUnsignedNumber64(parts.at(0));
-                        RoleDirection direction = parts.size() > 1 ? (RoleDirection)Math::getNumber(parts.at(1)) : RoleDirection::both;
-                        bool invert = parts.size() > 2 ? (bool)Math::getNumber(parts.at(2)) : false;
+                        char* end = nullptr;
+                        uint64_t roleId = std::strtoull(position, &end, 10);
+                        RoleDirection direction = RoleDirection::both;
+                        bool invert = false;
+                        if(*end == '-')
+                        {
+                            direction = (RoleDirection)std::strtol(end + 1, &end, 10);
+                            if(*end == '-') invert = (bool)std::strtol(end + 1, &end, 10);
+                        }
                         if(roleId != 0) parameterInfo->parameter.addRole(roleId, direction, invert);
+                        position = std::strchr(end, ',');
+                        if(!position) break;
+                        position++;
                     }
                 }
 
                 parameterInfo->specialType = row->second.at(11)->intValue;
-                if(row->second.at(12)->binaryValue->empty()) parameterInfo->metadata = std::make_shared<Variable>();
+                if(!row->second.at(12)->binaryValue || row->second.at(12)->binaryValue->empty()) parameterInfo->metadata = std::make_shared<Variable>();
                 else parameterInfo->metadata = rpcDecoder.decodeResponse(*row->second.at(12)->binaryValue);
 
                 Functions::iterator functionIterator = _rpcDevice->functions.find(parameterInfo->channel);
@@ -1824,6 +2035,10 @@ void Peer::loadConfig()
                 }
             }
         }
+
+        indexAssignments();
+        //Entries might have been removed above, which invalidates the parameter index.
+        if(!_valuesCentralIndex.empty() || !_configCentralIndex.empty()) indexParameters();
     }
     catch(const std::exception& ex)
     {
@@ -1860,7 +2075,13 @@ bool Peer::setVariableRoom(int32_t channel, std::string& variableName, uint64_t
         if(channelIterator == valuesCentral.end()) return false;
         auto variableIterator = channelIterator->second.find(variableName);
         if(variableIterator == channelIterator->second.end() || !variableIterator->second.rpcParameter || variableIterator->second.databaseId == 0) return false;
+        uint64_t oldRoomId = variableIterator->second.getRoom();
         variableIterator->second.setRoom(roomId);
+        if(oldRoomId != roomId)
+        {
+            raiseAssignmentRemoved(AssignmentType::room, oldRoomId, channel, variableName);
+            raiseAssignmentAdded(AssignmentType::room, roomId, channel, variableName);
+        }
 
         Database::DataRow data;
         data.push_back(std::make_shared<Database::DataColumn>(roomId));
@@ -1888,6 +2109,7 @@ void Peer::removeRoomFromVariables(uint64_t roomId)
                 if(variableIterator.second.getRoom() == roomId)
                 {
                     variableIterator.second.setRoom(0);
+                    raiseAssignmentRemoved(AssignmentType::room, roomId, channelIterator.first, variableIterator.first);
 
                     Database::DataRow data;
                     data.push_back(std::make_shared<Database::DataColumn>(roomId));
@@ -1930,6 +2152,7 @@ bool Peer::addCategoryToVariable(int32_t channel, std::string& variableName, uin
         auto variableIterator = channelIterator->second.find(variableName);
         if(variableIterator == channelIterator->second.end() || !variableIterator->second.rpcParameter || variableIterator->second.databaseId == 0) return false;
 
+        if(!variableIterator->second.hasCategory(categoryId)) raiseAssignmentAdded(AssignmentType::category, categoryId, channel, variableName);
         variableIterator->second.addCategory(categoryId);
 
         Database::DataRow data;
@@ -1955,6 +2178,7 @@ bool Peer::removeCategoryFromVariable(int32_t channel, std::string& variableName
         auto variableIterator = channelIterator->second.find(variableName);
         if(variableIterator == channelIterator->second.end() || !variableIterator->second.rpcParameter || variableIterator->second.databaseId == 0) return false;
 
+        if(variableIterator->second.hasCategory(categoryId)) raiseAssignmentRemoved(AssignmentType::category, categoryId, channel, variableName);
         variableIterator->second.removeCategory(categoryId);
 
         Database::DataRow data;
@@ -1980,6 +2204,7 @@ void Peer::removeCategoryFromVariables(uint64_t categoryId)
             for(auto& variableIterator : channelIterator.second)
             {
                 if(!variableIterator.second.rpcParameter || variableIterator.second.databaseId == 0) continue;
+                if(variableIterator.second.hasCategory(categoryId)) raiseAssignmentRemoved(AssignmentType::category, categoryId, channelIterator.first, variableIterator.first);
                 variableIterator.second.removeCategory(categoryId);
 
                 Database::DataRow data;
@@ -2000,9 +2225,9 @@ std::set<uint64_t> Peer::getVariableCategories(int32_t channel, std::string& var
     try
     {
         auto channelIterator = valuesCentral.find(channel);
-        if(channelIterator == valuesCentral.end()) std::set<uint64_t>();
+        if(channelIterator == valuesCentral.end()) return std::set<uint64_t>();
         auto variableIterator = channelIterator->second.find(variableName);
-        if(variableIterator == channelIterator->second.end() || !variableIterator->second.rpcParameter || variableIterator->second.databaseId == 0) std::set<uint64_t>();
+        if(variableIterator == channelIterator->second.end() || !variableIterator->second.rpcParameter || variableIterator->second.databaseId == 0) return std::set<uint64_t>();
 
         return variableIterator->second.getCategories();
     }
@@ -2060,6 +2285,7 @@ bool Peer::addRoleToVariable(int32_t channel, std::string& variableName, uint64_
         if(variableIterator->second.hasRole(roleId)) return false;
 
         variableIterator->second.addRole(roleId, direction, invert);
+        raiseAssignmentAdded(AssignmentType::role, roleId, channel, variableName);
 
         {
             Database::DataRow data;
@@ -2142,6 +2368,7 @@ bool Peer::removeRoleFromVariable(int32_t channel, std::string& variableName, ui
             }
         //}}}
 
+        if(variableIterator->second.hasRole(roleId)) raiseAssignmentRemoved(AssignmentType::role, roleId, channel, variableName);
         variableIterator->second.removeRole(roleId);
 
         Database::DataRow data;
@@ -2167,6 +2394,7 @@ void Peer::removeRoleFromVariables(uint64_t roleId)
             for(auto& variableIterator : channelIterator.second)
             {
                 if(!variableIterator.second.rpcParameter || variableIterator.second.databaseId == 0) continue;
+                if(variableIterator.second.hasRole(roleId)) raiseAssignmentRemoved(AssignmentType::role, roleId, channelIterator.first, variableIterator.first);
                 variableIterator.second.removeRole(roleId);
 
                 Database::DataRow data;
@@ -2187,9 +2415,9 @@ std::unordered_map<uint64_t, Role> Peer::getVariableRoles(int32_t channel, std::
     try
     {
         auto channelIterator = valuesCentral.find(channel);
-        if(channelIterator == valuesCentral.end()) std::set<uint64_t>();
+        if(channelIterator == valuesCentral.end()) return std::unordered_map<uint64_t, Role>();
         auto variableIterator = channelIterator->second.find(variableName);
-        if(variableIterator == channelIterator->second.end() || !variableIterator->second.rpcParameter || variableIterator->second.databaseId == 0) std::set<uint64_t>();
+        if(variableIterator == channelIterator->second.end() || !variableIterator->second.rpcParameter || variableIterator->second.databaseId == 0) return std::unordered_map<uint64_t, Role>();
 
         return variableIterator->second.getRoles();
     }
@@ -2236,6 +2464,68 @@ bool Peer::variableHasRoles(int32_t channel, const std::string& variableName)
     return false;
 }
 
+std::vector<Peer::Assignment> Peer::getAssignments()
+{
+    std::vector<Assignment> assignments;
+    try
+    {
+        {
+            std::lock_guard<std::mutex> roomGuard(_roomMutex);
+            for(auto& roomIterator : _rooms)
+            {
+                if(roomIterator.second != 0) assignments.emplace_back(AssignmentType::room, roomIterator.second, roomIterator.first, "");
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> categoriesGuard(_categoriesMutex);
+            for(auto& categoryIterator : _categories)
+            {
+                for(auto category : categoryIterator.second)
+                {
+                    assignments.emplace_back(AssignmentType::category, category, categoryIterator.first, "");
+                }
+            }
+        }
+
+        for(auto& channelIterator : valuesCentral)
+        {
+            for(auto& variableIterator : channelIterator.second)
+            {
+                uint64_t roomId = variableIterator.second.getRoom();
+                if(roomId != 0) assignments.emplace_back(AssignmentType::room, roomId, channelIterator.first, variableIterator.first);
+                for(auto category : variableIterator.second.getCategories())
+                {
+                    assignments.emplace_back(AssignmentType::category, category, channelIterator.first, variableIterator.first);
+                }
+                for(auto& role : variableIterator.second.getRoles())
+                {
+                    assignments.emplace_back(AssignmentType::role, role.first, channelIterator.first, variableIterator.first);
+                }
+            }
+        }
+    }
+    catch(const std::exception& ex)
+    {
+        _bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return assignments;
+}
+
+void Peer::indexAssignments()
+{
+    try
+    {
+        if(_peerID == 0 || !_eventHandler) return;
+        if(usesAssignmentIndex()) raiseAssignmentsReset(getAssignments(), true);
+        else raiseAssignmentsReset(std::vector<Assignment>(), false);
+    }
+    catch(const std::exception& ex)
+    {
+        _bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+}
+
 //RPC methods
 PVariable Peer::getAllConfig(PRpcClientInfo clientInfo)
 {
@@ -2282,12 +2572,11 @@ PVariable Peer::getAllConfig(PRpcClientInfo clientInfo)
                 if(parameter.specialType == 0)
                 {
                     //Parameter also needs to be in ParamsetDescription, this is not necessarily the case (e. g. for switchable parameter sets)
-                    auto parameter2 = parameterGroup->getParameter(parameter.rpcParameter->id);
-                    if(!parameter2) continue;
+                    if(!parameter.rpcParameter->hasParent(parameterGroup) && !parameterGroup->getParameter(parameter.rpcParameter->id)) continue;
                 }
                 if(!parameter.rpcParameter->visible && !parameter.rpcParameter->service && !parameter.rpcParameter->internal  && !parameter.rpcParameter->transform)
                 {
-                    _bl->out.printDebug("Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag.");
+                    _bl->out.printDebugLazy([&]() { return "Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag."; });
                     continue;
                 }
 #ifdef CCU2
@@ -2414,6 +2703,11 @@ PVariable Peer::getAllConfig(PRpcClientInfo clientInfo)
 }
 
 PVariable Peer::getAllValues(PRpcClientInfo clientInfo, bool returnWriteOnly, bool checkAcls)
+{
+    return getAllValuesSince(clientInfo, returnWriteOnly, 0, checkAcls);
+}
+
+PVariable Peer::getAllValuesSince(PRpcClientInfo clientInfo, bool returnWriteOnly, uint64_t since, bool checkAcls)
 {
     try
     {
@@ -2443,6 +2737,8 @@ PVariable Peer::getAllValues(PRpcClientInfo clientInfo, bool returnWriteOnly, bo
             }
             values->structValue->insert(StructElement("CATEGORIES", categories));
         }
+        //Everything of a peer created after "since" counts as changed
+        bool filterChanges = since > 0 && _creationChangeSequence <= since;
         PVariable channels(new Variable(VariableType::tArray));
         for(auto i = _rpcDevice->functions.begin(); i != _rpcDevice->functions.end(); ++i)
         {
@@ -2452,6 +2748,7 @@ PVariable Peer::getAllValues(PRpcClientInfo clientInfo, bool returnWriteOnly, bo
                 std::vector<uint8_t> parameterData = configCentral[0][i->second->countFromVariable].getBinaryData();
                 if(!parameterData.empty() && i->first >= i->second->channel + parameterData.at(parameterData.size() - 1)) continue;
             }
+            if(filterChanges && getChannelChangeSequence(i->first) <= since) continue;
             PVariable channel(new Variable(VariableType::tStruct));
             channel->structValue->insert(StructElement("INDEX", std::make_shared<Variable>(i->first)));
             channel->structValue->insert(StructElement("NAME", std::make_shared<Variable>(getName(i->first))));
@@ -2482,6 +2779,7 @@ PVariable Peer::getAllValues(PRpcClientInfo clientInfo, bool returnWriteOnly, bo
 
             for(auto& parameterIterator : valuesIterator->second)
             {
+                if(filterChanges && getValueChangeSequence(i->first, parameterIterator.first) <= since) continue;
                 RpcConfigurationParameter& parameter = parameterIterator.second;
                 if(checkAcls && !clientInfo->acls->checkVariableReadAccess(central->getPeer(_peerID), i->first, parameter.rpcParameter->id)) continue;
 
@@ -2489,12 +2787,11 @@ PVariable Peer::getAllValues(PRpcClientInfo clientInfo, bool returnWriteOnly, bo
                 if(parameter.specialType == 0)
                 {
                     //Parameter also needs to be in ParamsetDescription, this is not necessarily the case (e. g. for switchable parameter sets)
-                    auto parameter2 = parameterGroup->getParameter(parameter.rpcParameter->id);
-                    if(!parameter2) continue;
+                    if(!parameter.rpcParameter->hasParent(parameterGroup) && !parameterGroup->getParameter(parameter.rpcParameter->id)) continue;
                 }
                 if(!parameter.rpcParameter->visible && !parameter.rpcParameter->service && !parameter.rpcParameter->internal  && !parameter.rpcParameter->transform)
                 {
-                    _bl->out.printDebug("Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag.");
+                    _bl->out.printDebugLazy([&]() { return "Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag."; });
                     continue;
                 }
                 if(!parameter.rpcParameter->readable && !parameter.rpcParameter->transmitted && !returnWriteOnly) continue;
@@ -3061,7 +3358,7 @@ PVariable Peer::getLink(PRpcClientInfo clientInfo, int32_t channel, int32_t flag
                 else if(!(*i)->serialNumber.empty()) remotePeer = central->getPeer((*i)->serialNumber);
                 if(!remotePeer)
                 {
-                    _bl->out.printDebug("Debug: Can't return link description for peer with id " + std::to_string((*i)->id) + ". The peer is not paired to Homegear.");
+                    _bl->out.printDebugLazy([&]() { return "Debug: Can't return link description for peer with id " + std::to_string((*i)->id) + ". The peer is not paired to Homegear."; });
                     continue;
                 }
                 uint64_t peerID = remotePeer->getID();
@@ -3461,12 +3758,11 @@ PVariable Peer::getParamset(PRpcClientInfo clientInfo, int32_t channel, Paramete
                 if(parameter.specialType == 0)
                 {
                     //Parameter also needs to be in ParamsetDescription, this is not necessarily the case (e. g. for switchable parameter sets)
-                    auto parameter2 = parameterGroup->getParameter(parameter.rpcParameter->id);
-                    if(!parameter2) continue;
+                    if(!parameter.rpcParameter->hasParent(parameterGroup) && !parameterGroup->getParameter(parameter.rpcParameter->id)) continue;
                 }
                 if(!parameter.rpcParameter->visible && !parameter.rpcParameter->service && !parameter.rpcParameter->internal && !parameter.rpcParameter->transform)
                 {
-                    _bl->out.printDebug("Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag.");
+                    _bl->out.printDebugLazy([&]() { return "Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag."; });
                     continue;
                 }
                 if(clientInfo->clientType == RpcClientType::ccu2 && !parameter.rpcParameter->ccu2Visible) continue;
@@ -3494,12 +3790,11 @@ PVariable Peer::getParamset(PRpcClientInfo clientInfo, int32_t channel, Paramete
                 if(parameter.specialType == 0)
                 {
                     //Parameter also needs to be in ParamsetDescription, this is not necessarily the case (e. g. for switchable parameter sets)
-                    auto parameter2 = parameterGroup->getParameter(parameter.rpcParameter->id);
-                    if(!parameter2) continue;
+                    if(!parameter.rpcParameter->hasParent(parameterGroup) && !parameterGroup->getParameter(parameter.rpcParameter->id)) continue;
                 }
                 if(!parameter.rpcParameter->visible && !parameter.rpcParameter->service && !parameter.rpcParameter->internal && !parameter.rpcParameter->transform)
                 {
-                    _bl->out.printDebug("Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag.");
+                    _bl->out.printDebugLazy([&]() { return "Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag."; });
                     continue;
                 }
                 if(clientInfo->clientType == RpcClientType::ccu2 && !parameter.rpcParameter->ccu2Visible) continue;
@@ -3535,12 +3830,11 @@ PVariable Peer::getParamset(PRpcClientInfo clientInfo, int32_t channel, Paramete
                 if(parameter.specialType == 0)
                 {
                     //Parameter also needs to be in ParamsetDescription, this is not necessarily the case (e. g. for switchable parameter sets)
-                    auto parameter2 = parameterGroup->getParameter(parameter.rpcParameter->id);
-                    if(!parameter2) continue;
+                    if(!parameter.rpcParameter->hasParent(parameterGroup) && !parameterGroup->getParameter(parameter.rpcParameter->id)) continue;
                 }
                 if(!parameter.rpcParameter->visible && !parameter.rpcParameter->service && !parameter.rpcParameter->internal && !parameter.rpcParameter->transform)
                 {
-                    _bl->out.printDebug("Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag.");
+                    _bl->out.printDebugLazy([&]() { return "Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag."; });
                     continue;
                 }
                 if(clientInfo->clientType == RpcClientType::ccu2 && !parameter.rpcParameter->ccu2Visible) continue;
@@ -3588,15 +3882,16 @@ PVariable Peer::getParamsetDescription(PRpcClientInfo clientInfo, int32_t channe
                 RpcConfigurationParameter& parameter = parameterIterator.second;
                 if(parameter.rpcParameter->id.empty() || !parameter.rpcParameter->visible) continue;
                 if(checkAcls && !clientInfo->acls->checkVariableReadAccess(central->getPeer(_peerID), channel, parameter.rpcParameter->id)) continue;
+                bool cacheable = false;
                 if(parameter.specialType == 0)
                 {
                     //Parameter also needs to be in ParamsetDescription, this is not necessarily the case (e. g. for switchable parameter sets)
-                    auto parameter2 = parameterGroup->getParameter(parameter.rpcParameter->id);
-                    if(!parameter2) continue;
+                    cacheable = parameter.rpcParameter->hasParent(parameterGroup);
+                    if(!cacheable && !parameterGroup->getParameter(parameter.rpcParameter->id)) continue;
                 }
                 if(!parameter.rpcParameter->visible && !parameter.rpcParameter->service && !parameter.rpcParameter->internal && !parameter.rpcParameter->transform)
                 {
-                    _bl->out.printDebug("Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag.");
+                    _bl->out.printDebugLazy([&]() { return "Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag."; });
                     continue;
                 }
                 if(clientInfo->clientType == RpcClientType::ccu2 && !parameter.rpcParameter->ccu2Visible) continue;
@@ -3604,7 +3899,7 @@ PVariable Peer::getParamsetDescription(PRpcClientInfo clientInfo, int32_t channe
                 if(parameter.rpcParameter && parameter.rpcParameter->logical->type == ILogical::Type::tInteger64) continue;
 #endif
 
-                PVariable description = getVariableDescription(clientInfo, parameter.rpcParameter, channel, parameterGroup->type(), index, std::unordered_set<std::string>());
+                PVariable description = getParamsetDescriptionEntry(clientInfo, parameter.rpcParameter, channel, parameterGroup->type(), index, &parameter, cacheable);
                 if(!description || description->errorStruct) continue;
 
                 index++;
@@ -3619,15 +3914,16 @@ PVariable Peer::getParamsetDescription(PRpcClientInfo clientInfo, int32_t channe
             {
                 RpcConfigurationParameter& parameter = parameterIterator.second;
                 if(parameter.rpcParameter->id.empty()) continue;
+                bool cacheable = false;
                 if(parameter.specialType == 0)
                 {
                     //Parameter also needs to be in ParamsetDescription, this is not necessarily the case (e. g. for switchable parameter sets)
-                    auto parameter2 = parameterGroup->getParameter(parameter.rpcParameter->id);
-                    if(!parameter2) continue;
+                    cacheable = parameter.rpcParameter->hasParent(parameterGroup);
+                    if(!cacheable && !parameterGroup->getParameter(parameter.rpcParameter->id)) continue;
                 }
                 if(!parameter.rpcParameter->visible && !parameter.rpcParameter->service && !parameter.rpcParameter->internal && !parameter.rpcParameter->transform)
                 {
-                    _bl->out.printDebug("Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag.");
+                    _bl->out.printDebugLazy([&]() { return "Debug: Omitting parameter " + parameter.rpcParameter->id + " because of it's ui flag."; });
                     continue;
                 }
                 if(clientInfo->clientType == RpcClientType::ccu2 && !parameter.rpcParameter->ccu2Visible) continue;
@@ -3635,7 +3931,7 @@ PVariable Peer::getParamsetDescription(PRpcClientInfo clientInfo, int32_t channe
                 if(parameter.rpcParameter && parameter.rpcParameter->logical->type == ILogical::Type::tInteger64) continue;
 #endif
 
-                PVariable description = getVariableDescription(clientInfo, parameter.rpcParameter, channel, parameterGroup->type(), index, std::unordered_set<std::string>());
+                PVariable description = getParamsetDescriptionEntry(clientInfo, parameter.rpcParameter, channel, parameterGroup->type(), index, nullptr, cacheable);
                 if(!description || description->errorStruct) continue;
 
                 index++;
@@ -3649,11 +3945,11 @@ PVariable Peer::getParamsetDescription(PRpcClientInfo clientInfo, int32_t channe
                 if(!parameter.second || parameter.second->id.empty() || !parameter.second->visible) continue;
                 if(!parameter.second->visible && !parameter.second->service && !parameter.second->internal  && !parameter.second->transform)
                 {
-                    _bl->out.printDebug("Debug: Omitting parameter " + parameter.second->id + " because of it's ui flag.");
+                    _bl->out.printDebugLazy([&]() { return "Debug: Omitting parameter " + parameter.second->id + " because of it's ui flag."; });
                     continue;
                 }
 
-                PVariable description = getVariableDescription(clientInfo, parameter.second, channel, parameterGroup->type(), index, std::unordered_set<std::string>());
+                PVariable description = getParamsetDescriptionEntry(clientInfo, parameter.second, channel, parameterGroup->type(), index, nullptr, true);
                 if(!description || description->errorStruct) continue;
 
                 index++;
@@ -3775,7 +4071,7 @@ PVariable Peer::getVariableDescription(PRpcClientInfo clientInfo, const PParamet
         if(!parameter || parameter->id.empty() || !parameter->visible) return Variable::createError(-5, "Unknown parameter.");
         if(!parameter->visible && !parameter->service && !parameter->internal  && !parameter->transform)
         {
-            _bl->out.printDebug("Debug: Omitting parameter " + parameter->id + " because of it's ui flag.");
+            _bl->out.printDebugLazy([&]() { return "Debug: Omitting parameter " + parameter->id + " because of it's ui flag."; });
             return Variable::createError(-5, "Unknown parameter (1).");
         }
 #ifdef CCU2
@@ -3973,66 +4269,111 @@ PVariable Peer::getVariableDescription(PRpcClientInfo clientInfo, const PParamet
 
         if(type == ParameterGroup::Type::Enum::variables)
         {
-            auto valuesCentralIterator = valuesCentral.find(channel);
-            if(valuesCentralIterator == valuesCentral.end()) return Variable::createError(-5, "Unknown parameter (2).");
-            auto valueParameterIterator = valuesCentralIterator->second.find(parameter->id);
-            if(valueParameterIterator == valuesCentralIterator->second.end()) return Variable::createError(-5, "Unknown parameter (3).");
+            RpcConfigurationParameter* valueParameter = getValueParameter(channel, parameter);
+            if(!valueParameter) return Variable::createError(-5, "Unknown parameter (3).");
 
-            if(fields.empty() || fields.find("ROOM") != fields.end())
+            addValueParameterDescription(valueParameter, description, fields);
+        }
+
+        if(fields.empty() || fields.find("LABEL") != fields.end() || fields.find("DESCRIPTION") != fields.end())
+        {
+            std::shared_ptr<ICentral> central = getCentral();
+            if(!central) return description;
+            std::string language = clientInfo ? clientInfo->language : "en-US";
+            std::string filename = _rpcDevice->getFilename();
+            if(parameter->parent())
             {
-                auto room = valueParameterIterator->second.getRoom();
-                if(room != 0) description->structValue->emplace("ROOM", std::make_shared<Variable>(room));
+                auto parameterTranslations = central->getTranslations()->getParameterTranslations(filename, language, parameter->parent()->type(), parameter->parent()->id, parameter->id);
+                if(!parameterTranslations.first.empty()) description->structValue->insert(StructElement("LABEL", std::shared_ptr<Variable>(new Variable(parameterTranslations.first))));
+                if(!parameterTranslations.second.empty()) description->structValue->insert(StructElement("DESCRIPTION", std::shared_ptr<Variable>(new Variable(parameterTranslations.second))));
             }
+        }
+
+        return description;
+    }
+    catch(const std::exception& ex)
+    {
+        _bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+    return Variable::createError(-32500, "Unknown application error.");
+}
 
-            if(fields.empty() || fields.find("CATEGORIES") != fields.end())
+void Peer::addValueParameterDescription(RpcConfigurationParameter* valueParameter, const PVariable& description, const std::unordered_set<std::string>& fields)
+{
+    try
+    {
+        if(fields.empty() || fields.find("ROOM") != fields.end())
+        {
+            auto room = valueParameter->getRoom();
+            if(room != 0) description->structValue->emplace("ROOM", std::make_shared<Variable>(room));
+        }
+
+        if(fields.empty() || fields.find("CATEGORIES") != fields.end())
+        {
+            auto categories = valueParameter->getCategories();
+            if(!categories.empty())
             {
-                auto categories = valueParameterIterator->second.getCategories();
-                if(!categories.empty())
+                PVariable categoriesResult = std::make_shared<Variable>(VariableType::tArray);
+                categoriesResult->arrayValue->reserve(categories.size());
+                for(auto category : categories)
                 {
-                    PVariable categoriesResult = std::make_shared<Variable>(VariableType::tArray);
-                    categoriesResult->arrayValue->reserve(categories.size());
-                    for(auto category : categories)
-                    {
-                        categoriesResult->arrayValue->push_back(std::make_shared<Variable>(category));
-                    }
-                    description->structValue->emplace("CATEGORIES", categoriesResult);
+                    categoriesResult->arrayValue->push_back(std::make_shared<Variable>(category));
                 }
+                description->structValue->emplace("CATEGORIES", categoriesResult);
             }
+        }
 
-            if(fields.empty() || fields.find("ROLES") != fields.end())
+        if(fields.empty() || fields.find("ROLES") != fields.end())
+        {
+            auto roles = valueParameter->getRoles();
+            if(!roles.empty())
             {
-                auto roles = valueParameterIterator->second.getRoles();
-                if(!roles.empty())
+                auto rolesArray = std::make_shared<Variable>(VariableType::tArray);
+                rolesArray->arrayValue->reserve(roles.size());
+                for(auto role : roles)
                 {
-                    auto rolesArray = std::make_shared<Variable>(VariableType::tArray);
-                    rolesArray->arrayValue->reserve(roles.size());
-                    for(auto role : roles)
-                    {
-                        auto roleStruct = std::make_shared<Variable>(VariableType::tStruct);
-                        roleStruct->structValue->emplace("id", std::make_shared<BaseLib::Variable>(role.second.id));
-                        roleStruct->structValue->emplace("direction", std::make_shared<BaseLib::Variable>((int32_t)role.second.direction));
-                        if(role.second.invert) roleStruct->structValue->emplace("invert", std::make_shared<BaseLib::Variable>(role.second.invert));
-                        rolesArray->arrayValue->emplace_back(std::move(roleStruct));
-                    }
-                    description->structValue->emplace("ROLES", rolesArray);
+                    auto roleStruct = std::make_shared<Variable>(VariableType::tStruct);
+                    roleStruct->structValue->emplace("id", std::make_shared<BaseLib::Variable>(role.second.id));
+                    roleStruct->structValue->emplace("direction", std::make_shared<BaseLib::Variable>((int32_t)role.second.direction));
+                    if(role.second.invert) roleStruct->structValue->emplace("invert", std::make_shared<BaseLib::Variable>(role.second.invert));
+                    rolesArray->arrayValue->emplace_back(std::move(roleStruct));
                 }
+                description->structValue->emplace("ROLES", rolesArray);
             }
         }
+    }
+    catch(const std::exception& ex)
+    {
+        _bl->out.printEx(__FILE__, __LINE__, __PRETTY_FUNCTION__, ex.what());
+    }
+}
 
-        if(fields.empty() || fields.find("LABEL") != fields.end() || fields.find("DESCRIPTION") != fields.end())
+PVariable Peer::getParamsetDescriptionEntry(PRpcClientInfo& clientInfo, const PParameter& parameter, int32_t channel, ParameterGroup::Type::Enum type, int32_t index, RpcConfigurationParameter* valueParameter, bool cacheable)
+{
+    try
+    {
+        if(!_rpcDevice || !cacheable) return getVariableDescription(clientInfo, parameter, channel, type, index, std::unordered_set<std::string>());
+        if(!parameter || !parameter->logical) return Variable::createError(-5, "Unknown parameter.");
+        if(clientInfo->clientType == RpcClientType::ccu2 && !parameter->ccu2Visible) return Variable::createError(-5, "Parameter is invisible on the CCU2.");
+        if(!clientInfo->initNewFormat && (parameter->logical->type == ILogical::Type::tArray || parameter->logical->type == ILogical::Type::tStruct)) return Variable::createError(-5, "Parameter is unsupported by this client.");
+
+        //Parameters are owned by _rpcDevice, so their address identifies them, even for alternative functions.
+        std::string cacheKey = "parameter." + std::to_string((uintptr_t)parameter.get()) + '.' + std::to_string((int32_t)type) + '.' + clientInfo->language;
+        PVariable cachedDescription = _rpcDevice->getCachedDescription(cacheKey);
+        if(!cachedDescription)
         {
-            std::shared_ptr<ICentral> central = getCentral();
-            if(!central) return description;
-            std::string language = clientInfo ? clientInfo->language : "en-US";
-            std::string filename = _rpcDevice->getFilename();
-            if(parameter->parent())
-            {
-                auto parameterTranslations = central->getTranslations()->getParameterTranslations(filename, language, parameter->parent()->type(), parameter->parent()->id, parameter->id);
-                if(!parameterTranslations.first.empty()) description->structValue->insert(StructElement("LABEL", std::shared_ptr<Variable>(new Variable(parameterTranslations.first))));
-                if(!parameterTranslations.second.empty()) description->structValue->insert(StructElement("DESCRIPTION", std::shared_ptr<Variable>(new Variable(parameterTranslations.second))));
-            }
+            cachedDescription = getVariableDescription(clientInfo, parameter, channel, type, -1, std::unordered_set<std::string>());
+            if(!cachedDescription || cachedDescription->errorStruct) return cachedDescription;
+            cachedDescription->structValue->erase("ROOM");
+            cachedDescription->structValue->erase("CATEGORIES");
+            cachedDescription->structValue->erase("ROLES");
+            _rpcDevice->setCachedDescription(cacheKey, clientInfo->language, cachedDescription);
         }
 
+        PVariable description = std::make_shared<Variable>(VariableType::tStruct);
+        *description->structValue = *cachedDescription->structValue;
+        description->structValue->emplace("TAB_ORDER", std::make_shared<Variable>(index));
+        if(type == ParameterGroup::Type::Enum::variables && valueParameter) addValueParameterDescription(valueParameter, description, std::unordered_set<std::string>());
         return description;
     }
     catch(const std::exception& ex)
@@ -4061,8 +4402,7 @@ PVariable Peer::getVariableDescription(PRpcClientInfo clientInfo, uint32_t chann
         if(parameterIterator->second.specialType == 0)
         {
             //Parameter also needs to be in ParamsetDescription, this is not necessarily the case (e. g. for switchable parameter sets)
-            auto parameterIterator2 = channelIterator->second.find(valueKey);
-            if(parameterIterator2 == channelIterator->second.end()) return Variable::createError(-5, "Unknown parameter.");
+            if(!parameterIterator->second.rpcParameter->hasParent(parameterGroup) && !parameterGroup->getParameter(valueKey)) return Variable::createError(-5, "Unknown parameter.");
         }
 
         return getVariableDescription(clientInfo, parameterIterator->second.rpcParameter, channel, ParameterGroup::Type::Enum::variables, -1, fields);
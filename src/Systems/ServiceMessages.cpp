@@ -128,7 +128,7 @@ void ServiceMessages::load()
 				int32_t channel = row->second.at(6)->intValue;
 				std::string id = row->second.at(7)->textValue;
 				std::shared_ptr<std::vector<char>> value = row->second.at(9)->binaryValue;
-				if(channel < 0 || id.empty() || value->empty()) continue;
+				if(channel < 0 || id.empty() || !value || value->empty()) continue;
                 ErrorInfo errorInfo;
                 errorInfo.value = (uint8_t)value->at(0);
                 errorInfo.timestamp = row->second.at(5)->intValue;
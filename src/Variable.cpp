@@ -43,28 +43,9 @@ Variable::Variable()
 	structValue = std::make_shared<Struct>();
 }
 
-Variable::Variable(Variable const& rhs)
+Variable::Variable(Variable const& rhs) : Variable()
 {
-	errorStruct = rhs.errorStruct;
-	type = rhs.type;
-	stringValue = rhs.stringValue;
-	integerValue = rhs.integerValue;
-	integerValue64 = rhs.integerValue64;
-	floatValue = rhs.floatValue;
-	booleanValue = rhs.booleanValue;
-	binaryValue = rhs.binaryValue;
-	for(Array::const_iterator i = rhs.arrayValue->begin(); i != rhs.arrayValue->end(); ++i)
-	{
-		PVariable lhs = std::make_shared<Variable>();
-		*lhs = *(*i);
-		arrayValue->push_back(lhs);
-	}
-	for(Struct::const_iterator i = rhs.structValue->begin(); i != rhs.structValue->end(); ++i)
-	{
-		PVariable lhs = std::make_shared<Variable>();
-		*lhs = *(i->second);
-		structValue->insert(std::pair<std::string, PVariable>(i->first, lhs));
-	}
+	copyFrom(rhs);
 }
 
 Variable::Variable(VariableType variableType) : Variable()
@@ -272,6 +253,12 @@ std::shared_ptr<Variable> Variable::createError(int32_t faultCode, std::string f
 Variable& Variable::operator=(const Variable& rhs)
 {
 	if(&rhs == this) return *this;
+	copyFrom(rhs);
+	return *this;
+}
+
+void Variable::copyFrom(const Variable& rhs)
+{
 	errorStruct = rhs.errorStruct;
 	type = rhs.type;
 	stringValue = rhs.stringValue;
@@ -292,7 +279,6 @@ Variable& Variable::operator=(const Variable& rhs)
 		*lhs = *(i->second);
 		structValue->insert(std::pair<std::string, PVariable>(i->first, lhs));
 	}
-	return *this;
 }
 
 bool Variable::operator==(const Variable& rhs)
@@ -80,6 +80,11 @@ class Variable
 private:
 	typedef void (Variable::*bool_type)() const;
 
+	/**
+	 * Copies all members of rhs. Nested arrays and structs are copied recursively.
+	 */
+	void copyFrom(const Variable& rhs);
+
 	void this_type_does_not_support_comparisons() const {}
 	std::string print(PVariable variable, std::string indent, bool ignoreIndentOnFirstLine, bool oneLine);
 	std::string printStruct(PStruct rpcStruct, std::string indent, bool ignoreIndentOnFirstLine, bool oneLine);
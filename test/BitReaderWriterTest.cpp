@@ -0,0 +1,109 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/Encoding/BitReaderWriter.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace
+{
+	uint64_t toInteger(const std::vector<uint8_t>& data)
+	{
+		uint64_t result = 0;
+		for(auto byte : data)
+		{
+			result = (result << 8) | byte;
+		}
+		return result;
+	}
+
+	void testGetPosition()
+	{
+		std::vector<uint8_t> data{ 0x28, 0x08 };
+		check(BaseLib::BitReaderWriter::getPosition64(data.data(), data.size(), 2, 3) == 5, "Reads the documented example.");
+		check(BaseLib::BitReaderWriter::getPosition64(data.data(), data.size(), 12, 8) == 0x80, "Missing bytes are read as 0.");
+		check(BaseLib::BitReaderWriter::getPosition64(data.data(), data.size(), 16, 8) == 0, "Reading after the end returns 0.");
+		check(BaseLib::BitReaderWriter::getPosition64(data.data(), data.size(), 0, 0) == 0, "Reading 0 bits returns 0.");
+
+		std::mt19937 random(42);
+		for(int32_t i = 0; i < 100000; i++)
+		{
+			std::vector<uint8_t> packet(random() % 20);
+			for(auto& byte : packet)
+			{
+				byte = (uint8_t)random();
+			}
+			uint32_t position = random() % 160;
+			uint32_t size = 1 + random() % 64;
+			uint64_t expected = toInteger(BaseLib::BitReaderWriter::getPosition(packet, position, size));
+			if(BaseLib::BitReaderWriter::getPosition64(packet.data(), packet.size(), position, size) != expected)
+			{
+				check(false, "getPosition64() returns the same as getPosition() (position " + std::to_string(position) + ", size " + std::to_string(size) + ", data size " + std::to_string(packet.size()) + ").");
+				break;
+			}
+			if(BaseLib::BitReaderWriter::getPosition16(packet, position, size) != (uint16_t)BaseLib::BitReaderWriter::getPosition64(packet.data(), packet.size(), position, size > 16 ? 16 : size))
+			{
+				check(false, "getPosition16() returns the same as getPosition64().");
+				break;
+			}
+		}
+	}
+
+	void testLayouts()
+	{
+		std::vector<uint8_t> packet{ 0x1A, 0x22, 0xF3, 0x04, 0x55, 0x80, 0x12, 0x34, 0x56, 0x78 };
+
+		static constexpr BaseLib::BitField layout[] = { {0, 8}, {8, 4}, {12, 12}, {40, 1}, {48, 32} };
+		uint64_t values[5];
+		BaseLib::BitReaderWriter::decode(packet.data(), packet.size(), layout, values);
+		check(values[0] == 0x1A && values[1] == 0x2 && values[2] == 0x2F3 && values[3] == 1 && values[4] == 0x12345678, "Compile time layouts are decoded.");
+
+		BaseLib::BitLayout runtimeLayout{ {0, 8}, {8, 4} };
+		check(runtimeLayout.addField(12, 12) == 2, "addField() returns the index of the field.");
+		runtimeLayout.addField(72, 16);
+		check(runtimeLayout.byteSize() == 11, "byteSize() covers all fields.");
+
+		std::vector<uint64_t> runtimeValues;
+		runtimeLayout.decode(packet, runtimeValues);
+		check(runtimeValues.size() == 4, "decode() resizes the value array.");
+		check(runtimeValues[0] == 0x1A && runtimeValues[1] == 0x2 && runtimeValues[2] == 0x2F3 && runtimeValues[3] == 0x7800, "Runtime layouts are decoded.");
+	}
+}
+
+int main()
+{
+	testGetPosition();
+	testLayouts();
+
+	return finishTests();
+}
@@ -0,0 +1,154 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+	class TestCentral : public BaseLib::Systems::ICentral
+	{
+	public:
+		explicit TestCentral(BaseLib::SharedObjects* bl) : ICentral(1, bl, nullptr) {}
+
+		using ICentral::loadPeersInParallel;
+	protected:
+		bool onPacketReceived(std::string& senderID, std::shared_ptr<BaseLib::Systems::Packet> packet) override { return false; }
+		void loadVariables() override {}
+		void saveVariables() override {}
+	};
+
+	struct LoadedPeer
+	{
+		uint32_t calls = 0;
+		std::shared_ptr<BaseLib::Database::DataTable> config;
+	};
+
+	BaseLib::Database::DataTable createPeerRows(uint64_t peerCount)
+	{
+		BaseLib::Database::DataTable peerRows;
+		for(uint64_t peerId = 1; peerId <= peerCount; peerId++)
+		{
+			peerRows[peerId].emplace(0, std::make_shared<BaseLib::Database::DataColumn>((int64_t)peerId));
+		}
+		//Rows without columns are skipped.
+		peerRows[peerCount + 1];
+		return peerRows;
+	}
+
+	void testLoadPeers(TestCentral& central, size_t threadCount)
+	{
+		const uint64_t peerCount = 50;
+		std::string description = " (" + std::to_string(threadCount) + " threads)";
+		auto peerRows = createPeerRows(peerCount);
+		std::unordered_map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> configs;
+		for(uint64_t peerId = 2; peerId <= peerCount; peerId += 2)
+		{
+			configs.emplace(peerId, std::make_shared<BaseLib::Database::DataTable>());
+		}
+		auto expectedConfigs = configs;
+
+		std::mutex loadedPeersMutex;
+		std::map<uint64_t, LoadedPeer> loadedPeers;
+		central.loadPeersInParallel(peerRows, configs, threadCount, [&](std::map<uint32_t, std::shared_ptr<BaseLib::Database::DataColumn>>& row, std::shared_ptr<BaseLib::Database::DataTable>& config)
+		{
+			std::lock_guard<std::mutex> loadedPeersGuard(loadedPeersMutex);
+			LoadedPeer& loadedPeer = loadedPeers[(uint64_t)row.at(0)->intValue];
+			loadedPeer.calls++;
+			loadedPeer.config = config;
+		});
+
+		check(loadedPeers.size() == peerCount, "Every peer with a row is loaded" + description + ".");
+		bool configsCorrect = true;
+		for(auto& loadedPeer : loadedPeers)
+		{
+			auto configIterator = expectedConfigs.find(loadedPeer.first);
+			if(loadedPeer.second.calls != 1) configsCorrect = false;
+			else if(configIterator == expectedConfigs.end()) configsCorrect = configsCorrect && !loadedPeer.second.config;
+			else configsCorrect = configsCorrect && loadedPeer.second.config == configIterator->second;
+		}
+		check(configsCorrect, "Every peer is loaded once with its config, peers without parameters get no config" + description + ".");
+		check(configs.empty(), "The configs are released" + description + ".");
+	}
+
+	void testExceptions(TestCentral& central, size_t threadCount)
+	{
+		const uint64_t peerCount = 50;
+		std::string description = " (" + std::to_string(threadCount) + " threads)";
+		auto peerRows = createPeerRows(peerCount);
+		std::unordered_map<uint64_t, std::shared_ptr<BaseLib::Database::DataTable>> configs;
+
+		std::atomic<uint32_t> calls{0};
+		std::string what;
+		try
+		{
+			central.loadPeersInParallel(peerRows, configs, threadCount, [&](std::map<uint32_t, std::shared_ptr<BaseLib::Database::DataColumn>>& row, std::shared_ptr<BaseLib::Database::DataTable>& config)
+			{
+				calls++;
+				uint64_t peerId = (uint64_t)row.at(0)->intValue;
+				if(peerId == 5) throw std::runtime_error("Peer 5 could not be loaded.");
+				if(peerId == 40) throw 40;
+			});
+		}
+		catch(const std::runtime_error& ex)
+		{
+			what = ex.what();
+		}
+		catch(...)
+		{
+			what = "Unknown exception";
+		}
+		check(calls == peerCount, "The remaining peers are loaded when loading a peer fails" + description + ".");
+		check(!what.empty(), "A failure is passed to the caller" + description + ".");
+		if(threadCount == 1) check(what == "Peer 5 could not be loaded.", "The first failure is passed to the caller.");
+	}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	TestCentral central(&bl);
+	for(size_t threadCount : { 1, 4, 100 })
+	{
+		testLoadPeers(central, threadCount);
+		testExceptions(central, threadCount);
+	}
+
+	//With a running thread pool the ranges are processed by pool workers.
+	check(bl.threadManager.startThreadPool(1, 4, 1), "The thread pool is started.");
+	testLoadPeers(central, 4);
+	testExceptions(central, 4);
+	bl.threadManager.stopThreadPool();
+
+	return finishTests();
+}
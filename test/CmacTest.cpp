@@ -0,0 +1,171 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+
+namespace
+{
+	void testCmac()
+	{
+		//Test vectors from RFC 4493
+		std::vector<uint8_t> key = BaseLib::HelperFunctions::getUBinary("2B7E151628AED2A6ABF7158809CF4F3C");
+		std::vector<uint8_t> empty;
+		std::vector<uint8_t> message = BaseLib::HelperFunctions::getUBinary("6BC1BEE22E409F96E93D7E117393172A");
+		std::vector<uint8_t> emptyMac = BaseLib::HelperFunctions::getUBinary("BB1D6929E95937287FA37D129B756746");
+		std::vector<uint8_t> messageMac = BaseLib::HelperFunctions::getUBinary("070A16B46B4D4144F79BDD9DD04A287C");
+
+		BaseLib::Security::Cmac cmac(key);
+		check(cmac.getMacLength() == 16, "The MAC length is 16 bytes.");
+
+		std::vector<uint8_t> mac;
+		cmac.calculate(empty, mac);
+		check(mac == emptyMac, "The CMAC of an empty message is correct.");
+		cmac.calculate(message, mac);
+		check(mac == messageMac, "The CMAC of a message is correct after reusing the handle.");
+
+		std::vector<uint8_t> staticMac;
+		BaseLib::Security::Mac::cmac(key, empty, message, staticMac);
+		check(mac == staticMac, "Cmac and Mac::cmac() return the same MAC.");
+
+		std::vector<std::vector<uint8_t>> messages{ message, empty, message };
+		std::vector<std::vector<uint8_t>> macs;
+		cmac.calculateBatch(messages, macs);
+		check(macs.size() == 3 && macs.at(0) == messageMac && macs.at(1) == emptyMac && macs.at(2) == messageMac, "The batch API returns one MAC per message.");
+
+		check(cmac.verify(message, messageMac), "A correct MAC is verified.");
+		check(cmac.verify(message, std::vector<uint8_t>(messageMac.begin(), messageMac.begin() + 8)), "A truncated MAC is verified.");
+		check(!cmac.verify(message, std::vector<uint8_t>(messageMac.begin(), messageMac.begin() + 4)), "A MAC shorter than the default minimum is rejected.");
+		check(cmac.verify(message, std::vector<uint8_t>(messageMac.begin(), messageMac.begin() + 4), 4), "The minimum MAC length can be lowered.");
+		check(!cmac.verify(message, std::vector<uint8_t>(messageMac.begin(), messageMac.begin() + 1), 4), "A MAC shorter than the minimum is rejected.");
+		std::vector<uint8_t> wrongMac = messageMac;
+		wrongMac.back() ^= 1;
+		check(!cmac.verify(message, wrongMac), "A wrong MAC is rejected.");
+	}
+
+	void testCipherBatch()
+	{
+		std::vector<uint8_t> key = BaseLib::HelperFunctions::getUBinary("2B7E151628AED2A6ABF7158809CF4F3C");
+		std::vector<std::vector<uint8_t>> messages{ BaseLib::HelperFunctions::getUBinary("6BC1BEE22E409F96E93D7E117393172A"), BaseLib::HelperFunctions::getUBinary("AE2D8A571E03AC9C9EB76FAC45AF8E5130C81C46A35CE411") };
+		std::vector<std::vector<uint8_t>> counters{ BaseLib::HelperFunctions::getUBinary("F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF"), BaseLib::HelperFunctions::getUBinary("00000000000000000000000000000001") };
+
+		BaseLib::Security::Gcrypt cipher(GCRY_CIPHER_AES128, GCRY_CIPHER_MODE_CTR, 0);
+		cipher.setKey(key);
+		std::vector<std::vector<uint8_t>> encrypted;
+		cipher.encryptBatch(encrypted, messages, counters);
+		check(encrypted.size() == 2, "One encrypted message is returned per message.");
+		//First block of the CTR test vector of NIST SP 800-38A
+		check(encrypted.at(0) == BaseLib::HelperFunctions::getUBinary("874D6191B620E3261BEF6864990DB6CE"), "The first message is encrypted correctly.");
+
+		BaseLib::Security::Gcrypt singleCipher(GCRY_CIPHER_AES128, GCRY_CIPHER_MODE_CTR, 0);
+		singleCipher.setKey(key);
+		singleCipher.setCounter(counters.at(1));
+		std::vector<uint8_t> singleEncrypted;
+		singleCipher.encrypt(singleEncrypted, messages.at(1));
+		check(encrypted.at(1) == singleEncrypted, "The counter is set for every message.");
+
+		std::vector<std::vector<uint8_t>> decrypted;
+		cipher.decryptBatch(decrypted, encrypted, counters);
+		check(decrypted == messages, "The messages are decrypted correctly.");
+
+		bool exceptionThrown = false;
+		try
+		{
+			cipher.encryptBatch(encrypted, messages, std::vector<std::vector<uint8_t>>());
+		}
+		catch(const BaseLib::Security::GcryptException& ex)
+		{
+			exceptionThrown = true;
+		}
+		check(exceptionThrown, "Encrypting without IVs throws in CTR mode.");
+
+		BaseLib::Security::Gcrypt ecbCipher(GCRY_CIPHER_AES128, GCRY_CIPHER_MODE_ECB, 0);
+		ecbCipher.setKey(key);
+		exceptionThrown = false;
+		try
+		{
+			ecbCipher.encryptBatch(encrypted, std::vector<std::vector<uint8_t>>{ messages.at(0) }, std::vector<std::vector<uint8_t>>());
+		}
+		catch(const BaseLib::Security::GcryptException& ex)
+		{
+			exceptionThrown = true;
+		}
+		check(!exceptionThrown && encrypted.size() == 1 && encrypted.at(0).size() == 16, "ECB mode doesn't need IVs.");
+	}
+
+	void benchmark()
+	{
+		std::vector<uint8_t> key = BaseLib::HelperFunctions::getUBinary("2B7E151628AED2A6ABF7158809CF4F3C");
+		std::vector<uint8_t> iv;
+		std::vector<uint8_t> message(24, 0x55);
+		std::vector<uint8_t> mac;
+		const int32_t count = 100000;
+
+		int64_t startTime = BaseLib::HelperFunctions::getTimeMicroseconds();
+		for(int32_t i = 0; i < count; i++)
+		{
+			message[0] = (uint8_t)i;
+			BaseLib::Security::Mac::cmac(key, iv, message, mac);
+		}
+		int64_t perCallTime = BaseLib::HelperFunctions::getTimeMicroseconds() - startTime;
+
+		BaseLib::Security::Cmac cmac(key);
+		startTime = BaseLib::HelperFunctions::getTimeMicroseconds();
+		for(int32_t i = 0; i < count; i++)
+		{
+			message[0] = (uint8_t)i;
+			cmac.calculate(message, mac);
+		}
+		int64_t cachedTime = BaseLib::HelperFunctions::getTimeMicroseconds() - startTime;
+
+		std::cout << "CMAC of " << count << " 24 byte messages: Mac::cmac() " << perCallTime / 1000 << " ms, Cmac " << cachedTime / 1000 << " ms." << std::endl;
+	}
+}
+
+int main()
+{
+	if(!gcry_check_version(GCRYPT_VERSION))
+	{
+		std::cerr << "Could not initialize gcrypt." << std::endl;
+		return 1;
+	}
+	gcry_control(GCRYCTL_SUSPEND_SECMEM_WARN);
+	gcry_control(GCRYCTL_INIT_SECMEM, 16384, 0);
+	gcry_control(GCRYCTL_RESUME_SECMEM_WARN);
+	gcry_control(GCRYCTL_INITIALIZATION_FINISHED, 0);
+
+	testCmac();
+	testCipherBatch();
+	benchmark();
+
+	return finishTests();
+}
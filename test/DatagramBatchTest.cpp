@@ -0,0 +1,105 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/Sockets/UdpSocket.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace
+{
+	int32_t createSocket(struct sockaddr_in& address)
+	{
+		int32_t descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+		if(descriptor == -1) return -1;
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = 0;
+		socklen_t addressLength = sizeof(address);
+		if(bind(descriptor, (struct sockaddr*)&address, sizeof(address)) == -1 || getsockname(descriptor, (struct sockaddr*)&address, &addressLength) == -1)
+		{
+			close(descriptor);
+			return -1;
+		}
+		return descriptor;
+	}
+
+	void testSendAndReceive()
+	{
+		struct sockaddr_in senderAddress{};
+		struct sockaddr_in receiverAddress{};
+		int32_t sender = createSocket(senderAddress);
+		int32_t receiver = createSocket(receiverAddress);
+		check(sender != -1 && receiver != -1, "Sockets are created.");
+		if(sender == -1 || receiver == -1) return;
+
+		BaseLib::DatagramBatch receiveBatch(8, 64);
+		check(receiveBatch.receive(receiver) == 0, "receive() returns 0 when no data is available.");
+
+		BaseLib::DatagramBatch sendBatch(12, 64);
+		for(int32_t i = 0; i < 12; i++)
+		{
+			std::string datagram = "Datagram " + std::to_string(i);
+			check(sendBatch.push(datagram.data(), datagram.size()), "push() accepts datagrams until the batch is full.");
+		}
+		check(!sendBatch.push("x", 1), "push() rejects datagrams when the batch is full.");
+		check(sendBatch.send(sender, (struct sockaddr*)&receiverAddress, sizeof(receiverAddress)) == 12, "send() sends all datagrams at once.");
+		check(sendBatch.empty(), "send() clears the batch after sending everything.");
+
+		check(receiveBatch.receive(receiver) == 8, "receive() fills the batch up to its capacity.");
+		for(size_t i = 0; i < receiveBatch.size(); i++)
+		{
+			check(std::string(receiveBatch.data(i), receiveBatch.length(i)) == "Datagram " + std::to_string(i), "Datagrams are received in order.");
+			check(receiveBatch.senderIp(i) == "127.0.0.1", "The sender IP is set.");
+			check(receiveBatch.senderPort(i) == ntohs(senderAddress.sin_port), "The sender port is set.");
+		}
+		check(receiveBatch.receive(receiver) == 4, "receive() returns the remaining datagrams.");
+		check(std::string(receiveBatch.data(3), receiveBatch.length(3)) == "Datagram 11", "The last datagram is received.");
+
+		std::string tooLarge(65, 'x');
+		check(!sendBatch.push(tooLarge.data(), tooLarge.size()), "push() rejects datagrams larger than the buffer size.");
+
+		close(sender);
+		close(receiver);
+	}
+}
+
+int main()
+{
+	testSendAndReceive();
+
+	return finishTests();
+}
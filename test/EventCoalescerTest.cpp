@@ -0,0 +1,148 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+
+namespace
+{
+	struct ReceivedEvent
+	{
+		std::string source;
+		int32_t channel = -1;
+		std::vector<std::string> variables;
+		std::vector<BaseLib::PVariable> values;
+	};
+
+	std::mutex eventsMutex;
+	std::vector<ReceivedEvent> events;
+
+	void eventReceived(std::string& source, uint64_t peerId, int32_t channel, std::string& deviceAddress, std::shared_ptr<std::vector<std::string>>& variables, std::shared_ptr<std::vector<BaseLib::PVariable>>& values)
+	{
+		std::lock_guard<std::mutex> eventsGuard(eventsMutex);
+		ReceivedEvent event;
+		event.source = source;
+		event.channel = channel;
+		event.variables = *variables;
+		event.values = *values;
+		events.push_back(event);
+	}
+
+	size_t eventCount()
+	{
+		std::lock_guard<std::mutex> eventsGuard(eventsMutex);
+		return events.size();
+	}
+
+	void add(BaseLib::Systems::EventCoalescer& coalescer, std::string source, int32_t channel, const std::string& variable, BaseLib::PVariable value)
+	{
+		std::string deviceAddress = "ABC0000001:" + std::to_string(channel);
+		auto variables = std::make_shared<std::vector<std::string>>();
+		variables->push_back(variable);
+		auto values = std::make_shared<std::vector<BaseLib::PVariable>>();
+		values->push_back(value);
+		coalescer.add(source, 1, channel, deviceAddress, variables, values);
+	}
+
+	void testInterval(BaseLib::SharedObjects* bl)
+	{
+		events.clear();
+		BaseLib::Systems::EventCoalescer coalescer(bl, 100, 0, &eventReceived);
+
+		add(coalescer, "device-1", 1, "POWER", std::make_shared<BaseLib::Variable>(1.0));
+		check(eventCount() == 1, "The first event of a channel is passed on immediately.");
+
+		add(coalescer, "device-1", 1, "POWER", std::make_shared<BaseLib::Variable>(2.0));
+		add(coalescer, "device-1", 1, "RSSI", std::make_shared<BaseLib::Variable>(-70));
+		add(coalescer, "device-1", 1, "POWER", std::make_shared<BaseLib::Variable>(3.0));
+		add(coalescer, "device-1", 2, "STATE", std::make_shared<BaseLib::Variable>(true));
+		check(eventCount() == 2, "Events within the interval are held back, other channels are not affected.");
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(300));
+		std::lock_guard<std::mutex> eventsGuard(eventsMutex);
+		check(events.size() == 3, "The held back events are passed on as one event.");
+		if(events.size() != 3) return;
+		check(events.at(1).channel == 2, "The event of channel 2 is passed on immediately.");
+		check(events.at(2).channel == 1 && events.at(2).variables.size() == 2, "The merged event contains each variable once.");
+		check(events.at(2).variables.at(0) == "POWER" && events.at(2).values.at(0)->floatValue == 3.0, "The merged event contains the latest value.");
+		check(events.at(2).variables.at(1) == "RSSI" && events.at(2).values.at(1)->integerValue == -70, "The variables keep the order of their first change.");
+	}
+
+	void testMinDelta(BaseLib::SharedObjects* bl)
+	{
+		events.clear();
+		BaseLib::Systems::EventCoalescer coalescer(bl, 0, 1.0, &eventReceived);
+
+		add(coalescer, "device-1", 1, "POWER", std::make_shared<BaseLib::Variable>(10.0));
+		add(coalescer, "device-1", 1, "POWER", std::make_shared<BaseLib::Variable>(10.5));
+		add(coalescer, "device-1", 1, "POWER", std::make_shared<BaseLib::Variable>(8.9));
+		add(coalescer, "device-1", 1, "POWER", std::make_shared<BaseLib::Variable>(9.5));
+		add(coalescer, "device-1", 1, "STATE", std::make_shared<BaseLib::Variable>(true));
+		add(coalescer, "device-1", 1, "STATE", std::make_shared<BaseLib::Variable>(true));
+
+		check(eventCount() == 4, "Numeric values differing by less than minDelta from the last value are dropped.");
+		if(events.size() != 4) return;
+		check(events.at(1).values.at(0)->floatValue == 8.9, "A value differing by minDelta is passed on.");
+		check(events.at(3).variables.at(0) == "STATE", "Non-numeric values are always passed on.");
+	}
+
+	void testSourceAndDispose(BaseLib::SharedObjects* bl)
+	{
+		events.clear();
+		BaseLib::Systems::EventCoalescer coalescer(bl, 60000, 0, &eventReceived);
+
+		add(coalescer, "device-1", 1, "LEVEL", std::make_shared<BaseLib::Variable>(0.1));
+		add(coalescer, "device-1", 1, "LEVEL", std::make_shared<BaseLib::Variable>(0.2));
+		check(eventCount() == 1, "The second event is held back.");
+
+		add(coalescer, "homegear", 1, "LEVEL", std::make_shared<BaseLib::Variable>(0.5));
+		check(eventCount() == 3, "An event of another source passes on the pending event and itself.");
+		if(events.size() == 3) check(events.at(1).source == "device-1" && events.at(2).source == "homegear", "Events of different sources are not mixed.");
+
+		add(coalescer, "homegear", 1, "LEVEL", std::make_shared<BaseLib::Variable>(0.7));
+		check(eventCount() == 3, "The event is held back.");
+		coalescer.dispose();
+		check(eventCount() == 4, "dispose() passes on pending events.");
+		add(coalescer, "homegear", 1, "LEVEL", std::make_shared<BaseLib::Variable>(0.8));
+		check(eventCount() == 5, "After dispose() events are passed on immediately.");
+	}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	testInterval(&bl);
+	testMinDelta(&bl);
+	testSourceAndDispose(&bl);
+
+	return finishTests();
+}
@@ -0,0 +1,201 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/Encoding/GZip.h"
+#include "TestHelpers.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace
+{
+	/**
+	 * Creates JSON like data that compresses reasonably well.
+	 */
+	std::string createPayload(size_t size)
+	{
+		std::mt19937 random(size);
+		std::string payload;
+		payload.reserve(size + 64);
+		while(payload.size() < size)
+		{
+			payload += "{\"peerId\":" + std::to_string(random() % 1000) + ",\"channel\":" + std::to_string(random() % 10) + ",\"value\":" + std::to_string(random()) + "}";
+		}
+		payload.resize(size);
+		return payload;
+	}
+
+	void testOneShot()
+	{
+		for(size_t size : { (size_t)0, (size_t)1, (size_t)1000, (size_t)100000, (size_t)3000000 })
+		{
+			std::string payload = createPayload(size);
+			std::vector<char> compressed = BaseLib::GZip::compress<std::vector<char>, std::string>(payload, 6);
+			check(compressed.size() >= 18 && (uint8_t)compressed.at(0) == 0x1F && (uint8_t)compressed.at(1) == 0x8B, "Output is a gzip stream (size " + std::to_string(size) + ").");
+			check(BaseLib::GZip::uncompress<std::string, std::vector<char>>(compressed) == payload, "One-shot round trip (size " + std::to_string(size) + ").");
+		}
+
+		bool exceptionThrown = false;
+		try
+		{
+			std::string invalid("This is not a gzip stream.");
+			BaseLib::GZip::uncompress<std::string, std::string>(invalid);
+		}
+		catch(BaseLib::GZipException& ex)
+		{
+			exceptionThrown = true;
+		}
+		check(exceptionThrown, "Invalid data throws.");
+
+		//Compresses far better than the limit of the size hint, so the output needs to grow.
+		std::string zeros(16 * 1024 * 1024, '\0');
+		std::vector<char> compressed = BaseLib::GZip::compress<std::vector<char>, std::string>(zeros, 9);
+		check(BaseLib::GZip::uncompress<std::string, std::vector<char>>(compressed) == zeros, "Highly compressed data is uncompressed completely.");
+
+		//The size in the trailer is not trusted.
+		compressed = BaseLib::GZip::compress<std::vector<char>, std::string>(createPayload(1000), 6);
+		compressed.at(compressed.size() - 1) = (char)0x7F;
+		exceptionThrown = false;
+		try
+		{
+			BaseLib::GZip::uncompress<std::string, std::vector<char>>(compressed);
+		}
+		catch(BaseLib::GZipException& ex)
+		{
+			exceptionThrown = true;
+		}
+		check(exceptionThrown, "A wrong uncompressed size in the trailer throws.");
+	}
+
+	void testStreaming()
+	{
+		BaseLib::GZipCompressor compressor(6, 1024);
+		BaseLib::GZipUncompressor uncompressor;
+		for(size_t size : { (size_t)0, (size_t)5000, (size_t)500000 })
+		{
+			std::string payload = createPayload(size);
+			std::vector<char> compressed;
+			auto compressedSink = [&](const char* data, size_t size) { compressed.insert(compressed.end(), data, data + size); };
+			for(size_t i = 0; i < payload.size(); i += 777)
+			{
+				compressor.write(payload.data() + i, std::min((size_t)777, payload.size() - i), compressedSink);
+			}
+			compressor.finish(compressedSink);
+			check(BaseLib::GZip::uncompress<std::string, std::vector<char>>(compressed) == payload, "Streamed compression can be uncompressed (size " + std::to_string(size) + ").");
+
+			std::string uncompressed;
+			auto uncompressedSink = [&](const char* data, size_t size) { uncompressed.append(data, size); };
+			for(size_t i = 0; i < compressed.size(); i += 13)
+			{
+				uncompressor.write(compressed.data() + i, std::min((size_t)13, compressed.size() - i), uncompressedSink);
+			}
+			check(uncompressor.finished() && uncompressed == payload, "Streamed uncompression (size " + std::to_string(size) + ").");
+		}
+
+		//Flush makes everything written so far available to the receiver.
+		std::vector<char> compressed;
+		auto compressedSink = [&](const char* data, size_t size) { compressed.insert(compressed.end(), data, data + size); };
+		std::string uncompressed;
+		auto uncompressedSink = [&](const char* data, size_t size) { uncompressed.append(data, size); };
+		uncompressor.reset();
+		compressor.write("Hello", 5, compressedSink);
+		compressor.flush(compressedSink);
+		uncompressor.write(compressed.data(), compressed.size(), uncompressedSink);
+		check(uncompressed == "Hello" && !uncompressor.finished(), "Flushed data can be uncompressed.");
+		compressor.reset();
+
+		//Concatenated streams
+		compressed = BaseLib::GZip::compress<std::vector<char>, std::string>(std::string("abc"), 6);
+		std::vector<char> second = BaseLib::GZip::compress<std::vector<char>, std::string>(std::string("def"), 6);
+		compressed.insert(compressed.end(), second.begin(), second.end());
+		uncompressed.clear();
+		uncompressor.reset();
+		uncompressor.write(compressed.data(), compressed.size(), uncompressedSink);
+		check(uncompressed == "abcdef" && uncompressor.finished(), "Concatenated streams are uncompressed.");
+
+		//Size limit
+		std::string zeros(1000000, 0);
+		compressed = BaseLib::GZip::compress<std::vector<char>, std::string>(zeros, 9);
+		BaseLib::GZipUncompressor limitedUncompressor(100000);
+		bool exceptionThrown = false;
+		try
+		{
+			limitedUncompressor.write(compressed.data(), compressed.size(), [](const char* data, size_t size) {});
+		}
+		catch(BaseLib::GZipException& ex)
+		{
+			exceptionThrown = true;
+		}
+		check(exceptionThrown, "Uncompressed size is limited.");
+	}
+
+	/**
+	 * Prints the time needed to compress small payloads. Always passes, the numbers are for comparison only.
+	 */
+	void benchmark()
+	{
+		std::string payload = createPayload(2000);
+		const size_t iterations = 5000;
+		size_t totalSize = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		for(size_t i = 0; i < iterations; i++)
+		{
+			totalSize += BaseLib::GZip::compress<std::vector<char>, std::string>(payload, 6).size();
+		}
+		double oneShotSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		BaseLib::GZipCompressor compressor(6);
+		std::vector<char> compressed;
+		auto sink = [&](const char* data, size_t size) { compressed.insert(compressed.end(), data, data + size); };
+		start = std::chrono::steady_clock::now();
+		for(size_t i = 0; i < iterations; i++)
+		{
+			compressed.clear();
+			compressor.write(payload.data(), payload.size(), sink);
+			compressor.finish(sink);
+			totalSize += compressed.size();
+		}
+		double streamingSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "Compressing " << iterations << " payloads of " << payload.size() << " bytes: GZip::compress " << (int64_t)(oneShotSeconds * 1000) << " ms, reused GZipCompressor " << (int64_t)(streamingSeconds * 1000) << " ms (" << totalSize << " bytes)" << std::endl;
+	}
+}
+
+int main()
+{
+	testOneShot();
+	testStreaming();
+	benchmark();
+
+	return finishTests();
+}
@@ -0,0 +1,171 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+#include "../src/Encoding/GZip.h"
+
+#include <iostream>
+#include <fstream>
+
+namespace
+{
+	struct Response
+	{
+		int32_t code = 0;
+		std::map<std::string, std::string> fields;
+		std::string body;
+	};
+
+	std::atomic_int callbackCalls{0};
+	std::shared_ptr<BaseLib::HttpServer> server;
+
+	void packetReceived(int32_t clientId, BaseLib::Http& http)
+	{
+		callbackCalls++;
+		std::string header = "HTTP/1.1 404 Not Found\r\nConnection: close\r\nContent-Length: 0\r\n\r\n";
+		server->send(clientId, std::vector<char>(header.begin(), header.end()));
+	}
+
+	Response request(BaseLib::SharedObjects* bl, const std::string& port, const std::string& method, const std::string& path, const std::string& additionalHeaders = "")
+	{
+		Response response;
+		std::string data;
+		try
+		{
+			BaseLib::TcpSocket client(bl, "127.0.0.1", port);
+			client.setReadTimeout(5000000);
+			client.open();
+			client.proofwrite(method + " " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n" + additionalHeaders + "\r\n");
+			std::array<char, 65536> buffer{};
+			while(true)
+			{
+				int32_t bytesRead = client.proofread(buffer.data(), buffer.size());
+				data.append(buffer.data(), bytesRead);
+			}
+		}
+		catch(const std::exception& ex)
+		{
+		}
+
+		auto headerEnd = data.find("\r\n\r\n");
+		if(headerEnd == std::string::npos || data.size() < 12) return response;
+		response.code = std::stoi(data.substr(9, 3));
+		auto lines = BaseLib::HelperFunctions::splitAll(data.substr(0, headerEnd), '\n');
+		for(auto& line : lines)
+		{
+			auto field = BaseLib::HelperFunctions::splitFirst(line, ':');
+			BaseLib::HelperFunctions::toLower(field.first);
+			response.fields[field.first] = BaseLib::HelperFunctions::trim(field.second);
+		}
+		response.body = data.substr(headerEnd + 4);
+		return response;
+	}
+
+	void writeFile(const std::string& filename, const std::string& content)
+	{
+		std::ofstream file(filename, std::ios::binary);
+		file << content;
+	}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+
+	char contentPathTemplate[] = "/tmp/HttpServerTestXXXXXX";
+	std::string contentPath = mkdtemp(contentPathTemplate);
+	std::string largeFile;
+	largeFile.reserve(2 * 1024 * 1024);
+	for(int32_t i = 0; i < 2 * 1024 * 1024; i++)
+	{
+		largeFile.push_back((char)(BaseLib::HelperFunctions::getRandomNumber(0, 255)));
+	}
+	std::string script;
+	for(int32_t i = 0; i < 1000; i++)
+	{
+		script.append("console.log(" + std::to_string(i) + ");\n");
+	}
+	writeFile(contentPath + "/large.bin", largeFile);
+	writeFile(contentPath + "/app.js", script);
+	writeFile(contentPath + "/index.html", "<html></html>");
+	writeFile("/tmp/HttpServerTestSecret", "secret");
+	symlink("/tmp/HttpServerTestSecret", (contentPath + "/secret").c_str());
+
+	BaseLib::HttpServer::HttpServerInfo serverInfo;
+	serverInfo.contentPath = contentPath;
+	serverInfo.packetReceivedCallback = std::bind(&packetReceived, std::placeholders::_1, std::placeholders::_2);
+	server = std::make_shared<BaseLib::HttpServer>(&bl, serverInfo);
+	std::string port = std::to_string(20000 + getpid() % 20000);
+	std::string listenAddress;
+	server->start("127.0.0.1", port, listenAddress);
+
+	auto response = request(&bl, port, "GET", "/large.bin");
+	check(response.code == 200 && response.body == largeFile, "Large files are sent completely.");
+	check(!response.fields["etag"].empty() && !response.fields["last-modified"].empty(), "Responses contain ETag and Last-Modified.");
+
+	auto notModifiedResponse = request(&bl, port, "GET", "/large.bin", "If-None-Match: " + response.fields["etag"] + "\r\n");
+	check(notModifiedResponse.code == 304 && notModifiedResponse.body.empty(), "If-None-Match returns 304.");
+	notModifiedResponse = request(&bl, port, "GET", "/large.bin", "If-Modified-Since: " + response.fields["last-modified"] + "\r\n");
+	check(notModifiedResponse.code == 304, "If-Modified-Since returns 304.");
+	auto modifiedResponse = request(&bl, port, "GET", "/large.bin", "If-Modified-Since: Thu, 01 Jan 1970 00:00:00 GMT\r\n");
+	check(modifiedResponse.code == 200 && modifiedResponse.body == largeFile, "Modified files are sent.");
+
+	auto headResponse = request(&bl, port, "HEAD", "/large.bin");
+	check(headResponse.code == 200 && headResponse.body.empty() && headResponse.fields["content-length"] == std::to_string(largeFile.size()), "HEAD requests return the header only.");
+
+	for(int32_t i = 0; i < 2; i++)
+	{
+		auto compressedResponse = request(&bl, port, "GET", "/app.js", "Accept-Encoding: gzip, deflate\r\n");
+		check(compressedResponse.code == 200 && compressedResponse.fields["content-encoding"] == "gzip", "Small text files are sent gzipped.");
+		check(compressedResponse.body.size() < script.size() && BaseLib::GZip::uncompress<std::string>(compressedResponse.body) == script, "The gzipped content is correct.");
+		check(compressedResponse.fields["etag"] != request(&bl, port, "GET", "/app.js").fields["etag"], "Gzipped files have their own ETag.");
+	}
+	auto plainResponse = request(&bl, port, "GET", "/app.js");
+	check(plainResponse.body == script && plainResponse.fields["content-type"] == "text/javascript", "Clients not accepting gzip get the plain file.");
+
+	check(request(&bl, port, "GET", "/").body == "<html></html>", "index.html is sent for directories.");
+
+	check(request(&bl, port, "GET", "/missing").code == 404 && callbackCalls == 1, "Unknown paths are passed to the callback.");
+	check(request(&bl, port, "GET", "/secret").code == 404 && callbackCalls == 2, "Symlinks out of the content path are not followed.");
+	check(request(&bl, port, "POST", "/index.html", "Content-Length: 0\r\n").code == 404 && callbackCalls == 3, "Only GET and HEAD requests are answered.");
+
+	server->stop();
+	server->waitForStop();
+	server.reset();
+	unlink("/tmp/HttpServerTestSecret");
+	for(auto& file : { "/large.bin", "/app.js", "/index.html", "/secret" })
+	{
+		unlink((contentPath + file).c_str());
+	}
+	rmdir(contentPath.c_str());
+
+	return finishTests();
+}
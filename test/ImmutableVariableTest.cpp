@@ -0,0 +1,178 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/ImmutableVariable.h"
+#include "TestHelpers.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+namespace
+{
+	std::atomic<size_t> allocations{0};
+	BaseLib::PVariable createTree()
+	{
+		auto tree = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+		for(int32_t i = 0; i < 20; i++)
+		{
+			auto array = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tArray);
+			for(int32_t j = 0; j < 5; j++)
+			{
+				array->arrayValue->push_back(std::make_shared<BaseLib::Variable>(i * 5 + j));
+			}
+			tree->structValue->emplace("member" + std::to_string(i), array);
+		}
+		tree->structValue->emplace("name", std::make_shared<BaseLib::Variable>(std::string("Module update with a name long enough to need the heap")));
+		return tree;
+	}
+
+	/**
+	 * Hands tree to clientCount clients by copying it for each of them. Returns the number of allocations needed.
+	 */
+	size_t deepCopyFanOut(const BaseLib::PVariable& tree, size_t clientCount)
+	{
+		std::vector<BaseLib::PVariable> clients;
+		clients.reserve(clientCount);
+		size_t allocationsBefore = allocations;
+		for(size_t i = 0; i < clientCount; i++)
+		{
+			clients.push_back(std::make_shared<BaseLib::Variable>(*tree));
+		}
+		return allocations - allocationsBefore;
+	}
+
+	/**
+	 * Hands tree to clientCount clients through one ImmutableVariable. Returns the number of allocations needed.
+	 */
+	size_t sharedFanOut(const BaseLib::PVariable& tree, size_t clientCount)
+	{
+		std::vector<BaseLib::ImmutableVariable> clients;
+		clients.reserve(clientCount);
+		size_t allocationsBefore = allocations;
+		BaseLib::ImmutableVariable shared(tree);
+		for(size_t i = 0; i < clientCount; i++)
+		{
+			clients.push_back(shared);
+		}
+		return allocations - allocationsBefore;
+	}
+
+	void testAllocations()
+	{
+		auto tree = createTree();
+
+		size_t deepCopyOne = deepCopyFanOut(tree, 1);
+		size_t deepCopyHundred = deepCopyFanOut(tree, 100);
+		size_t sharedOne = sharedFanOut(tree, 1);
+		size_t sharedHundred = sharedFanOut(tree, 100);
+
+		std::cout << "Allocations for 1 client: deep copy " << deepCopyOne << ", shared " << sharedOne << std::endl;
+		std::cout << "Allocations for 100 clients: deep copy " << deepCopyHundred << ", shared " << sharedHundred << std::endl;
+
+		check(deepCopyOne > 0, "Copying the tree allocates.");
+		check(deepCopyHundred == deepCopyOne * 100, "Deep copies allocate once per client.");
+		check(sharedOne == deepCopyOne, "The handle copies the tree exactly once.");
+		check(sharedHundred == sharedOne, "Copying the handle does not allocate.");
+	}
+
+	void testIndependence()
+	{
+		auto tree = createTree();
+		BaseLib::ImmutableVariable shared(tree);
+
+		tree->structValue->at("member0")->arrayValue->at(0)->integerValue = 1000;
+		tree->structValue->erase("name");
+		check(shared.at("member0").at(0).integerValue() == 0, "Modifying the original does not change the handle.");
+		check(shared.contains("name"), "Removing a member from the original does not change the handle.");
+
+		auto copy = shared.copy();
+		copy->structValue->at("member1")->arrayValue->at(2)->integerValue = 2000;
+		copy->structValue->clear();
+		check(shared.at("member1").at(2).integerValue() == 7, "Modifying a copy does not change the handle.");
+		check(shared.size() == 21, "Clearing a copy does not change the handle.");
+
+		BaseLib::ImmutableVariable element = BaseLib::ImmutableVariable(tree).at("member3");
+		check(element.size() == 5 && element.at(4).integerValue() == 19, "Nested handles keep the tree alive.");
+	}
+
+	void testAccessors()
+	{
+		BaseLib::ImmutableVariable shared(createTree());
+		check(shared.type() == BaseLib::VariableType::tStruct, "Type is preserved.");
+		check(shared.at("name").stringValue() == "Module update with a name long enough to need the heap", "Strings are preserved.");
+		check(!shared.contains("member20"), "contains() returns false for missing members.");
+
+		size_t members = 0;
+		shared.forEachMember([&](const std::string& name, const BaseLib::ImmutableVariable& member) { if(member.type() == BaseLib::VariableType::tArray) members++; });
+		check(members == 20, "forEachMember() visits all members.");
+
+		int64_t sum = 0;
+		shared.at("member2").forEachElement([&](const BaseLib::ImmutableVariable& element) { sum += element.integerValue(); });
+		check(sum == 10 + 11 + 12 + 13 + 14, "forEachElement() visits all elements.");
+
+		bool thrown = false;
+		try { shared.at("member20"); }
+		catch(const std::out_of_range&) { thrown = true; }
+		check(thrown, "at() throws for missing members.");
+
+		thrown = false;
+		try { shared.at("member0").at(5); }
+		catch(const std::out_of_range&) { thrown = true; }
+		check(thrown, "at() throws for indexes out of range.");
+
+		BaseLib::ImmutableVariable empty;
+		check(empty.type() == BaseLib::VariableType::tVoid && empty.size() == 0, "Default handles are empty.");
+	}
+}
+
+void* operator new(size_t size)
+{
+	allocations++;
+	void* memory = std::malloc(size == 0 ? 1 : size);
+	if(!memory) throw std::bad_alloc();
+	return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+int main()
+{
+	testAllocations();
+	testIndependence();
+	testAccessors();
+
+	return finishTests();
+}
@@ -0,0 +1,190 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+	/**
+	 * Redirects the standard output into a string while it exists.
+	 */
+	class CapturedOutput
+	{
+	public:
+		CapturedOutput() { _oldBuffer = std::cout.rdbuf(_stream.rdbuf()); }
+		~CapturedOutput() { std::cout.rdbuf(_oldBuffer); }
+
+		/**
+		 * Returns the messages printed with the prefix "Test: " in the order they were written, without timestamps.
+		 */
+		std::vector<std::string> getMessages()
+		{
+			std::vector<std::string> messages;
+			std::istringstream stream(_stream.str());
+			std::string line;
+			while(std::getline(stream, line))
+			{
+				auto position = line.find("Test: ");
+				if(position != std::string::npos) messages.push_back(line.substr(position + 6));
+			}
+			return messages;
+		}
+
+		std::string getText() { return _stream.str(); }
+	private:
+		std::ostringstream _stream;
+		std::streambuf* _oldBuffer = nullptr;
+	};
+
+	void testOrdering(BaseLib::SharedObjects* bl)
+	{
+		BaseLib::Output output;
+		output.init(bl);
+		output.setPrefix("Test: ");
+
+		std::vector<std::string> messages;
+		{
+			CapturedOutput capturedOutput;
+			BaseLib::Output::startAsynchronousOutput(1024, 5);
+			check(BaseLib::Output::asynchronousOutput(), "Asynchronous output is enabled.");
+
+			output.printMessage("First");
+			//Timestamps have a resolution of one millisecond. Messages of different threads written in the same millisecond have no defined order.
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			std::thread thread1([&]()
+			{
+				for(int32_t i = 0; i < 200; i++) output.printMessage("A " + std::to_string(i));
+			});
+			std::thread thread2([&]()
+			{
+				for(int32_t i = 0; i < 200; i++) output.printMessage("B " + std::to_string(i));
+			});
+			thread1.join();
+			thread2.join();
+			std::this_thread::sleep_for(std::chrono::milliseconds(2));
+			output.printMessage("Last");
+
+			BaseLib::Output::stopAsynchronousOutput();
+			check(!BaseLib::Output::asynchronousOutput(), "Asynchronous output is disabled.");
+			messages = capturedOutput.getMessages();
+		}
+
+		check(messages.size() == 402, "All messages are written.");
+		check(!messages.empty() && messages.front() == "First", "A message written before the threads started comes first.");
+		check(!messages.empty() && messages.back() == "Last", "A message written after the threads finished comes last.");
+		int32_t nextA = 0;
+		int32_t nextB = 0;
+		bool ordered = true;
+		for(auto& message : messages)
+		{
+			if(message == "A " + std::to_string(nextA)) nextA++;
+			else if(message == "B " + std::to_string(nextB)) nextB++;
+			else if(message != "First" && message != "Last") ordered = false;
+		}
+		check(ordered && nextA == 200 && nextB == 200, "The messages of each thread keep their order.");
+	}
+
+	void testDropping(BaseLib::SharedObjects* bl)
+	{
+		BaseLib::Output output;
+		output.init(bl);
+		output.setPrefix("Test: ");
+
+		uint64_t droppedMessages = BaseLib::Output::droppedMessages();
+		std::vector<std::string> messages;
+		std::string text;
+		{
+			CapturedOutput capturedOutput;
+			//The writer thread doesn't drain the buffer before stopAsynchronousOutput() is called.
+			BaseLib::Output::startAsynchronousOutput(4, 10000);
+			for(int32_t i = 0; i < 10; i++) output.printMessage(std::to_string(i));
+			BaseLib::Output::stopAsynchronousOutput();
+			messages = capturedOutput.getMessages();
+			text = capturedOutput.getText();
+		}
+
+		check(messages == std::vector<std::string>{ "0", "1", "2", "3" }, "Messages are dropped when the buffer of the thread is full.");
+		check(BaseLib::Output::droppedMessages() - droppedMessages == 6, "The dropped messages are counted.");
+		check(text.find("6 log messages were dropped") != std::string::npos, "The number of dropped messages is printed.");
+	}
+
+	void testFlush(BaseLib::SharedObjects* bl)
+	{
+		BaseLib::Output output;
+		output.init(bl);
+		output.setPrefix("Test: ");
+
+		std::vector<std::string> messages;
+		{
+			CapturedOutput capturedOutput;
+			BaseLib::Output::startAsynchronousOutput(1024, 10000);
+			std::thread thread([&]()
+			{
+				for(int32_t i = 0; i < 100; i++) output.printMessage(std::to_string(i));
+			});
+			thread.join();
+			for(int32_t i = 100; i < 200; i++) output.printMessage(std::to_string(i));
+			BaseLib::Output::stopAsynchronousOutput();
+			check(capturedOutput.getMessages().size() == 200, "stopAsynchronousOutput() writes all queued messages, including those of finished threads.");
+
+			output.printMessage("Synchronous");
+			messages = capturedOutput.getMessages();
+		}
+
+		check(!messages.empty() && messages.back() == "Synchronous", "Messages are written synchronously after stopAsynchronousOutput().");
+
+		//Restarting uses new buffers.
+		{
+			CapturedOutput capturedOutput;
+			BaseLib::Output::startAsynchronousOutput(1024, 10000);
+			output.printMessage("Restarted");
+			BaseLib::Output::stopAsynchronousOutput();
+			messages = capturedOutput.getMessages();
+		}
+		check(messages == std::vector<std::string>{ "Restarted" }, "Asynchronous output can be restarted.");
+	}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	bl.debugLevel = 4;
+
+	testOrdering(&bl);
+	testDropping(&bl);
+	testFlush(&bl);
+
+	return finishTests();
+}
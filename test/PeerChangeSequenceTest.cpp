@@ -0,0 +1,123 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+	class TestPeer : public BaseLib::Systems::Peer
+	{
+	public:
+		TestPeer(BaseLib::SharedObjects* bl) : Peer(bl, 1, 1, "TEST0000001", 1, nullptr) {}
+
+		bool wireless() override { return false; }
+		std::string handleCliCommand(std::string command) override { return ""; }
+		int32_t getChannelGroupedWith(int32_t channel) override { return -1; }
+		int32_t getNewFirmwareVersion() override { return 0; }
+		std::string getFirmwareVersionString(int32_t firmwareVersion) override { return ""; }
+		bool firmwareUpdateAvailable() override { return false; }
+		BaseLib::DeviceDescription::PParameterGroup getParameterSet(int32_t channel, BaseLib::DeviceDescription::ParameterGroup::Type::Enum type) override { return BaseLib::DeviceDescription::PParameterGroup(); }
+		void savePeers() override {}
+		std::shared_ptr<BaseLib::Systems::ICentral> getCentral() override { return std::shared_ptr<BaseLib::Systems::ICentral>(); }
+		BaseLib::PVariable putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t channel, BaseLib::DeviceDescription::ParameterGroup::Type::Enum type, uint64_t remoteID, int32_t remoteChannel, BaseLib::PVariable variables, bool checkAcls, bool onlyPushing = false) override { return BaseLib::PVariable(); }
+
+		void valuesChanged(int32_t channel, const std::vector<std::string>& names)
+		{
+			std::string source = "test";
+			std::string address = "TEST0000001:" + std::to_string(channel);
+			auto valueKeys = std::make_shared<std::vector<std::string>>(names);
+			auto values = std::make_shared<std::vector<BaseLib::PVariable>>(names.size(), std::make_shared<BaseLib::Variable>(true));
+			raiseRPCEvent(source, _peerID, channel, address, valueKeys, values);
+		}
+	};
+
+	void testSeed()
+	{
+		uint64_t initialSequence = BaseLib::Systems::Peer::getInitialChangeSequence();
+		check(initialSequence > 0 && (int64_t)initialSequence > 0, "The initial change sequence is positive as signed integer.");
+		check((initialSequence & ((1ull << 44) - 1)) == 0, "The lower bits of the initial change sequence are free for changes.");
+		check(BaseLib::Systems::Peer::isKnownChangeSequence(BaseLib::Systems::Peer::getCurrentChangeSequence()), "The current change sequence is known.");
+		check(!BaseLib::Systems::Peer::isKnownChangeSequence(0), "0 is no known change sequence.");
+		//Tokens of other runs are outside of the range of this run, no matter how the clock was set.
+		check(!BaseLib::Systems::Peer::isKnownChangeSequence(initialSequence - 1), "Tokens of runs with a lower epoch are not known.");
+		check(!BaseLib::Systems::Peer::isKnownChangeSequence(initialSequence + (1ull << 44)), "Tokens of runs with a higher epoch are not known.");
+		check(!BaseLib::Systems::Peer::isKnownChangeSequence(BaseLib::Systems::Peer::getCurrentChangeSequence() + 1), "Tokens newer than the current change sequence are not known.");
+	}
+
+	void testValueChanges(BaseLib::SharedObjects* bl)
+	{
+		TestPeer peer(bl);
+		uint64_t creationSequence = peer.getCreationChangeSequence();
+		check(creationSequence > BaseLib::Systems::Peer::getInitialChangeSequence() && peer.getChangeSequence() == creationSequence, "A new peer is changed at its creation.");
+
+		peer.valuesChanged(1, std::vector<std::string>{ "STATE", "LEVEL" });
+		uint64_t sequence = peer.getChangeSequence();
+		check(sequence > creationSequence && sequence == BaseLib::Systems::Peer::getCurrentChangeSequence(), "Value changes increment the change sequence.");
+		check(peer.getChannelChangeSequence(1) == sequence && peer.getValueChangeSequence(1, "STATE") == sequence && peer.getValueChangeSequence(1, "LEVEL") == sequence, "Channel and values get the sequence of the change.");
+		check(peer.getChannelChangeSequence(2) == 0 && peer.getValueChangeSequence(1, "UNKNOWN") == 0, "Unchanged channels and values have no sequence.");
+		check(peer.getDescriptionChangeSequence() == creationSequence, "Value changes don't change the description.");
+
+		peer.valuesChanged(1, std::vector<std::string>{ "LEVEL" });
+		check(peer.getValueChangeSequence(1, "STATE") == sequence && peer.getValueChangeSequence(1, "LEVEL") > sequence && peer.getChannelChangeSequence(1) == peer.getValueChangeSequence(1, "LEVEL"), "Only the changed value gets a new sequence.");
+	}
+
+	void benchmark(BaseLib::SharedObjects* bl)
+	{
+		TestPeer peer(bl);
+		std::string source = "test";
+		std::string address = "TEST0000001:1";
+		auto valueKeys = std::make_shared<std::vector<std::string>>(std::vector<std::string>{ "STATE" });
+		auto values = std::make_shared<std::vector<BaseLib::PVariable>>(1, std::make_shared<BaseLib::Variable>(true));
+		const int32_t count = 1000000;
+
+		int64_t startTime = BaseLib::HelperFunctions::getTimeMicroseconds();
+		for(int32_t i = 0; i < count; i++)
+		{
+			peer.valuesChanged(i % 10, *valueKeys);
+		}
+		int64_t duration = BaseLib::HelperFunctions::getTimeMicroseconds() - startTime;
+
+		std::cout << "Recording " << count << " value changes: " << duration / 1000 << " ms (" << (duration * 1000) / count << " ns per event)." << std::endl;
+	}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	testSeed();
+	testValueChanges(&bl);
+	benchmark(&bl);
+
+	return finishTests();
+}
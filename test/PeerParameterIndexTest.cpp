@@ -0,0 +1,384 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	class TestPeer : public BaseLib::Systems::Peer
+	{
+	public:
+		TestPeer(BaseLib::SharedObjects* bl) : Peer(bl, 1, 1, "TEST0000001", 1, nullptr) {}
+
+		bool wireless() override { return false; }
+		std::string handleCliCommand(std::string command) override { return ""; }
+		int32_t getChannelGroupedWith(int32_t channel) override { return -1; }
+		int32_t getNewFirmwareVersion() override { return 0; }
+		std::string getFirmwareVersionString(int32_t firmwareVersion) override { return ""; }
+		bool firmwareUpdateAvailable() override { return false; }
+		BaseLib::DeviceDescription::PParameterGroup getParameterSet(int32_t channel, BaseLib::DeviceDescription::ParameterGroup::Type::Enum type) override { return BaseLib::DeviceDescription::PParameterGroup(); }
+		void savePeers() override {}
+		std::shared_ptr<BaseLib::Systems::ICentral> getCentral() override { return std::shared_ptr<BaseLib::Systems::ICentral>(); }
+		BaseLib::PVariable putParamset(BaseLib::PRpcClientInfo clientInfo, int32_t channel, BaseLib::DeviceDescription::ParameterGroup::Type::Enum type, uint64_t remoteID, int32_t remoteChannel, BaseLib::PVariable variables, bool checkAcls, bool onlyPushing = false) override { return BaseLib::PVariable(); }
+
+		using Peer::getParamsetDescriptionEntry;
+		using Peer::getVariableDescription;
+	};
+
+	class TestDevices : public BaseLib::DeviceDescription::Devices
+	{
+	public:
+		TestDevices(BaseLib::SharedObjects* bl) : Devices(bl, nullptr, 1) {}
+
+		void addDevice(const std::shared_ptr<BaseLib::DeviceDescription::HomegearDevice>& device) { _devices.push_back(device); }
+	};
+
+	const uint32_t channelCount = 10;
+	const uint32_t parameterCount = 40;
+
+	std::shared_ptr<BaseLib::DeviceDescription::HomegearDevice> createDevice(BaseLib::SharedObjects* bl)
+	{
+		auto device = std::make_shared<BaseLib::DeviceDescription::HomegearDevice>(bl);
+		//All channels share one group of variables like channels of the same type do in device descriptions.
+		auto variables = std::make_shared<BaseLib::DeviceDescription::Variables>(bl);
+		for(uint32_t i = 0; i < parameterCount; i++)
+		{
+			auto parameter = std::make_shared<BaseLib::DeviceDescription::Parameter>(bl, variables);
+			parameter->id = "PARAMETER_" + std::to_string(i);
+			variables->parameters.emplace(parameter->id, parameter);
+			variables->parametersOrdered.push_back(parameter);
+		}
+		for(uint32_t channel = 1; channel <= channelCount; channel++)
+		{
+			auto function = std::make_shared<BaseLib::DeviceDescription::Function>(bl);
+			function->channel = channel;
+			function->variables = variables;
+			device->functions.emplace(channel, function);
+		}
+
+		//Alternative function with its own parameter objects for an existing ID and a new ID.
+		auto alternativeFunction = std::make_shared<BaseLib::DeviceDescription::Function>(bl);
+		for(auto id : { "PARAMETER_0", "ALTERNATIVE" })
+		{
+			auto parameter = std::make_shared<BaseLib::DeviceDescription::Parameter>(bl, alternativeFunction->variables);
+			parameter->id = id;
+			alternativeFunction->variables->parameters.emplace(parameter->id, parameter);
+		}
+		device->functions.at(1)->alternativeFunctions.push_back(alternativeFunction);
+		return device;
+	}
+
+	void fillValues(TestPeer& peer)
+	{
+		auto device = peer.getRpcDevice();
+		for(auto& function : device->functions)
+		{
+			for(auto& parameter : function.second->variables->parameters)
+			{
+				BaseLib::Systems::RpcConfigurationParameter entry;
+				entry.rpcParameter = parameter.second;
+				peer.valuesCentral[function.first].emplace(parameter.first, entry);
+			}
+		}
+	}
+
+	void testIndex(BaseLib::SharedObjects* bl)
+	{
+		auto device = createDevice(bl);
+		check(device->indexParameters() == parameterCount + 1, "Each distinct parameter ID gets one index.");
+		check(device->getParameterIndex("PARAMETER_0") == device->functions.at(1)->alternativeFunctions.at(0)->variables->parameters.at("PARAMETER_0")->nameIndex, "Parameters with the same ID share the index.");
+		check(device->getParameterIndex("UNKNOWN") == -1, "Unknown IDs have no index.");
+
+		TestPeer peer(bl);
+		peer.setRpcDevice(device);
+		fillValues(peer);
+		peer.indexParameters();
+
+		bool allFound = true;
+		for(auto& function : device->functions)
+		{
+			for(auto& parameter : function.second->variables->parameters)
+			{
+				if(peer.getValueParameter(function.first, parameter.second) != &peer.valuesCentral.at(function.first).at(parameter.first)) allFound = false;
+			}
+		}
+		check(allFound, "All values are found through the index.");
+
+		auto alternativeParameter = device->functions.at(1)->alternativeFunctions.at(0)->variables->parameters.at("PARAMETER_0");
+		check(peer.getValueParameter(1, alternativeParameter) == &peer.valuesCentral.at(1).at("PARAMETER_0"), "Parameters of alternative functions find the shared entry.");
+		check(peer.getValueParameter(1, device->functions.at(2)->variables->parameters.at("PARAMETER_5")) == &peer.valuesCentral.at(1).at("PARAMETER_5"), "Lookup uses the requested channel.");
+		check(peer.getValueParameter(channelCount + 1, alternativeParameter) == nullptr, "Unknown channels return nullptr.");
+		check(peer.getConfigParameter(1, alternativeParameter) == nullptr, "Missing config parameters return nullptr.");
+
+		//Not part of the device description and added after indexing
+		auto dynamicParameter = std::make_shared<BaseLib::DeviceDescription::Parameter>(bl, device->functions.at(1)->variables);
+		dynamicParameter->id = "DYNAMIC";
+		BaseLib::Systems::RpcConfigurationParameter entry;
+		entry.rpcParameter = dynamicParameter;
+		peer.valuesCentral.at(1).emplace("DYNAMIC", entry);
+		check(peer.getValueParameter(1, dynamicParameter) == &peer.valuesCentral.at(1).at("DYNAMIC"), "Entries added after indexing are found.");
+
+		//Families erase entries without calling indexParameters().
+		auto erasedParameter = device->functions.at(2)->variables->parameters.at("PARAMETER_7");
+		peer.valuesCentral.at(2).erase("PARAMETER_7");
+		check(peer.getValueParameter(2, erasedParameter) == nullptr, "Erased entries are not returned.");
+		BaseLib::Systems::RpcConfigurationParameter newEntry;
+		newEntry.rpcParameter = erasedParameter;
+		peer.valuesCentral.at(2).emplace("PARAMETER_7", newEntry);
+		check(peer.getValueParameter(2, erasedParameter) == &peer.valuesCentral.at(2).at("PARAMETER_7"), "Entries added again after erasing are found.");
+		peer.valuesCentral.erase(3);
+		check(peer.getValueParameter(3, erasedParameter) == nullptr, "Entries of erased channels are not returned.");
+		peer.valuesCentral.at(4) = peer.valuesCentral.at(5);
+		check(peer.getValueParameter(4, erasedParameter) == &peer.valuesCentral.at(4).at("PARAMETER_7"), "Entries of replaced channel maps are found.");
+
+		check(alternativeParameter->hasParent(device->functions.at(1)->alternativeFunctions.at(0)->variables), "Parameters know their group.");
+		check(!alternativeParameter->hasParent(device->functions.at(1)->variables), "Parameters are not part of other groups.");
+	}
+
+	void testDescriptionCache(BaseLib::SharedObjects* bl)
+	{
+		auto device = createDevice(bl);
+		check(!device->getCachedDescription("paramset.1.0.en-US"), "The cache is empty initially.");
+
+		auto description = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+		description->structValue->emplace("PARAMETER_0", std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct));
+		device->setCachedDescription("paramset.1.0.en-US", "en-US", description);
+		check(device->getCachedDescription("paramset.1.0.en-US") == description, "Cached descriptions are returned.");
+		check(!device->getCachedDescription("paramset.1.0.de-DE"), "Descriptions are cached per key.");
+
+		device->setCachedDescription("error", "en-US", BaseLib::Variable::createError(-5, "Unknown parameter."));
+		check(!device->getCachedDescription("error"), "Errors are not cached.");
+
+		for(int32_t i = 0; i < 20; i++)
+		{
+			std::string language = "language" + std::to_string(i);
+			device->setCachedDescription("paramset.1.0." + language, language, description);
+		}
+		check(device->getCachedDescription("paramset.1.0.language6") && !device->getCachedDescription("paramset.1.0.language7"), "Descriptions are cached for a limited number of languages.");
+		device->setCachedDescription("paramset.2.0.en-US", "en-US", description);
+		check(device->getCachedDescription("paramset.2.0.en-US") == description, "Cached languages still accept new descriptions.");
+
+		//Copies with more channels are created by Devices::find() for devices with dynamic channel count.
+		auto copy = std::make_shared<BaseLib::DeviceDescription::HomegearDevice>(bl);
+		*copy = *device;
+		check(copy->getCachedDescription("paramset.1.0.en-US") == description, "Copies share the cache.");
+
+		device->indexParameters();
+		check(device->getCachedDescription("paramset.1.0.en-US") == description, "Indexing doesn't clear the cache.");
+		device->indexParameters(true);
+		check(!device->getCachedDescription("paramset.1.0.en-US") && !copy->getCachedDescription("paramset.1.0.en-US"), "Forced indexing clears the cache.");
+	}
+
+	std::vector<BaseLib::PRpcClientInfo> createClientInfos()
+	{
+		std::vector<BaseLib::PRpcClientInfo> clientInfos;
+		for(int32_t i = 0; i < 4; i++)
+		{
+			auto clientInfo = std::make_shared<BaseLib::RpcClientInfo>();
+			clientInfo->initNewFormat = (i != 1);
+			if(i == 2) clientInfo->clientType = BaseLib::RpcClientType::ccu2;
+			clientInfo->language = (i == 3) ? "de-DE" : "en-US";
+			clientInfos.push_back(clientInfo);
+		}
+		return clientInfos;
+	}
+
+	/**
+	 * Sets up parameters which are filtered for some clients.
+	 */
+	void addSpecialParameters(BaseLib::SharedObjects* bl, const std::shared_ptr<BaseLib::DeviceDescription::HomegearDevice>& device)
+	{
+		auto& parameters = device->functions.at(1)->variables->parameters;
+		parameters.at("PARAMETER_1")->logical = std::make_shared<BaseLib::DeviceDescription::LogicalArray>(bl);
+		parameters.at("PARAMETER_2")->ccu2Visible = false;
+		parameters.at("PARAMETER_3")->visible = false;
+	}
+
+	bool equalDescriptions(const BaseLib::PVariable& description1, const BaseLib::PVariable& description2)
+	{
+		if(!description1 || !description2) return false;
+		if(description1->errorStruct || description2->errorStruct) return description1->errorStruct && description2->errorStruct;
+		return *description1 == *description2;
+	}
+
+	void testCachedPeerDescriptions(BaseLib::SharedObjects* bl)
+	{
+		auto device = createDevice(bl);
+		addSpecialParameters(bl, device);
+		auto& parameters = device->functions.at(1)->variables->parametersOrdered;
+
+		//Two peers of the same type with different assignments
+		TestPeer peer1(bl);
+		TestPeer peer2(bl);
+		for(auto peer : { &peer1, &peer2 })
+		{
+			peer->setRpcDevice(device);
+			fillValues(*peer);
+			peer->indexParameters();
+		}
+		peer1.valuesCentral.at(1).at("PARAMETER_0").setRoom(3);
+		peer1.valuesCentral.at(1).at("PARAMETER_0").addRole(7, BaseLib::RoleDirection::input, true);
+		peer2.valuesCentral.at(1).at("PARAMETER_0").setRoom(4);
+		peer2.valuesCentral.at(1).at("PARAMETER_0").addCategory(5);
+
+		bool equal = true;
+		bool filtered = true;
+		for(auto& clientInfo : createClientInfos())
+		{
+			//The second round is served from the cache.
+			for(int32_t round = 0; round < 2; round++)
+			{
+				for(auto peer : { &peer1, &peer2 })
+				{
+					int32_t index = round;
+					for(auto& parameter : parameters)
+					{
+						auto valueParameter = &peer->valuesCentral.at(1).at(parameter->id);
+						auto cachedDescription = peer->getParamsetDescriptionEntry(clientInfo, parameter, 1, BaseLib::DeviceDescription::ParameterGroup::Type::Enum::variables, index, valueParameter, true);
+						auto description = peer->getVariableDescription(clientInfo, parameter, 1, BaseLib::DeviceDescription::ParameterGroup::Type::Enum::variables, index, std::unordered_set<std::string>());
+						if(!equalDescriptions(cachedDescription, description)) equal = false;
+						if(parameter->id == "PARAMETER_1" && !clientInfo->initNewFormat && !cachedDescription->errorStruct) filtered = false;
+						if(parameter->id == "PARAMETER_2" && clientInfo->clientType == BaseLib::RpcClientType::ccu2 && !cachedDescription->errorStruct) filtered = false;
+						index++;
+					}
+				}
+			}
+		}
+		check(equal, "Cached parameter descriptions equal freshly built ones, including TAB_ORDER, ROOM, CATEGORIES and ROLES of each peer.");
+		check(filtered, "Parameters unsupported by the client are filtered with the cache.");
+
+		auto clientInfo = createClientInfos().at(0);
+		auto parameter = device->functions.at(1)->variables->parameters.at("PARAMETER_0");
+		auto description = peer1.getParamsetDescriptionEntry(clientInfo, parameter, 1, BaseLib::DeviceDescription::ParameterGroup::Type::Enum::variables, 0, &peer1.valuesCentral.at(1).at("PARAMETER_0"), true);
+		description->structValue->clear();
+		description = peer2.getParamsetDescriptionEntry(clientInfo, parameter, 1, BaseLib::DeviceDescription::ParameterGroup::Type::Enum::variables, 0, &peer2.valuesCentral.at(1).at("PARAMETER_0"), true);
+		check(description->structValue->find("ID") != description->structValue->end() && description->structValue->at("ROOM")->integerValue == 4 && description->structValue->find("ROLES") == description->structValue->end(), "Each call returns its own struct.");
+	}
+
+	void testCachedParamsetDescriptions(BaseLib::SharedObjects* bl)
+	{
+		auto device = createDevice(bl);
+		addSpecialParameters(bl, device);
+		auto supportedDevice = std::make_shared<BaseLib::DeviceDescription::SupportedDevice>(bl);
+		supportedDevice->typeNumber = 0x1234;
+		device->supportedDevices.push_back(supportedDevice);
+		TestDevices devices(bl);
+		devices.addDevice(device);
+
+		bool equal = true;
+		for(auto& clientInfo : createClientInfos())
+		{
+			auto description = devices.getParamsetDescription(clientInfo, 0x1234, 1, 1, BaseLib::DeviceDescription::ParameterGroup::Type::Enum::variables);
+			auto cachedDescription = devices.getParamsetDescription(clientInfo, 0x1234, 1, 1, BaseLib::DeviceDescription::ParameterGroup::Type::Enum::variables);
+			if(!description || description->errorStruct || description->structValue->empty() || !equalDescriptions(cachedDescription, description)) equal = false;
+			if(description && (description->structValue->find("PARAMETER_1") != description->structValue->end()) != clientInfo->initNewFormat) equal = false;
+
+			//Callers may change the returned struct.
+			cachedDescription->structValue->erase("PARAMETER_0");
+			device->clearCachedDescriptions();
+			if(!equalDescriptions(devices.getParamsetDescription(clientInfo, 0x1234, 1, 1, BaseLib::DeviceDescription::ParameterGroup::Type::Enum::variables), description)) equal = false;
+		}
+		check(equal, "Cached paramset descriptions equal freshly built ones for each client.");
+	}
+
+	void testRpcConfigurationParameter()
+	{
+		BaseLib::Systems::RpcConfigurationParameter parameter;
+		check(!parameter.hasCategories() && !parameter.hasRoles() && parameter.getCategoryString().empty() && parameter.getRoleString().empty(), "New parameters have no assignments.");
+		parameter.addCategory(5);
+		parameter.addRole(7, BaseLib::RoleDirection::input, true);
+		parameter.setRoom(3);
+
+		BaseLib::Systems::RpcConfigurationParameter copy(parameter);
+		check(copy.hasCategory(5) && copy.getRole(7).invert && copy.getRoom() == 3, "Copies keep the assignments.");
+		copy.removeCategory(5);
+		check(parameter.hasCategory(5) && !copy.hasCategory(5), "Copies don't share the assignments.");
+		copy = BaseLib::Systems::RpcConfigurationParameter();
+		check(!copy.hasRoles() && copy.getRole(7).id == 0, "Assignment clears the assignments.");
+		check(parameter.getRoleString() == "7-" + std::to_string((int32_t)BaseLib::RoleDirection::input) + "-1,", "Role string is unchanged.");
+		std::cout << "sizeof(RpcConfigurationParameter): " << sizeof(BaseLib::Systems::RpcConfigurationParameter) << " bytes" << std::endl;
+	}
+
+	/**
+	 * Prints the time of lookups through the maps and through the index. Always passes, the numbers are for comparison only.
+	 */
+	void benchmark(BaseLib::SharedObjects* bl)
+	{
+		TestPeer peer(bl);
+		peer.setRpcDevice(createDevice(bl));
+		fillValues(peer);
+		peer.indexParameters();
+		auto& parameters = peer.getRpcDevice()->functions.at(1)->variables->parametersOrdered;
+		const size_t iterations = 200000;
+
+		size_t found = 0;
+		auto start = std::chrono::steady_clock::now();
+		for(size_t i = 0; i < iterations; i++)
+		{
+			for(auto& parameter : parameters)
+			{
+				auto channelIterator = peer.valuesCentral.find((i % channelCount) + 1);
+				if(channelIterator != peer.valuesCentral.end() && channelIterator->second.find(parameter->id) != channelIterator->second.end()) found++;
+			}
+		}
+		double mapSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+		for(size_t i = 0; i < iterations; i++)
+		{
+			for(auto& parameter : parameters)
+			{
+				if(peer.getValueParameter((i % channelCount) + 1, parameter)) found++;
+			}
+		}
+		double indexSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		double lookups = (double)(iterations * parameters.size());
+		std::cout << "Lookup by name: " << (int64_t)(mapSeconds * 1e9 / lookups) << " ns, lookup by index: " << (int64_t)(indexSeconds * 1e9 / lookups) << " ns (" << found << ")" << std::endl;
+	}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	testIndex(&bl);
+	testDescriptionCache(&bl);
+	testCachedPeerDescriptions(&bl);
+	testCachedParamsetDescriptions(&bl);
+	testRpcConfigurationParameter();
+	benchmark(&bl);
+
+	return finishTests();
+}
@@ -0,0 +1,132 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+
+namespace
+{
+	BaseLib::PVariable createAcls(const std::string& methodName)
+	{
+		auto methods = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+		methods->structValue->emplace(methodName, std::make_shared<BaseLib::Variable>(true));
+		auto acl = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tStruct);
+		acl->structValue->emplace("methods", methods);
+		auto acls = std::make_shared<BaseLib::Variable>(BaseLib::VariableType::tArray);
+		acls->arrayValue->push_back(acl);
+		return acls;
+	}
+
+	BaseLib::PRpcClientInfo createClientInfo(BaseLib::SharedObjects* bl, int32_t id, const std::string& allowedMethod)
+	{
+		auto clientInfo = std::make_shared<BaseLib::RpcClientInfo>();
+		clientInfo->id = id;
+		clientInfo->rpcType = BaseLib::RpcType::json;
+		clientInfo->acls = std::make_shared<BaseLib::Security::Acls>(bl, id);
+		clientInfo->acls->fromVariable(createAcls(allowedMethod));
+		return clientInfo;
+	}
+
+	std::shared_ptr<std::vector<char>> createResponse(size_t size, char value)
+	{
+		return std::make_shared<std::vector<char>>(size, value);
+	}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+
+	check(BaseLib::Rpc::RpcResponseCache::isCacheable("listDevices") && !BaseLib::Rpc::RpcResponseCache::isCacheable("setValue"), "Only read only methods are cacheable.");
+
+	auto clientInfo1 = createClientInfo(&bl, 1, "listDevices");
+	auto clientInfo2 = createClientInfo(&bl, 2, "listDevices");
+	auto clientInfo3 = createClientInfo(&bl, 3, "getParamsetDescription");
+	check(clientInfo1->acls->getFingerprint() == clientInfo2->acls->getFingerprint(), "Equal ACLs have the same fingerprint.");
+	check(clientInfo1->acls->getFingerprint() != clientInfo3->acls->getFingerprint(), "Different ACLs have different fingerprints.");
+
+	auto parameters = std::make_shared<BaseLib::Array>();
+	parameters->push_back(std::make_shared<BaseLib::Variable>(false));
+	auto otherParameters = std::make_shared<BaseLib::Array>();
+	otherParameters->push_back(std::make_shared<BaseLib::Variable>(true));
+
+	std::string key1 = BaseLib::Rpc::RpcResponseCache::getKey(clientInfo1, "listDevices", parameters);
+	check(key1 == BaseLib::Rpc::RpcResponseCache::getKey(clientInfo2, "listDevices", parameters), "Clients with the same ACLs share responses.");
+	check(key1 != BaseLib::Rpc::RpcResponseCache::getKey(clientInfo3, "listDevices", parameters), "Clients with different ACLs don't share responses.");
+	check(key1 != BaseLib::Rpc::RpcResponseCache::getKey(clientInfo1, "listDevices", otherParameters), "The parameters are part of the key.");
+	check(key1 != BaseLib::Rpc::RpcResponseCache::getKey(clientInfo1, "getDeviceDescription", parameters), "The method is part of the key.");
+	clientInfo2->language = "de-DE";
+	check(key1 != BaseLib::Rpc::RpcResponseCache::getKey(clientInfo2, "listDevices", parameters), "Clients with different languages don't share responses.");
+	clientInfo2->language = clientInfo1->language;
+	clientInfo2->initNewFormat = !clientInfo1->initNewFormat;
+	check(key1 != BaseLib::Rpc::RpcResponseCache::getKey(clientInfo2, "listDevices", parameters), "Clients with different formats don't share responses.");
+	clientInfo2->initNewFormat = clientInfo1->initNewFormat;
+	check(key1 == BaseLib::Rpc::RpcResponseCache::getKey(clientInfo2, "listDevices", parameters), "Keys are equal again after restoring language and format.");
+	clientInfo2->rpcType = BaseLib::RpcType::xml;
+	check(key1 != BaseLib::Rpc::RpcResponseCache::getKey(clientInfo2, "listDevices", parameters), "The RPC type is part of the key.");
+
+	BaseLib::Rpc::RpcResponseCache cache(1000);
+	check(!cache.get(key1, 1), "Unknown keys miss.");
+	cache.set(key1, 1, createResponse(100, 'a'));
+	auto response = cache.get(key1, 1);
+	check(response && response->size() == 100 && response->at(0) == 'a', "Responses are returned for the same generation.");
+	check(!cache.get(key1, 2), "Responses of other generations are not returned.");
+	check(!cache.get(key1, 1), "Outdated responses are removed.");
+
+	//LRU eviction: "0" is used again, so "1" is the least recently used entry when "9" is added.
+	for(int32_t i = 0; i < 9; i++)
+	{
+		cache.set(std::to_string(i), 1, createResponse(100, (char)i));
+	}
+	cache.get("0", 1);
+	cache.set("9", 1, createResponse(200, 9));
+	check(cache.get("0", 1) && !cache.get("1", 1) && cache.get("2", 1) && cache.get("9", 1), "The least recently used response is removed first.");
+	cache.set("large", 1, createResponse(1001, 'x'));
+	check(!cache.get("large", 1), "Responses larger than the cache are not stored.");
+
+	auto metrics = cache.getMetrics();
+	check(metrics.bytes <= 1000 && metrics.entries == 9 && metrics.hits == 5, "The metrics are correct.");
+	cache.clear();
+	check(cache.getMetrics().entries == 0 && cache.getMetrics().bytes == 0, "clear() removes all responses.");
+
+	auto germanClientInfo = createClientInfo(&bl, 4, "listDevices");
+	germanClientInfo->language = "de-DE";
+	std::string germanKey = BaseLib::Rpc::RpcResponseCache::getKey(germanClientInfo, "listDevices", parameters);
+	cache.set(key1, 1, createResponse(100, 'e'));
+	check(!cache.get(germanKey, 1), "Responses of clients with another language are not returned.");
+	cache.set(germanKey, 1, createResponse(100, 'g'));
+	response = cache.get(key1, 1);
+	auto germanResponse = cache.get(germanKey, 1);
+	check(cache.getMetrics().entries == 2 && response && response->at(0) == 'e' && germanResponse && germanResponse->at(0) == 'g', "Clients with different languages get different entries.");
+
+	return finishTests();
+}
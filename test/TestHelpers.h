@@ -0,0 +1,71 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#ifndef LIBHOMEGEAR_BASE_TESTHELPERS_H_
+#define LIBHOMEGEAR_BASE_TESTHELPERS_H_
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/**
+ * Scaffold shared by all tests. Every test is a single translation unit, so the definitions live in an anonymous namespace.
+ */
+namespace
+{
+	int32_t failures = 0;
+
+	/**
+	 * Records a failure when "condition" is false.
+	 *
+	 * @param condition The condition to test.
+	 * @param description What is expected. Printed on failure.
+	 */
+	void check(bool condition, const std::string& description)
+	{
+		if(condition) return;
+		std::cerr << "FAILED: " << description << std::endl;
+		failures++;
+	}
+
+	/**
+	 * Prints the result of the test.
+	 *
+	 * @return The exit code of the test: 0 when all checks passed, 1 otherwise.
+	 */
+	int finishTests()
+	{
+		if(failures > 0) return 1;
+		std::cout << "All tests passed." << std::endl;
+		return 0;
+	}
+}
+
+#endif
@@ -0,0 +1,145 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+	void testTasks(BaseLib::SharedObjects* bl)
+	{
+		check(bl->threadManager.startThreadPool(1, 4, 1), "The thread pool is started.");
+
+		std::vector<std::future<int32_t>> results;
+		for(int32_t i = 0; i < 1000; i++)
+		{
+			results.push_back(bl->threadManager.submit([](int32_t value) { return value * 2; }, i));
+		}
+		bool correct = true;
+		for(int32_t i = 0; i < (signed)results.size(); i++)
+		{
+			if(results[i].get() != i * 2) correct = false;
+		}
+		check(correct, "All tasks return their result.");
+
+		auto lowResult = bl->threadManager.submit(BaseLib::ThreadManager::ThreadPoolLane::low, [bl]() { return bl->threadManager.isThreadPoolWorker(); });
+		check(lowResult.get(), "Tasks are executed by workers.");
+		check(!bl->threadManager.isThreadPoolWorker(), "Other threads are no workers.");
+
+		auto exceptionResult = bl->threadManager.submit([]() -> int32_t { throw BaseLib::Exception("Test"); });
+		bool exceptionThrown = false;
+		try
+		{
+			exceptionResult.get();
+		}
+		catch(const BaseLib::Exception& ex)
+		{
+			exceptionThrown = true;
+		}
+		check(exceptionThrown, "Exceptions of tasks are stored in the future.");
+
+		//Tasks submitting tasks use their own queue.
+		auto nestedResult = bl->threadManager.submit([bl]()
+		{
+			std::vector<std::future<int32_t>> nestedResults;
+			for(int32_t i = 0; i < 100; i++)
+			{
+				nestedResults.push_back(bl->threadManager.submit([](int32_t value) { return value; }, i));
+			}
+			int32_t sum = 0;
+			for(auto& result : nestedResults)
+			{
+				sum += result.get();
+			}
+			return sum;
+		});
+		check(nestedResult.get() == 4950, "Tasks can submit tasks.");
+
+		//The counters are incremented after the result is set.
+		auto metrics = bl->threadManager.getThreadPoolMetrics();
+		for(int32_t i = 0; i < 100 && (metrics.at(BaseLib::ThreadManager::ThreadPoolLane::normal).processedTasks < 1102 || metrics.at(BaseLib::ThreadManager::ThreadPoolLane::low).processedTasks < 1); i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			metrics = bl->threadManager.getThreadPoolMetrics();
+		}
+		auto& normalMetrics = metrics.at(BaseLib::ThreadManager::ThreadPoolLane::normal);
+		check(normalMetrics.threadCount == 4, "The metrics contain the thread count.");
+		check(normalMetrics.processedTasks == 1102 && normalMetrics.queueSize == 0, "The metrics count all processed tasks.");
+		check(normalMetrics.maxQueueSize > 0 && normalMetrics.maxQueueSize <= 1000, "The maximum queue size is recorded.");
+		check(metrics.at(BaseLib::ThreadManager::ThreadPoolLane::low).processedTasks == 1, "Every lane has its own metrics.");
+
+		bl->threadManager.stopThreadPool();
+		check(!bl->threadManager.threadPoolRunning(), "The thread pool is stopped.");
+		exceptionThrown = false;
+		try
+		{
+			bl->threadManager.submit([]() { return 0; });
+		}
+		catch(const BaseLib::Exception& ex)
+		{
+			exceptionThrown = true;
+		}
+		check(exceptionThrown, "Submitting to a stopped thread pool throws.");
+	}
+
+	void testStop(BaseLib::SharedObjects* bl)
+	{
+		check(bl->threadManager.startThreadPool(0, 2, 0), "The thread pool is started again.");
+
+		//Tasks still running or queued while the pool is stopped are executed and may call methods of the thread manager.
+		std::atomic<int32_t> executedTasks{0};
+		std::atomic<int32_t> metricsCalls{0};
+		for(int32_t i = 0; i < 20; i++)
+		{
+			bl->threadManager.submit([&]()
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				bl->threadManager.getThreadPoolMetrics();
+				bl->threadManager.getThreadPoolQueueSize(BaseLib::ThreadManager::ThreadPoolLane::normal);
+				metricsCalls++;
+				executedTasks++;
+			});
+		}
+		bl->threadManager.stopThreadPool();
+		check(executedTasks == 20 && metricsCalls == 20, "Stopping executes all queued tasks without deadlocking.");
+	}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	testTasks(&bl);
+	testStop(&bl);
+
+	return finishTests();
+}
@@ -0,0 +1,158 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/BaseLib.h"
+#include "TestHelpers.h"
+
+#include <iostream>
+#include <condition_variable>
+
+namespace
+{
+	std::mutex packetsMutex;
+	std::condition_variable packetsConditionVariable;
+	std::vector<std::pair<int32_t, std::string>> packets;
+
+	void packetReceived(const BaseLib::UdpServer::UdpPacket& packet)
+	{
+		std::lock_guard<std::mutex> packetsGuard(packetsMutex);
+		packets.emplace_back(packet.listenerId, std::string(packet.data, packet.size));
+		packetsConditionVariable.notify_all();
+	}
+
+	bool waitForPackets(size_t count)
+	{
+		std::unique_lock<std::mutex> packetsGuard(packetsMutex);
+		return packetsConditionVariable.wait_for(packetsGuard, std::chrono::seconds(5), [&] { return packets.size() >= count; });
+	}
+
+	void sendTo(int32_t port, const std::string& data)
+	{
+		int32_t descriptor = socket(AF_INET, SOCK_DGRAM, 0);
+		struct sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		address.sin_port = htons(port);
+		sendto(descriptor, data.data(), data.size(), 0, (struct sockaddr*)&address, sizeof(address));
+		close(descriptor);
+	}
+
+	void testListeners(BaseLib::SharedObjects* bl)
+	{
+		BaseLib::UdpServer::UdpServerInfo serverInfo;
+		serverInfo.bufferCount = 4;
+		serverInfo.packetReceivedCallback = std::bind(&packetReceived, std::placeholders::_1);
+		BaseLib::UdpServer server(bl, serverInfo);
+
+		std::string listenAddress;
+		int32_t port1 = -1;
+		int32_t port2 = -1;
+		int32_t listener1 = server.addListener("127.0.0.1", "0", listenAddress, port1);
+		int32_t listener2 = server.addListener("127.0.0.1", "0", listenAddress, port2);
+		check(port1 > 0 && port2 > 0 && port1 != port2, "Listeners get their own ports.");
+		check(server.listenerCount() == 2, "Both listeners are added.");
+		server.startServer();
+
+		for(int32_t i = 0; i < 10; i++)
+		{
+			sendTo(port1, "A" + std::to_string(i));
+		}
+		sendTo(port2, "B");
+		check(waitForPackets(11), "All datagrams are delivered by the shared thread.");
+		{
+			std::lock_guard<std::mutex> packetsGuard(packetsMutex);
+			size_t listener1Packets = 0;
+			for(auto& packet : packets)
+			{
+				if(packet.first == listener1) listener1Packets++;
+				else check(packet.first == listener2 && packet.second == "B", "Datagrams are passed with the ID of their listener.");
+			}
+			check(listener1Packets == 10, "Datagrams to one port are all delivered.");
+			packets.clear();
+		}
+
+		server.removeListener(listener2);
+		check(server.listenerCount() == 1, "Listeners can be removed while running.");
+		sendTo(port1, "C");
+		check(waitForPackets(1), "The remaining listener still receives datagrams.");
+
+		server.stopServer();
+		server.waitForServerStopped();
+		check(server.listenerCount() == 1, "Stopping the server keeps the listeners.");
+		{
+			std::lock_guard<std::mutex> packetsGuard(packetsMutex);
+			packets.clear();
+		}
+
+		server.startServer();
+		sendTo(port1, "D");
+		check(waitForPackets(1), "The listener is opened again on the same port when the server is restarted.");
+		{
+			std::lock_guard<std::mutex> packetsGuard(packetsMutex);
+			check(!packets.empty() && packets.front().first == listener1 && packets.front().second == "D", "The reopened listener keeps its ID.");
+		}
+		server.sendToClient(listener1, "127.0.0.1", (uint16_t)port1, std::vector<uint8_t>{ 'E' });
+		check(waitForPackets(2), "The reopened listener can send.");
+
+		server.stopServer();
+		server.waitForServerStopped();
+		server.removeListener(listener1);
+		check(server.listenerCount() == 0, "Stopped listeners can be removed.");
+	}
+
+	void testRestart(BaseLib::SharedObjects* bl)
+	{
+		{
+			std::lock_guard<std::mutex> packetsGuard(packetsMutex);
+			packets.clear();
+		}
+		BaseLib::UdpServer::UdpServerInfo serverInfo;
+		serverInfo.packetReceivedCallback = std::bind(&packetReceived, std::placeholders::_1);
+		BaseLib::UdpServer server(bl, serverInfo);
+
+		std::string listenAddress;
+		int32_t listenerId = server.startServer("127.0.0.1", "0", listenAddress);
+		server.stopServer();
+		server.waitForServerStopped();
+		check(server.startServer("127.0.0.1", "0", listenAddress) == listenerId && server.listenerCount() == 1, "Restarting with the same address reuses the listener.");
+		check(listenAddress == "127.0.0.1", "The listen address is returned for reused listeners.");
+		server.stopServer();
+		server.waitForServerStopped();
+	}
+}
+
+int main()
+{
+	BaseLib::SharedObjects bl;
+	testListeners(&bl);
+	testRestart(&bl);
+
+	return finishTests();
+}
@@ -0,0 +1,249 @@
+/* Copyright 2013-2019 Homegear GmbH
+ *
+ * libhomegear-base is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * libhomegear-base is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libhomegear-base.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU Lesser General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+*/
+
+#include "../src/Encoding/WebSocket.h"
+#include "TestHelpers.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace
+{
+	void applyMaskBytewise(std::vector<char>& data, const char* maskingKey)
+	{
+		for(size_t i = 0; i < data.size(); i++)
+		{
+			data[i] ^= maskingKey[i % 4];
+		}
+	}
+
+	std::vector<char> createPayload(size_t size)
+	{
+		std::mt19937 random(7);
+		std::vector<char> payload(size);
+		for(auto& byte : payload)
+		{
+			byte = (char)random();
+		}
+		return payload;
+	}
+
+	void testMask()
+	{
+		const char maskingKey[4] = { 0x12, (char)0x9A, 0x3C, (char)0xF0 };
+		for(size_t size = 0; size < 70; size++)
+		{
+			for(size_t offset = 0; offset < 4; offset++)
+			{
+				std::vector<char> payload = createPayload(size + offset);
+				std::vector<char> expected = payload;
+				applyMaskBytewise(expected, maskingKey);
+				//Mask the first bytes separately to check continuing at an offset.
+				BaseLib::WebSocket::applyMask(payload.data(), offset, maskingKey);
+				BaseLib::WebSocket::applyMask(payload.data() + offset, size, maskingKey, offset);
+				if(payload != expected)
+				{
+					check(false, "applyMask() matches byte wise masking (size " + std::to_string(size) + ", offset " + std::to_string(offset) + ").");
+					return;
+				}
+			}
+		}
+	}
+
+	void testDecode()
+	{
+		std::vector<char> payload = createPayload(300);
+		const char maskingKey[4] = { 0x01, 0x02, 0x03, 0x04 };
+		std::vector<char> frame{ (char)0x82, (char)(0x80 | 126), 0x01, 0x2C };
+		frame.insert(frame.end(), maskingKey, maskingKey + 4);
+		std::vector<char> maskedPayload = payload;
+		applyMaskBytewise(maskedPayload, maskingKey);
+		frame.insert(frame.end(), maskedPayload.begin(), maskedPayload.end());
+
+		BaseLib::WebSocket webSocket;
+		webSocket.process(frame.data(), frame.size());
+		check(webSocket.isFinished(), "Masked frame is processed.");
+		check(webSocket.getContent() == payload, "Masked frame is unmasked.");
+	}
+
+	void testEncode()
+	{
+		for(size_t size : { (size_t)0, (size_t)125, (size_t)126, (size_t)65535, (size_t)65536 })
+		{
+			std::vector<char> payload = createPayload(size);
+			std::vector<char> expected;
+			BaseLib::WebSocket::encode(payload, BaseLib::WebSocket::Header::Opcode::text, expected);
+
+			std::vector<char> buffer(BaseLib::WebSocket::maxHeaderSize);
+			buffer.insert(buffer.end(), payload.begin(), payload.end());
+			size_t start = BaseLib::WebSocket::encodeInPlace(buffer, BaseLib::WebSocket::Header::Opcode::text);
+			check(std::vector<char>(buffer.begin() + start, buffer.end()) == expected, "encodeInPlace() creates the same frame as encode() (size " + std::to_string(size) + ").");
+
+			BaseLib::WebSocket webSocket;
+			webSocket.process(expected.data(), expected.size());
+			check(size == 0 || (webSocket.isFinished() && webSocket.getContent() == payload), "Encoded frames can be decoded (size " + std::to_string(size) + ").");
+		}
+	}
+
+	void testPerMessageDeflate()
+	{
+		BaseLib::PerMessageDeflate::Parameters parameters;
+		std::string response;
+		check(BaseLib::PerMessageDeflate::negotiate("x-webkit-deflate-frame, permessage-deflate; client_max_window_bits", parameters, response), "permessage-deflate offer is accepted.");
+		check(response == "permessage-deflate", "Response to the default offer is plain.");
+		check(BaseLib::PerMessageDeflate::negotiate("permessage-deflate; server_max_window_bits=10; client_no_context_takeover", parameters, response), "Offer with parameters is accepted.");
+		check(response == "permessage-deflate; client_no_context_takeover; server_max_window_bits=10", "Response echoes the accepted parameters.");
+		check(parameters.serverMaxWindowBits == 10 && parameters.clientNoContextTakeover && !parameters.serverNoContextTakeover, "Offer parameters are parsed.");
+		check(!BaseLib::PerMessageDeflate::negotiate("permessage-deflate; server_max_window_bits=8", parameters, response), "Window size of 8 bits is rejected.");
+		check(!BaseLib::PerMessageDeflate::negotiate("permessage-deflate; foo", parameters, response), "Unknown parameters are rejected.");
+		check(!BaseLib::PerMessageDeflate::negotiate("permessage-deflate; client_no_context_takeover; client_no_context_takeover", parameters, response), "Duplicate parameters are rejected.");
+		check(BaseLib::PerMessageDeflate::negotiate("permessage-deflate; server_max_window_bits=8, permessage-deflate", parameters, response) && response == "permessage-deflate", "Fallback offer is accepted.");
+		check(BaseLib::PerMessageDeflate::parseResponse(response, parameters), "Response can be parsed by the client.");
+
+		//Example from RFC 7692 section 7.2.3.1
+		BaseLib::PerMessageDeflate::Parameters defaultParameters;
+		BaseLib::PerMessageDeflate server(true, defaultParameters);
+		BaseLib::PerMessageDeflate client(false, defaultParameters);
+		std::string hello("Hello");
+		std::vector<char> compressed;
+		client.compress(hello.data(), hello.size(), compressed);
+		std::vector<char> expected{ (char)0xF2, 0x48, (char)0xCD, (char)0xC9, (char)0xC9, 0x07, 0x00 };
+		check(compressed == expected, "\"Hello\" is compressed like in RFC 7692.");
+		std::vector<char> decompressed;
+		server.decompress(compressed.data(), compressed.size(), decompressed, 1024);
+		check(std::string(decompressed.begin(), decompressed.end()) == hello, "\"Hello\" is decompressed.");
+
+		//Context takeover: the second identical message references the first one.
+		std::vector<char> secondCompressed;
+		client.compress(hello.data(), hello.size(), secondCompressed);
+		check(secondCompressed.size() < compressed.size(), "Repeated message is smaller with context takeover.");
+		decompressed.clear();
+		server.decompress(secondCompressed.data(), secondCompressed.size(), decompressed, 1024);
+		check(std::string(decompressed.begin(), decompressed.end()) == hello, "Repeated message is decompressed.");
+
+		//Frames through the parser
+		auto serverDeflate = std::make_shared<BaseLib::PerMessageDeflate>(true, defaultParameters);
+		BaseLib::PerMessageDeflate clientDeflate(false, defaultParameters);
+		BaseLib::WebSocket webSocket;
+		webSocket.setPerMessageDeflate(serverDeflate);
+		for(size_t size : { (size_t)0, (size_t)100, (size_t)100000 })
+		{
+			std::vector<char> payload = createPayload(size);
+			std::vector<char> frame;
+			BaseLib::WebSocket::encode(payload, BaseLib::WebSocket::Header::Opcode::binary, frame, clientDeflate);
+			check(frame.at(0) & 0x40, "RSV1 is set on compressed frames (size " + std::to_string(size) + ").");
+			webSocket.process(frame.data(), frame.size());
+			check(webSocket.isFinished() && webSocket.getContent() == payload, "Compressed frame is decoded (size " + std::to_string(size) + ").");
+		}
+
+		std::vector<char> bomb(20 * 1048576, 0);
+		compressed.clear();
+		BaseLib::PerMessageDeflate bombDeflate(false, defaultParameters);
+		bombDeflate.compress(bomb.data(), bomb.size(), compressed);
+		BaseLib::PerMessageDeflate bombInflate(true, defaultParameters);
+		bool exceptionThrown = false;
+		try
+		{
+			decompressed.clear();
+			bombInflate.decompress(compressed.data(), compressed.size(), decompressed, 10485760);
+		}
+		catch(BaseLib::WebSocketException& ex)
+		{
+			exceptionThrown = true;
+		}
+		check(exceptionThrown, "Decompressed size is limited.");
+
+		BaseLib::WebSocket plainWebSocket;
+		std::vector<char> frame;
+		std::vector<char> payload = createPayload(100);
+		BaseLib::WebSocket::encode(payload, BaseLib::WebSocket::Header::Opcode::text, frame, clientDeflate);
+		plainWebSocket.process(frame.data(), frame.size());
+		check(plainWebSocket.getHeader().close, "RSV1 without negotiated extension closes the connection.");
+	}
+
+	/**
+	 * Prints the throughput of unmasking and encoding. Always passes, the numbers are for comparison only.
+	 */
+	void benchmark()
+	{
+		const char maskingKey[4] = { 0x12, (char)0x9A, 0x3C, (char)0xF0 };
+		for(size_t size : { (size_t)1024, (size_t)65536, (size_t)1048576 })
+		{
+			std::vector<char> payload = createPayload(size);
+			size_t iterations = (256 * 1048576) / size;
+
+			auto start = std::chrono::steady_clock::now();
+			for(size_t i = 0; i < iterations; i++)
+			{
+				applyMaskBytewise(payload, maskingKey);
+			}
+			double bytewiseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			start = std::chrono::steady_clock::now();
+			for(size_t i = 0; i < iterations; i++)
+			{
+				BaseLib::WebSocket::applyMask(payload.data(), payload.size(), maskingKey);
+			}
+			double maskSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			std::vector<char> output;
+			start = std::chrono::steady_clock::now();
+			for(size_t i = 0; i < iterations; i++)
+			{
+				BaseLib::WebSocket::encode(payload, BaseLib::WebSocket::Header::Opcode::binary, output);
+			}
+			double encodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			std::vector<char> buffer(BaseLib::WebSocket::maxHeaderSize + size);
+			start = std::chrono::steady_clock::now();
+			for(size_t i = 0; i < iterations; i++)
+			{
+				BaseLib::WebSocket::encodeInPlace(buffer, BaseLib::WebSocket::Header::Opcode::binary);
+			}
+			double encodeInPlaceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			double megabytes = (double)(iterations * size) / 1048576;
+			std::cout << "Frame size " << size << ": unmask byte wise " << (int64_t)(megabytes / bytewiseSeconds) << " MiB/s, applyMask " << (int64_t)(megabytes / maskSeconds) << " MiB/s, encode " << (int64_t)(megabytes / encodeSeconds) << " MiB/s, encodeInPlace " << (int64_t)(megabytes / encodeInPlaceSeconds) << " MiB/s" << std::endl;
+		}
+	}
+}
+
+int main()
+{
+	testMask();
+	testDecode();
+	testEncode();
+	testPerMessageDeflate();
+	benchmark();
+
+	return finishTests();
+}